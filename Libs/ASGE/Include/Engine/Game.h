@@ -1,7 +1,7 @@
 #pragma once
 #include <memory>
 
-#include "Gametime.h"
+#include "GameTime.h"
 #include "Input.h"
 #include "Renderer.h"
 
@@ -0,0 +1,395 @@
+#include "AABBTree.h"
+
+namespace
+{
+	rect combine(const rect& a, const rect& b)
+	{
+		float min_x = a.x < b.x ? a.x : b.x;
+		float min_y = a.y < b.y ? a.y : b.y;
+		float max_x = a.x + a.length > b.x + b.length ? a.x + a.length : b.x + b.length;
+		float max_y = a.y + a.height > b.y + b.height ? a.y + a.height : b.y + b.height;
+
+		rect combined;
+		combined.x = min_x;
+		combined.y = min_y;
+		combined.length = max_x - min_x;
+		combined.height = max_y - min_y;
+		return combined;
+	}
+
+	float perimeter(const rect& r)
+	{
+		return 2.0f * (r.length + r.height);
+	}
+}
+
+/**
+*   @brief   Constructor.
+*   @details Allocates the node pool and links it into the free list.
+*   @return  void
+*/
+AABBTree::AABBTree(int capacity)
+{
+	nodes.reserve(capacity > 0 ? capacity : 1);
+	stack.reserve(64);
+}
+
+/**
+*   @brief   Registers a body with the tree.
+*   @details Creates a leaf holding the bounds and inserts it.
+*   @return  The id of the new proxy.
+*/
+int AABBTree::insert(const rect& bounds)
+{
+	int leaf = allocateNode();
+	Node& node = nodes[leaf];
+	node.bounds = bounds;
+	node.height = 0;
+
+	insertLeaf(leaf);
+	return leaf;
+}
+
+void AABBTree::remove(int proxy)
+{
+	removeLeaf(proxy);
+	freeNode(proxy);
+}
+
+void AABBTree::clear()
+{
+	nodes.clear();
+	root = NULL_NODE;
+	free_list = NULL_NODE;
+}
+
+/**
+*   @brief   Finds the bodies overlapping an area.
+*   @details Walks the tree using an explicit stack, skipping any
+             branch whose bounds do not overlap the area.
+*   @return  void
+*/
+void AABBTree::query(const rect& area, std::vector<int>& results) const
+{
+	if (root == NULL_NODE)
+	{
+		return;
+	}
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty())
+	{
+		int id = stack.back();
+		stack.pop_back();
+
+		const Node& node = nodes[id];
+		if (!node.bounds.isInside(area))
+		{
+			continue;
+		}
+
+		if (node.isLeaf())
+		{
+			results.push_back(id);
+		}
+		else
+		{
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+	}
+}
+
+/**
+*   @brief   Takes a node from the pool.
+*   @details The pool only grows when the free list is empty, in which
+             case the capacity is doubled.
+*   @return  The id of the node.
+*/
+int AABBTree::allocateNode()
+{
+	if (free_list == NULL_NODE)
+	{
+		if (nodes.size() == nodes.capacity())
+		{
+			nodes.reserve(nodes.capacity() * 2);
+		}
+
+		nodes.emplace_back();
+		free_list = static_cast<int>(nodes.size()) - 1;
+		nodes[free_list].parent = NULL_NODE;
+	}
+
+	int id = free_list;
+	free_list = nodes[id].parent;
+
+	nodes[id] = Node();
+	return id;
+}
+
+void AABBTree::freeNode(int id)
+{
+	nodes[id] = Node();
+	nodes[id].parent = free_list;
+	free_list = id;
+}
+
+/**
+*   @brief   Inserts a leaf into the tree.
+*   @details Descends from the root choosing the child that would give
+             the smallest increase in total perimeter, then pairs the
+			 leaf with the sibling found under a new parent. The
+			 ancestors are refit and rebalanced on the way back up.
+*   @return  void
+*/
+void AABBTree::insertLeaf(int leaf)
+{
+	if (root == NULL_NODE)
+	{
+		root = leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	rect leaf_bounds = nodes[leaf].bounds;
+	int index = root;
+	while (!nodes[index].isLeaf())
+	{
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+
+		float area = perimeter(nodes[index].bounds);
+		float combined_area = perimeter(combine(nodes[index].bounds, leaf_bounds));
+
+		// cost of creating a new parent for this node and the leaf
+		float cost = 2.0f * combined_area;
+
+		// minimum cost of pushing the leaf further down the tree
+		float inheritance_cost = 2.0f * (combined_area - area);
+
+		float cost1 = perimeter(combine(leaf_bounds, nodes[child1].bounds)) + inheritance_cost;
+		if (!nodes[child1].isLeaf())
+		{
+			cost1 -= perimeter(nodes[child1].bounds);
+		}
+
+		float cost2 = perimeter(combine(leaf_bounds, nodes[child2].bounds)) + inheritance_cost;
+		if (!nodes[child2].isLeaf())
+		{
+			cost2 -= perimeter(nodes[child2].bounds);
+		}
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	int sibling = index;
+	int old_parent = nodes[sibling].parent;
+	int new_parent = allocateNode();
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].bounds = combine(leaf_bounds, nodes[sibling].bounds);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].child1 = sibling;
+	nodes[new_parent].child2 = leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[leaf].parent = new_parent;
+
+	if (old_parent != NULL_NODE)
+	{
+		if (nodes[old_parent].child1 == sibling)
+		{
+			nodes[old_parent].child1 = new_parent;
+		}
+		else
+		{
+			nodes[old_parent].child2 = new_parent;
+		}
+	}
+	else
+	{
+		root = new_parent;
+	}
+
+	refit(nodes[leaf].parent);
+}
+
+/**
+*   @brief   Detaches a leaf from the tree.
+*   @details The leaf's parent is freed and its sibling takes its
+             place, after which the ancestors are refit.
+*   @return  void
+*/
+void AABBTree::removeLeaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = NULL_NODE;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grand_parent = nodes[parent].parent;
+	int sibling = nodes[parent].child1 == leaf ?
+		nodes[parent].child2 : nodes[parent].child1;
+
+	if (grand_parent != NULL_NODE)
+	{
+		if (nodes[grand_parent].child1 == parent)
+		{
+			nodes[grand_parent].child1 = sibling;
+		}
+		else
+		{
+			nodes[grand_parent].child2 = sibling;
+		}
+
+		nodes[sibling].parent = grand_parent;
+		freeNode(parent);
+		refit(grand_parent);
+	}
+	else
+	{
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		freeNode(parent);
+	}
+
+	nodes[leaf].parent = NULL_NODE;
+}
+
+/**
+*   @brief   Refits a node and all its ancestors.
+*   @details Each node is rebalanced before its bounds and height are
+             recalculated from its children.
+*   @return  void
+*/
+void AABBTree::refit(int index)
+{
+	while (index != NULL_NODE)
+	{
+		index = balance(index);
+
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+		int height1 = nodes[child1].height;
+		int height2 = nodes[child2].height;
+
+		nodes[index].height = 1 + (height1 > height2 ? height1 : height2);
+		nodes[index].bounds = combine(nodes[child1].bounds, nodes[child2].bounds);
+
+		index = nodes[index].parent;
+	}
+}
+
+/**
+*   @brief   Performs a left or right rotation if a node is imbalanced.
+*   @details If one child is more than a level taller than the other,
+             the taller child is promoted and one of its own children
+			 is handed down to take its place.
+*   @return  The id of the node now at the top of this subtree.
+*/
+int AABBTree::balance(int a)
+{
+	if (nodes[a].isLeaf() || nodes[a].height < 2)
+	{
+		return a;
+	}
+
+	int b = nodes[a].child1;
+	int c = nodes[a].child2;
+	int difference = nodes[c].height - nodes[b].height;
+
+	if (difference > 1)
+	{
+		// rotate c up
+		int f = nodes[c].child1;
+		int g = nodes[c].child2;
+
+		nodes[c].child1 = a;
+		nodes[c].parent = nodes[a].parent;
+		nodes[a].parent = c;
+
+		if (nodes[c].parent != NULL_NODE)
+		{
+			if (nodes[nodes[c].parent].child1 == a)
+			{
+				nodes[nodes[c].parent].child1 = c;
+			}
+			else
+			{
+				nodes[nodes[c].parent].child2 = c;
+			}
+		}
+		else
+		{
+			root = c;
+		}
+
+		// keep the taller of c's children at the top
+		int keep = nodes[f].height > nodes[g].height ? f : g;
+		int hand_down = keep == f ? g : f;
+
+		nodes[c].child2 = keep;
+		nodes[a].child2 = hand_down;
+		nodes[hand_down].parent = a;
+
+		nodes[a].bounds = combine(nodes[b].bounds, nodes[hand_down].bounds);
+		nodes[c].bounds = combine(nodes[a].bounds, nodes[keep].bounds);
+
+		int height_a = nodes[b].height > nodes[hand_down].height ? nodes[b].height : nodes[hand_down].height;
+		nodes[a].height = 1 + height_a;
+		nodes[c].height = 1 + (nodes[a].height > nodes[keep].height ? nodes[a].height : nodes[keep].height);
+
+		return c;
+	}
+
+	if (difference < -1)
+	{
+		// rotate b up
+		int d = nodes[b].child1;
+		int e = nodes[b].child2;
+
+		nodes[b].child1 = a;
+		nodes[b].parent = nodes[a].parent;
+		nodes[a].parent = b;
+
+		if (nodes[b].parent != NULL_NODE)
+		{
+			if (nodes[nodes[b].parent].child1 == a)
+			{
+				nodes[nodes[b].parent].child1 = b;
+			}
+			else
+			{
+				nodes[nodes[b].parent].child2 = b;
+			}
+		}
+		else
+		{
+			root = b;
+		}
+
+		int keep = nodes[d].height > nodes[e].height ? d : e;
+		int hand_down = keep == d ? e : d;
+
+		nodes[b].child2 = keep;
+		nodes[a].child1 = hand_down;
+		nodes[hand_down].parent = a;
+
+		nodes[a].bounds = combine(nodes[c].bounds, nodes[hand_down].bounds);
+		nodes[b].bounds = combine(nodes[a].bounds, nodes[keep].bounds);
+
+		int height_a = nodes[c].height > nodes[hand_down].height ? nodes[c].height : nodes[hand_down].height;
+		nodes[a].height = 1 + height_a;
+		nodes[b].height = 1 + (nodes[a].height > nodes[keep].height ? nodes[a].height : nodes[keep].height);
+
+		return b;
+	}
+
+	return a;
+}
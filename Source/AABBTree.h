@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+
+#include "Rect.h"
+
+/**
+*  A bounding volume hierarchy used as the broadphase for static bodies.
+*  Every body is stored as a leaf holding its bounds. Leaves are
+*  inserted next to the sibling that grows the tree's total perimeter
+*  the least, and the tree is rebalanced using rotations on the way
+*  back up. This keeps queries logarithmic even for levels mixing huge
+*  slabs of ground with tiny pieces of debris, which do not suit a
+*  uniform grid. Bodies that move live in a SpatialHash instead, so
+*  leaves are only ever added and removed, and their bounds are exact
+*  rather than grown to save refitting them as they move.
+*  Nodes live in a single pooled array and are recycled through a free
+*  list, so inserting doesn't allocate unless the pool has been
+*  exhausted.
+*  @see SpatialHash
+*/
+class AABBTree
+{
+public:
+
+	/**
+	*  Constructor.
+	*  @param [in] capacity The number of nodes to allocate up front
+	*/
+	explicit AABBTree(int capacity = 64);
+
+	/**
+	*  Registers a body with the tree.
+	*  @param [in] bounds The area the body covers
+	*  @return the proxy id used to remove the body
+	*/
+	int  insert(const rect& bounds);
+
+	/**
+	*  Removes a body from the tree.
+	*  @param [in] proxy The proxy id returned when inserting
+	*/
+	void remove(int proxy);
+
+	/**
+	*  Removes every body from the tree.
+	*  The node pool keeps its memory for reuse.
+	*/
+	void clear();
+
+	/**
+	*  Finds the bodies whose bounds overlap an area.
+	*  @param [in] area The area to test
+	*  @param [out] results The overlapping proxy ids are appended here
+	*/
+	void query(const rect& area, std::vector<int>& results) const;
+
+private:
+	static const int NULL_NODE = -1;
+
+	struct Node
+	{
+		rect bounds;
+		int  parent = NULL_NODE;   /**< Also links the free list. */
+		int  child1 = NULL_NODE;
+		int  child2 = NULL_NODE;
+		int  height = -1;          /**< 0 for leaves, -1 when free. */
+
+		bool isLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	int  allocateNode();
+	void freeNode(int node);
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	int  balance(int node);
+	void refit(int node);
+
+	std::vector<Node> nodes;
+	mutable std::vector<int> stack;
+	int   root = NULL_NODE;
+	int   free_list = NULL_NODE;
+};
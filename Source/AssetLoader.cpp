@@ -0,0 +1,242 @@
+#include "AssetLoader.h"
+#include "DecodedTextureCache.h"
+#include "FileSystem.h"
+
+AssetLoader::AssetLoader(const FileSystem& files, DecodedTextureCache& decoded, int workers) :
+	files(files), decoded(decoded)
+{
+	for (int i = 0; i < workers; i++)
+	{
+		threads.emplace_back(&AssetLoader::workerLoop, this);
+	}
+}
+
+AssetLoader::~AssetLoader()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	work_ready.notify_all();
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+handle AssetLoader::request(const std::string& path, finaliser finalise)
+{
+	handle asset;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		asset = requests.acquire();
+		asset_request& pending = *requests.get(asset);
+		pending.path = path;
+		pending.resolved.clear();
+		pending.finalise = std::move(finalise);
+		pending.state = AssetState::QUEUED;
+		pending.released = false;
+		queued.push_back(asset);
+		unfinished++;
+	}
+
+	work_ready.notify_one();
+	return asset;
+}
+
+AssetState AssetLoader::state(handle asset) const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	const asset_request* found = requests.get(asset);
+	return found && !found->released ? found->state : AssetState::NONE;
+}
+
+bool AssetLoader::ready(handle asset) const
+{
+	return state(asset) == AssetState::READY;
+}
+
+/**
+*   @brief   Runs the finalisers of decoded requests.
+*   @details The lock is dropped while a finaliser runs, so it may
+             queue or release requests, and workers carry on decoding
+			 meanwhile. Requests released before their turn are
+			 dropped without being finalised.
+*   @return  The number of finalisers run.
+*/
+int AssetLoader::finalise(int limit)
+{
+	int finalised = 0;
+	while (limit <= 0 || finalised < limit)
+	{
+		handle asset;
+		finaliser finalise;
+		std::string resolved;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if (decoded_queue.empty())
+			{
+				break;
+			}
+
+			asset = decoded_queue.front();
+			decoded_queue.pop_front();
+			asset_request* found = requests.get(asset);
+			if (!found)
+			{
+				continue;
+			}
+			if (found->released)
+			{
+				retire(asset);
+				continue;
+			}
+
+			finalise = std::move(found->finalise);
+			resolved = found->resolved;
+		}
+
+		bool used = finalise ? finalise(resolved) : true;
+		finalised++;
+
+		std::lock_guard<std::mutex> guard(lock);
+		asset_request* found = requests.get(asset);
+		if (found)
+		{
+			found->state = used ? AssetState::READY : AssetState::FAILED;
+			unfinished--;
+			if (found->released)
+			{
+				retire(asset);
+			}
+		}
+	}
+
+	return finalised;
+}
+
+bool AssetLoader::finish(handle asset)
+{
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		work_decoded.wait(guard, [this, asset]
+		{
+			const asset_request* found = requests.get(asset);
+			return !found || (found->state != AssetState::QUEUED && found->state != AssetState::LOADING);
+		});
+	}
+
+	while (state(asset) == AssetState::DECODED && finalise(1) > 0)
+	{
+	}
+	return ready(asset);
+}
+
+void AssetLoader::settle()
+{
+	std::unique_lock<std::mutex> guard(lock);
+	work_decoded.wait(guard, [this] { return queued.empty() && loading == 0; });
+}
+
+/**
+*   @brief   Forgets a request.
+*   @details A request a worker or the finaliser queue still holds is
+             only marked, and is retired by whichever reaches it next.
+*   @return  void
+*/
+void AssetLoader::release(handle asset)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	asset_request* found = requests.get(asset);
+	if (!found || found->released)
+	{
+		return;
+	}
+
+	if (found->state == AssetState::READY || found->state == AssetState::FAILED)
+	{
+		retire(asset);
+		return;
+	}
+
+	found->released = true;
+}
+
+int AssetLoader::pending() const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return unfinished;
+}
+
+/**
+*   @brief   Frees a request's slot. Called with the lock held.
+*   @return  void
+*/
+void AssetLoader::retire(handle asset)
+{
+	asset_request* found = requests.get(asset);
+	if (found->state != AssetState::READY && found->state != AssetState::FAILED)
+	{
+		unfinished--;
+	}
+
+	found->finalise = finaliser();
+	found->state = AssetState::NONE;
+	requests.release(asset);
+}
+
+/**
+*   @brief   Decodes queued requests until the loader stops.
+*   @details Only the decoding happens without the lock, which is
+             where nearly all the time goes.
+*   @return  void
+*/
+void AssetLoader::workerLoop()
+{
+	std::unique_lock<std::mutex> guard(lock);
+	for (;;)
+	{
+		work_ready.wait(guard, [this] { return stopping || !queued.empty(); });
+		if (stopping)
+		{
+			return;
+		}
+
+		handle asset = queued.front();
+		queued.pop_front();
+		asset_request* found = requests.get(asset);
+		if (!found)
+		{
+			continue;
+		}
+		if (found->released)
+		{
+			retire(asset);
+			work_decoded.notify_all();
+			continue;
+		}
+
+		found->state = AssetState::LOADING;
+		const std::string path = found->path;
+		loading++;
+
+		guard.unlock();
+		std::string resolved = decoded.resolve(files, path);
+		guard.lock();
+
+		loading--;
+		found = requests.get(asset);
+		if (found->released)
+		{
+			retire(asset);
+		}
+		else
+		{
+			found->resolved = resolved;
+			found->state = AssetState::DECODED;
+			decoded_queue.push_back(asset);
+		}
+		work_decoded.notify_all();
+	}
+}
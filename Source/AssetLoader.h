@@ -0,0 +1,150 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Pool.h"
+
+class DecodedTextureCache;
+class FileSystem;
+
+/**
+*  Where an asset request has got to.
+*/
+enum class AssetState
+{
+	NONE,       /**< The handle is empty, stale or released. */
+	QUEUED,     /**< Waiting for a worker. */
+	LOADING,    /**< Being read and decoded by a worker. */
+	DECODED,    /**< Waiting to be finalised on the main thread. */
+	READY,      /**< Finalised and ready to draw. */
+	FAILED      /**< The finaliser couldn't use the texture. */
+};
+
+/**
+*  Streams textures in behind the game.
+*  Each request is read and decoded into the decoded texture cache on
+*  a worker thread, leaving the main thread only the quick job of
+*  loading the decoded copy into the engine, which has to happen on the
+*  thread that owns the renderer. That last step is a finaliser given
+*  with the request, run by finalise once a frame. Requests are tracked
+*  by handle, so the game can check whether what it needs is ready
+*  rather than waiting for it.
+*/
+class AssetLoader
+{
+public:
+
+	/**
+	*  Called on the main thread with the path of the decoded copy, or
+	*  the texture's own path if it couldn't be cached.
+	*  Returns whether the texture could be used.
+	*/
+	using finaliser = std::function<bool(const std::string& path)>;
+
+	/**
+	*  Constructor. Starts the workers.
+	*  @param [in] files Where textures are read from
+	*  @param [in] decoded Where decoded copies are kept
+	*  @param [in] workers The number of worker threads
+	*/
+	AssetLoader(const FileSystem& files, DecodedTextureCache& decoded, int workers = 2);
+
+	/**
+	*  Destructor. Stops the workers once they finish what they're on.
+	*  Requests still queued are dropped.
+	*/
+	~AssetLoader();
+
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	/**
+	*  Queues a texture to be decoded and then finalised.
+	*  @param [in] path The texture's path, as it would be opened from disk
+	*  @param [in] finalise Run on the main thread once decoded
+	*  @return a handle to follow the request with
+	*/
+	handle request(const std::string& path, finaliser finalise);
+
+	/**
+	*  Returns how far a request has got.
+	*  @param [in] asset The handle returned by request
+	*  @return the request's state, NONE for stale handles
+	*/
+	AssetState state(handle asset) const;
+
+	/**
+	*  Checks whether a request was finalised successfully.
+	*  @param [in] asset The handle returned by request
+	*  @return true if the request is READY
+	*/
+	bool ready(handle asset) const;
+
+	/**
+	*  Runs the finalisers of decoded requests, oldest first.
+	*  Call from the main thread.
+	*  @param [in] limit The most finalisers to run, zero for all of them
+	*  @return the number run
+	*/
+	int  finalise(int limit = 0);
+
+	/**
+	*  Waits for a request to be decoded and finalises it, for the few
+	*  assets there's nothing to show without. Call from the main thread.
+	*  Requests decoded ahead of it are finalised first.
+	*  @param [in] asset The handle returned by request
+	*  @return true if the request is READY
+	*/
+	bool finish(handle asset);
+
+	/**
+	*  Waits until no request is queued or being decoded, so whatever
+	*  has been asked for can be finalised at once. Frames then stream
+	*  in the same way however fast the workers are, which repeatable
+	*  runs need. Call from the main thread.
+	*/
+	void settle();
+
+	/**
+	*  Forgets a request. One not yet finalised never will be.
+	*  @param [in] asset The handle returned by request
+	*/
+	void release(handle asset);
+
+	/**
+	*  Returns the number of requests not yet finalised.
+	*  @return the queued, loading and decoded request count
+	*/
+	int  pending() const;
+
+private:
+	struct asset_request
+	{
+		std::string path;
+		std::string resolved;
+		finaliser finalise;
+		AssetState state = AssetState::NONE;
+		bool released = false;
+	};
+
+	void retire(handle asset);
+	void workerLoop();
+
+	const FileSystem& files;
+	DecodedTextureCache& decoded;
+
+	mutable std::mutex lock;
+	std::condition_variable work_ready;
+	std::condition_variable work_decoded;
+	Pool<asset_request, 16> requests;
+	std::deque<handle> queued;
+	std::deque<handle> decoded_queue;
+	int unfinished = 0;
+	int loading = 0;   // requests a worker has taken
+	bool stopping = false;
+	std::vector<std::thread> threads;
+};
@@ -0,0 +1,101 @@
+#include <float.h>
+#include "ColliderComponent.h"
+
+void ColliderComponent::makeCircle(float radius)
+{
+	shape_type = ColliderType::CIRCLE;
+	shape_radius = radius;
+	local_shape = polygon();
+	local_shape.count = 1;
+	refresh();
+}
+
+void ColliderComponent::makeBox(float half_width, float half_height)
+{
+	shape_type = ColliderType::BOX;
+	shape_radius = 0.0f;
+	local_shape = ::makeBox(vector2(0.0f, 0.0f), half_width, half_height, 0.0f);
+	refresh();
+}
+
+void ColliderComponent::makePolygon(const vector2* vertices, int count)
+{
+	shape_type = ColliderType::POLYGON;
+	shape_radius = 0.0f;
+	local_shape = ::makePolygon(vertices, count);
+	refresh();
+}
+
+/**
+*   @brief   Moves the collider to match a sprite.
+*   @details Sprites rotate around their centre, so the shape is placed
+             there. Nothing is recalculated if the sprite hasn't moved.
+*   @return  void
+*/
+void ColliderComponent::update(const ASGE::Sprite& sprite)
+{
+	update(vector2(sprite.xPos() + sprite.width() * 0.5f,
+		sprite.yPos() + sprite.height() * 0.5f), sprite.rotationInRadians());
+}
+
+void ColliderComponent::update(const vector2& position, float rotation)
+{
+	if (position.x == centre.x && position.y == centre.y && rotation == angle)
+	{
+		return;
+	}
+
+	centre = position;
+	angle = rotation;
+	refresh();
+}
+
+ColliderType ColliderComponent::type() const
+{
+	return shape_type;
+}
+
+float ColliderComponent::radius() const
+{
+	return shape_radius;
+}
+
+const polygon& ColliderComponent::localShape() const
+{
+	return local_shape;
+}
+
+const polygon& ColliderComponent::worldShape() const
+{
+	return world_shape;
+}
+
+rect ColliderComponent::getBoundingBox() const
+{
+	return bounds;
+}
+
+/**
+*   @brief   Recalculates the world shape and bounds.
+*   @return  void
+*/
+void ColliderComponent::refresh()
+{
+	world_shape = transformPolygon(local_shape, centre, angle);
+
+	float min_x = FLT_MAX, min_y = FLT_MAX;
+	float max_x = -FLT_MAX, max_y = -FLT_MAX;
+	for (int i = 0; i < world_shape.count; i++)
+	{
+		const vector2& v = world_shape.vertices[i];
+		min_x = v.x < min_x ? v.x : min_x;
+		min_y = v.y < min_y ? v.y : min_y;
+		max_x = v.x > max_x ? v.x : max_x;
+		max_y = v.y > max_y ? v.y : max_y;
+	}
+
+	bounds.x = min_x - shape_radius;
+	bounds.y = min_y - shape_radius;
+	bounds.length = max_x - min_x + 2.0f * shape_radius;
+	bounds.height = max_y - min_y + 2.0f * shape_radius;
+}
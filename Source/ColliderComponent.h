@@ -0,0 +1,110 @@
+#pragma once
+#include <Engine/Sprite.h>
+#include "Narrowphase.h"
+#include "Rect.h"
+
+/**
+*  The shapes a collider may take.
+*/
+enum class ColliderType
+{
+	CIRCLE,  /**< A circle around the sprite's centre. */
+	BOX,     /**< A box that turns with the sprite. */
+	POLYGON  /**< Any convex polygon that turns with the sprite. */
+};
+
+/**
+*  Collider Components give GameObjects a shape.
+*  The shape is stored around the centre of the sprite and follows
+*  the sprite's position and rotation. The world space shape and its
+*  bounds are only recalculated when the sprite has actually moved,
+*  so testing the same collider against many others is cheap.
+*  @see GameObject
+*  @see SpriteComponent
+*/
+class ColliderComponent
+{
+public:
+
+	/**
+	*  Default constructor.
+	*/
+	ColliderComponent() = default;
+
+	/**
+	*  Makes the collider a circle.
+	*  @param [in] radius The radius of the circle
+	*/
+	void  makeCircle(float radius);
+
+	/**
+	*  Makes the collider a box.
+	*  @param [in] half_width Half of the box's width
+	*  @param [in] half_height Half of the box's height
+	*/
+	void  makeBox(float half_width, float half_height);
+
+	/**
+	*  Makes the collider a convex polygon.
+	*  @param [in] vertices The corners around the sprite's centre
+	*  @param [in] count The number of corners
+	*/
+	void  makePolygon(const vector2* vertices, int count);
+
+	/**
+	*  Moves the collider to match a sprite.
+	*  @param [in] sprite The sprite the collider is attached to
+	*/
+	void  update(const ASGE::Sprite& sprite);
+
+	/**
+	*  Moves the collider to a new centre and rotation.
+	*  @param [in] position The centre of the shape
+	*  @param [in] rotation The rotation in radians
+	*/
+	void  update(const vector2& position, float rotation);
+
+	/**
+	*  Returns the shape of the collider.
+	*  @return the collider type
+	*/
+	ColliderType type() const;
+
+	/**
+	*  Returns the radius of the collider.
+	*  @return the radius for circles, zero otherwise
+	*/
+	float radius() const;
+
+	/**
+	*  Returns the shape around the sprite's centre.
+	*  Circles are a single vertex at the centre.
+	*  @return the local shape
+	*/
+	const polygon& localShape() const;
+
+	/**
+	*  Returns the shape where the sprite was last updated.
+	*  @return the world shape
+	*/
+	const polygon& worldShape() const;
+
+	/**
+	*  Grabs a bounding box for the collider.
+	*  Tighter than the sprite's own box for rotated or round sprites.
+	*  @return a rectangle bounding the world shape
+	*/
+	rect  getBoundingBox() const;
+
+private:
+	void  refresh();
+
+	ColliderType shape_type = ColliderType::BOX;
+	polygon local_shape;
+	polygon world_shape;
+	float   shape_radius = 0.0f;
+	rect    bounds;
+
+	vector2 centre;
+	float   angle = 0.0f;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include "Pool.h"
+#include "Vector2.h"
+
+/**
+*  The role an object plays in the game world.
+*  Used to decide how a collision with the object is resolved.
+*/
+enum class ObjectType
+{
+	SCENERY,    /**< Background, UI or other non-colliding objects. */
+	PROJECTILE, /**< Objects launched from the slingshot. */
+	ENEMY,      /**< Targets that need to be hit to win. */
+	BLOCK       /**< Level geometry that stops projectiles. */
+};
+
+/**
+*  Where an entity is drawn.
+*/
+struct transform
+{
+	vector2 position;              /**< Top left corner, as sprites are placed. */
+	vector2 size;                  /**< Width and height in pixels. */
+	float   rotation = 0.0f;       /**< Radians about the centre. */
+};
+
+/**
+*  How fast an entity is moving, copied from its body after each step.
+*/
+struct motion
+{
+	vector2 velocity;              /**< Pixels per second. */
+};
+
+/**
+*  The body moving an entity.
+*/
+struct rigid_body
+{
+	int body = -1;                 /**< Id in the physics world, or -1 if it has none. */
+};
+
+/**
+*  The sprite drawn for an entity, held in the game's sprite pool.
+*/
+struct sprite_ref
+{
+	handle sprite;
+	handle texture;                /**< The reference held in the texture cache. */
+};
+
+/**
+*  Whether an entity is drawn and takes part in the game.
+*/
+struct visibility
+{
+	bool visible = true;
+};
+
+/**
+*  The role an entity plays.
+*/
+struct object_kind
+{
+	ObjectType type = ObjectType::SCENERY;
+};
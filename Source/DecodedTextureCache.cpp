@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <string.h>
+#include <functional>
+#include <thread>
+
+#include "DecodedTextureCache.h"
+#include "FileSystem.h"
+#include "Jpeg.h"
+#include "Path.h"
+#include "Png.h"
+
+namespace
+{
+	// changing how copies are written must change their names too
+	const char CACHE_VERSION[] = "decoded-rgba-3";
+
+	uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	std::string hexName(uint64_t hash)
+	{
+		char name[17];
+		snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+		return name;
+	}
+
+	bool fileExists(const std::string& path)
+	{
+		FILE* file = fopen(path.c_str(), "rb");
+		if (!file)
+		{
+			return false;
+		}
+		fclose(file);
+		return true;
+	}
+
+	/**
+	*   @brief   Reads the name of the copy a stamp was last seen with.
+	*   @return  False if the stamp hasn't been seen.
+	*/
+	bool readKey(const std::string& path, std::string& name)
+	{
+		FILE* file = fopen(path.c_str(), "rb");
+		if (!file)
+		{
+			return false;
+		}
+
+		char read[17] = {};
+		const bool whole = fread(read, 1, 16, file) == 16;
+		fclose(file);
+		name.assign(read);
+		return whole && strspn(read, "0123456789abcdef") == 16;
+	}
+
+	/**
+	*   @brief   Writes a file under a name of its own, then renames it.
+	*   @details The file is either whole or missing even if the game
+	             stops halfway, or another thread writes the same one.
+	*   @return  True if the file exists.
+	*/
+	template<typename Write>
+	bool writeInPlace(const std::string& path, Write write)
+	{
+		const std::string temporary = path + "." +
+			std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+		if (!write(temporary))
+		{
+			remove(temporary.c_str());
+			return false;
+		}
+
+		if (rename(temporary.c_str(), path.c_str()) != 0)
+		{
+			// on Windows, renaming over a file another thread just wrote fails
+			remove(temporary.c_str());
+			return fileExists(path);
+		}
+		return true;
+	}
+
+	bool decode(const file_view& source, image& decoded)
+	{
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(source.data);
+		if (source.size >= 2 && data[0] == 0xff && data[1] == 0xd8)
+		{
+			return decodeJpeg(data, source.size, decoded);
+		}
+		return decodePng(data, source.size, decoded);
+	}
+}
+
+DecodedTextureCache::DecodedTextureCache(const std::string& folder) :
+	folder(folder)
+{
+}
+
+std::string DecodedTextureCache::resolve(const FileSystem& files, const std::string& path)
+{
+	const std::string key = normalisePath(path);
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto found = resolved.find(key);
+		if (found != resolved.end())
+		{
+			return found->second;
+		}
+	}
+
+	std::string cached;
+	if (!build(files, path, cached))
+	{
+		cached = path;
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+	resolved[key] = cached;
+	return cached;
+}
+
+/**
+*   @brief   Hashes a file's contents.
+*   @details FNV-1a over the cache's version and the contents, so
+             copies written another way get names of their own.
+*   @return  The 64 bit hash.
+*/
+uint64_t DecodedTextureCache::hashContents(const char* data, size_t size)
+{
+	const uint64_t hash = hashBytes(14695981039346656037ull, CACHE_VERSION, sizeof(CACHE_VERSION) - 1);
+	return hashBytes(hash, data, size);
+}
+
+/**
+*   @brief   Hashes a file's path and stamp.
+*   @details FNV-1a over the cache's version, the path and each
+             field of the stamp, so another version of the file, or
+			 the same file somewhere else, is hashed again before its
+			 copy is trusted.
+*   @return  The 64 bit hash.
+*/
+uint64_t DecodedTextureCache::hashStamp(const std::string& path, const file_stamp& stamp)
+{
+	uint64_t hash = hashBytes(14695981039346656037ull, CACHE_VERSION, sizeof(CACHE_VERSION) - 1);
+	hash = hashBytes(hash, path.data(), path.size());
+	hash = hashBytes(hash, &stamp.size, sizeof(stamp.size));
+	hash = hashBytes(hash, &stamp.modified, sizeof(stamp.modified));
+	return hashBytes(hash, &stamp.offset, sizeof(stamp.offset));
+}
+
+/**
+*   @brief   Finds or writes the decoded copy of a texture.
+*   @details Copies are named after a hash of the source's contents.
+             Hashing means reading every source though, so the name
+			 is also kept in a key file named after the source's path
+			 and stamp. While the stamp is unchanged the copy is found
+			 without reading the source. A source that's been touched,
+			 copied or checked out again is hashed once more, and only
+			 decoded if its contents really changed.
+*   @return  True if the copy exists.
+*/
+bool DecodedTextureCache::build(const FileSystem& files, const std::string& path, std::string& cached) const
+{
+	file_stamp stamp;
+	if (!files.stamp(path, stamp))
+	{
+		return false;
+	}
+
+	const std::string key = folder + "/" + hexName(hashStamp(normalisePath(path), stamp)) + ".key";
+	std::string name;
+	if (readKey(key, name))
+	{
+		cached = folder + "/" + name + ".png";
+		if (fileExists(cached))
+		{
+			return true;
+		}
+	}
+
+	file_buffer buffer;
+	file_view source;
+	if (!files.read(path, buffer, source) || !source.data)
+	{
+		return false;
+	}
+
+	name = hexName(hashContents(source.data, source.size));
+	cached = folder + "/" + name + ".png";
+	if (!fileExists(cached))
+	{
+		image decoded;
+		if (!decode(source, decoded))
+		{
+			return false;
+		}
+
+		auto save = [&decoded](const std::string& temporary)
+		{
+			return savePng(temporary, decoded, false);
+		};
+		makeFolder(folder);
+		if (!writeInPlace(cached, save))
+		{
+			return false;
+		}
+	}
+
+	writeInPlace(key, [&name](const std::string& temporary)
+	{
+		FILE* file = fopen(temporary.c_str(), "wb");
+		if (!file)
+		{
+			return false;
+		}
+		const bool written = fwrite(name.data(), 1, name.size(), file) == name.size();
+		return fclose(file) == 0 && written;
+	});
+	return true;
+}
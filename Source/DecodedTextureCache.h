@@ -0,0 +1,71 @@
+#pragma once
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+
+class FileSystem;
+struct file_stamp;
+
+/**
+*  Keeps decoded copies of textures on disk, so they aren't decoded
+*  again every time the game starts.
+*  The engine can only load textures from files, so each copy is an
+*  uncompressed, unfiltered PNG the engine reads at close to the speed
+*  of copying it. Copies are named after a hash of the source file's
+*  contents, so an edited texture gets a new copy and the old one is
+*  simply never read again. A small key file, named after the source's
+*  path, size and modification time, remembers which copy it last had,
+*  so an untouched source isn't read at all. As the sources are read
+*  through the file system, textures that only exist in a pack become
+*  files the engine can load too. Anything that can't be cached is
+*  loaded from its own path as before.
+*/
+class DecodedTextureCache
+{
+public:
+
+	/**
+	*  Constructor.
+	*  @param [in] folder The folder copies are kept in. It's created
+	*  when the first copy is written.
+	*/
+	explicit DecodedTextureCache(const std::string& folder = "Cache");
+
+	DecodedTextureCache(const DecodedTextureCache&) = delete;
+	DecodedTextureCache& operator=(const DecodedTextureCache&) = delete;
+
+	/**
+	*  Returns the path the engine should load a texture from, decoding
+	*  and writing the copy if there isn't one yet. Safe to call from
+	*  several threads at once.
+	*  @param [in] files Where the source is read from
+	*  @param [in] path The texture's path, as it would be opened from disk
+	*  @return the path of the decoded copy, or the given path if the
+	*  texture couldn't be cached
+	*/
+	std::string resolve(const FileSystem& files, const std::string& path);
+
+	/**
+	*  Hashes a file's contents to name its decoded copy.
+	*  @param [in] data The contents
+	*  @param [in] size The size of the contents in bytes
+	*  @return the 64 bit hash
+	*/
+	static uint64_t hashContents(const char* data, size_t size);
+
+	/**
+	*  Hashes a file's path and stamp to name the key to its copy.
+	*  @param [in] path The file's normalised path
+	*  @param [in] stamp The file's size and modification time
+	*  @return the 64 bit hash
+	*/
+	static uint64_t hashStamp(const std::string& path, const file_stamp& stamp);
+
+private:
+	bool build(const FileSystem& files, const std::string& path, std::string& cached) const;
+
+	std::string folder;
+	std::mutex lock;
+	std::map<std::string, std::string> resolved;   /**< Normalised source path to the path to load. */
+};
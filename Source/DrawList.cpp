@@ -0,0 +1,159 @@
+#include <string.h>
+#include <Engine/Renderer.h>
+#include <Engine/Sprite.h>
+
+#include "DrawList.h"
+
+namespace
+{
+	const int LAYER_SHIFT = 56;
+	const int TEXTURE_SHIFT = 32;
+	const uint32_t TEXTURE_NUMBERS = 1u << (LAYER_SHIFT - TEXTURE_SHIFT);
+
+	/**
+	*   @brief   Turns a depth into bits that sort as the depth does.
+	*   @details Positive floats already sort as unsigned integers once
+	             the sign is set. Negative ones sort backwards, so all
+				 their bits are flipped.
+	*   @return  The sortable bits.
+	*/
+	uint32_t depthBits(float depth)
+	{
+		uint32_t bits = 0;
+		memcpy(&bits, &depth, sizeof(bits));
+		return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+	}
+}
+
+SpriteCopy::SpriteCopy(const ASGE::Sprite& sprite) :
+	ASGE::Sprite(sprite),
+	texture(sprite.getTexture())
+{
+}
+
+bool SpriteCopy::loadTexture(const std::string&)
+{
+	return false;
+}
+
+const ASGE::Texture2D* SpriteCopy::getTexture() const
+{
+	return texture;
+}
+
+void DrawList::clear()
+{
+	commands.clear();
+	instances.clear();
+}
+
+void DrawList::add(const ASGE::Sprite& sprite, DrawLayer layer, float depth)
+{
+	const uint64_t key =
+		static_cast<uint64_t>(layer) << LAYER_SHIFT |
+		static_cast<uint64_t>(textureNumber(sprite.getTexture())) << TEXTURE_SHIFT |
+		depthBits(depth);
+	commands.push_back({ key, static_cast<uint32_t>(instances.size()) });
+	instances.emplace_back(sprite);
+}
+
+/**
+*   @brief   Draws the list.
+*   @details Once sorted, the sprites reach the renderer already
+             grouped by texture, so it can batch them in the order
+			 given rather than sorting them again.
+*   @return  void
+*/
+void DrawList::submit(ASGE::Renderer& renderer) const
+{
+	for (const draw_command& command : commands)
+	{
+		renderer.renderSprite(instances[command.instance]);
+	}
+}
+
+size_t DrawList::size() const
+{
+	return commands.size();
+}
+
+/**
+*   @brief   Finds the number a texture sorts by.
+*   @details Numbers are handed out as textures are first seen. In the
+             unlikely event they run out, they're handed out afresh,
+			 which only changes the order textures are drawn in.
+*   @return  The texture's number, 0 for no texture.
+*/
+uint32_t DrawList::textureNumber(const ASGE::Texture2D* texture)
+{
+	if (!texture)
+	{
+		return 0;
+	}
+
+	auto found = texture_numbers.find(texture);
+	if (found != texture_numbers.end())
+	{
+		return found->second;
+	}
+
+	if (texture_numbers.size() + 1 >= TEXTURE_NUMBERS)
+	{
+		texture_numbers.clear();
+	}
+	const uint32_t number = static_cast<uint32_t>(texture_numbers.size()) + 1;
+	texture_numbers.emplace(texture, number);
+	return number;
+}
+
+/**
+*   @brief   Sorts the commands by key.
+*   @details A least significant digit radix sort, a byte at a time,
+             which keeps equal keys in the order they were added. The
+			 counts for every byte are taken in one pass, and a byte
+			 every key shares is skipped, which most are: there are
+			 few layers and textures, and sprites mostly share a depth.
+*   @return  void
+*/
+void DrawList::sort()
+{
+	const size_t count = commands.size();
+	if (count < 2)
+	{
+		return;
+	}
+
+	size_t counts[8][256] = {};
+	for (const draw_command& command : commands)
+	{
+		for (int digit = 0; digit < 8; digit++)
+		{
+			counts[digit][command.key >> (digit * 8) & 0xff]++;
+		}
+	}
+
+	sorted.resize(count);
+	for (int digit = 0; digit < 8; digit++)
+	{
+		const int shift = digit * 8;
+		size_t* offsets = counts[digit];
+		if (offsets[commands[0].key >> shift & 0xff] == count)
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (int value = 0; value < 256; value++)
+		{
+			const size_t values = offsets[value];
+			offsets[value] = offset;
+			offset += values;
+		}
+
+		for (const draw_command& command : commands)
+		{
+			sorted[offsets[command.key >> shift & 0xff]++] = command;
+		}
+		commands.swap(sorted);
+	}
+}
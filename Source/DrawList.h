@@ -0,0 +1,112 @@
+#pragma once
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+#include <Engine/Sprite.h>
+
+namespace ASGE
+{
+	class Renderer;
+	class Texture2D;
+}
+
+/**
+*  The layers sprites are drawn in, back to front.
+*/
+enum class DrawLayer : uint8_t
+{
+	BACKGROUND,   /**< The scenery behind everything. */
+	WORLD,        /**< Rocks, blocks and enemies. */
+	FOREGROUND,   /**< In front of the world, such as the slingshot. */
+	OVERLAY       /**< Menus and end of level screens. */
+};
+
+/**
+*  A sprite as it was when copied, drawing the same texture.
+*  Can be drawn while the sprite it was copied from moves on, or is
+*  gone, as textures stay loaded as long as the renderer.
+*/
+class SpriteCopy :
+	public ASGE::Sprite
+{
+public:
+
+	/**
+	*  Constructor.
+	*  @param [in] sprite The sprite to copy
+	*/
+	explicit SpriteCopy(const ASGE::Sprite& sprite);
+
+	/**
+	*  Copies can't load textures of their own.
+	*  @return false
+	*/
+	virtual bool loadTexture(const std::string&) override;
+	virtual const ASGE::Texture2D* getTexture() const override;
+
+private:
+	const ASGE::Texture2D* texture = nullptr;
+};
+
+/**
+*  A frame's sprites, put in order before any is drawn.
+*  Each sprite is recorded with a 64 bit key made of its layer, its
+*  texture and its depth, most significant first. Sorting the keys
+*  draws the layers in order and, within a layer, every sprite sharing
+*  a texture together, so the renderer binds each texture once a layer
+*  whatever order the game found its sprites in. Depth only orders
+*  sprites within a texture, so sprites that must cover others go on a
+*  higher layer. Sprites with the same key are drawn in the order they
+*  were added. Sprites are copied as they're added, so once sorted the
+*  list can be drawn on another thread while the game carries on.
+*/
+class DrawList
+{
+public:
+
+	/**
+	*  Empties the list for a new frame. Texture numbers are kept, so
+	*  textures sort the same way from frame to frame.
+	*/
+	void clear();
+
+	/**
+	*  Records a copy of a sprite to draw.
+	*  @param [in] sprite The sprite, drawn as it is now
+	*  @param [in] layer The layer to draw it in
+	*  @param [in] depth Orders sprites sharing a layer and texture,
+	*  lowest first
+	*/
+	void add(const ASGE::Sprite& sprite, DrawLayer layer, float depth = 0.0f);
+
+	/**
+	*  Puts the sprites in drawing order.
+	*/
+	void sort();
+
+	/**
+	*  Draws the sprites in one pass, in the order they're in.
+	*  @param [in] renderer The renderer to draw with
+	*/
+	void submit(ASGE::Renderer& renderer) const;
+
+	/**
+	*  Returns the number of sprites recorded this frame.
+	*  @return the sprite count
+	*/
+	size_t size() const;
+
+private:
+	struct draw_command
+	{
+		uint64_t key;
+		uint32_t instance;   // index of the sprite's copy
+	};
+
+	uint32_t textureNumber(const ASGE::Texture2D* texture);
+
+	std::vector<draw_command> commands;
+	std::vector<SpriteCopy> instances;
+	std::vector<draw_command> sorted;   // the radix sort's other buffer
+	std::unordered_map<const ASGE::Texture2D*, uint32_t> texture_numbers;
+};
@@ -0,0 +1,197 @@
+#include <assert.h>
+#include "EntityStore.h"
+
+namespace
+{
+	const int MAX_COMPONENTS = 32;
+}
+
+/**
+*   @brief   Constructor.
+*   @details Archetype zero has no components. Every entity starts in
+             it and it is never removed.
+*   @return  void
+*/
+EntityStore::EntityStore()
+{
+	findArchetype(0, -1);
+}
+
+/**
+*   @brief   Creates an entity with no components.
+*   @details Ids of destroyed entities are reused before new ones are
+             handed out, keeping the location table small.
+*   @return  The id of the entity.
+*/
+int EntityStore::create()
+{
+	int entity = 0;
+	if (!free_entities.empty())
+	{
+		entity = free_entities.back();
+		free_entities.pop_back();
+	}
+	else
+	{
+		entity = static_cast<int>(locations.size());
+		locations.push_back(entity_location());
+	}
+
+	archetype& empty = archetypes[0];
+	locations[entity].archetype = 0;
+	locations[entity].row = static_cast<int>(empty.entities.size());
+	empty.entities.push_back(entity);
+	entity_count++;
+	return entity;
+}
+
+void EntityStore::destroy(int entity)
+{
+	if (!alive(entity))
+	{
+		return;
+	}
+
+	removeRow(entity);
+	locations[entity] = entity_location();
+	free_entities.push_back(entity);
+	entity_count--;
+}
+
+/**
+*   @brief   Destroys every entity.
+*   @details The columns are emptied rather than freed, so refilling
+             the store with the same kinds of entities doesn't allocate.
+*   @return  void
+*/
+void EntityStore::clear()
+{
+	for (archetype& type : archetypes)
+	{
+		type.entities.clear();
+		for (auto& column : type.columns)
+		{
+			if (column)
+			{
+				column->clear();
+			}
+		}
+	}
+
+	locations.clear();
+	free_entities.clear();
+	entity_count = 0;
+}
+
+bool EntityStore::alive(int entity) const
+{
+	return entity >= 0 && entity < static_cast<int>(locations.size()) &&
+		locations[entity].archetype >= 0;
+}
+
+int EntityStore::size() const
+{
+	return entity_count;
+}
+
+/**
+*   @brief   Gives a component type the next free column.
+*   @details An archetype's mask has a bit per component type, so there
+             can't be more types than it has bits. Two types sharing a
+			 column would read each other's data as their own.
+*   @return  The component type's id.
+*/
+int EntityStore::nextComponentId()
+{
+	static int next_id = 0;
+	assert(next_id < MAX_COMPONENTS && "Too many component types for the archetype mask");
+	return next_id++;
+}
+
+/**
+*   @brief   Finds the archetype for a set of components.
+*   @details A missing archetype is created with empty columns copied
+             from the source archetype's. A column for a component the
+			 source lacks is left for the caller to create, as only it
+			 knows the component's type.
+*   @return  The index of the archetype.
+*/
+int EntityStore::findArchetype(uint32_t mask, int source)
+{
+	auto found = archetype_lookup.find(mask);
+	if (found != archetype_lookup.end())
+	{
+		return found->second;
+	}
+
+	archetype type;
+	type.mask = mask;
+	type.columns.resize(MAX_COMPONENTS);
+
+	for (int id = 0; source >= 0 && id < MAX_COMPONENTS; id++)
+	{
+		const auto& column = archetypes[source].columns[id];
+		if ((mask & (1u << id)) && column)
+		{
+			type.columns[id] = column->makeEmpty();
+		}
+	}
+
+	int index = static_cast<int>(archetypes.size());
+	archetypes.push_back(std::move(type));
+	archetype_lookup[mask] = index;
+	return index;
+}
+
+/**
+*   @brief   Moves an entity's row to another archetype.
+*   @details Components both archetypes share are moved across, then
+             the old row is removed. A component only the target has
+			 must already have been pushed onto its column.
+*   @return  void
+*/
+void EntityStore::moveEntity(int entity, int target)
+{
+	const entity_location location = locations[entity];
+	archetype& from = archetypes[location.archetype];
+	archetype& to = archetypes[target];
+	const uint32_t shared = from.mask & to.mask;
+
+	for (int id = 0; id < MAX_COMPONENTS; id++)
+	{
+		if (shared & (1u << id))
+		{
+			from.columns[id]->moveRow(location.row, *to.columns[id]);
+		}
+	}
+
+	removeRow(entity);
+	locations[entity].archetype = target;
+	locations[entity].row = static_cast<int>(to.entities.size());
+	to.entities.push_back(entity);
+}
+
+/**
+*   @brief   Removes an entity's row from its archetype.
+*   @details The last row is swapped into the gap, so the entity it
+             belonged to has its location updated.
+*   @return  void
+*/
+void EntityStore::removeRow(int entity)
+{
+	const entity_location location = locations[entity];
+	archetype& type = archetypes[location.archetype];
+
+	for (auto& column : type.columns)
+	{
+		if (column)
+		{
+			column->removeRow(location.row);
+		}
+	}
+
+	int last = type.entities.back();
+	type.entities[location.row] = last;
+	type.entities.pop_back();
+	locations[last].row = location.row;
+}
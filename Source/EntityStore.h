@@ -0,0 +1,292 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+*  Stores entities as rows of tightly packed component columns.
+*  Entities with exactly the same set of components share an archetype,
+*  which keeps one vector per component type. A query visits only the
+*  archetypes holding every component asked for and walks their columns
+*  front to back, so systems touch memory in order instead of following
+*  a pointer per object. Adding or removing a component moves the
+*  entity's row to the matching archetype.
+*  Any type can be a component. At most 32 types may be used.
+*  Components must not be added or removed, nor entities created or
+*  destroyed, while a query is running.
+*/
+class EntityStore
+{
+public:
+
+	/**
+	*  Constructor. Creates the empty archetype new entities start in.
+	*/
+	EntityStore();
+
+	/**
+	*  Creates an entity with no components.
+	*  @return the id of the entity
+	*/
+	int  create();
+
+	/**
+	*  Destroys an entity and its components.
+	*  The id may be reused by the next entity created.
+	*  @param [in] entity The id of the entity
+	*/
+	void destroy(int entity);
+
+	/**
+	*  Destroys every entity. The archetypes are kept, along with the
+	*  memory their columns have grown to.
+	*/
+	void clear();
+
+	/**
+	*  Checks whether an entity exists.
+	*  @param [in] entity The id of the entity
+	*  @return true if the entity has been created and not destroyed
+	*/
+	bool alive(int entity) const;
+
+	/**
+	*  Returns the number of entities.
+	*  @return the live entity count
+	*/
+	int  size() const;
+
+	/**
+	*  Adds a component to an entity, or replaces the one it has.
+	*  @param [in] entity The id of the entity
+	*  @param [in] value The component to copy in
+	*  @return the stored component, valid until the entity next moves
+	*/
+	template<typename T>
+	T&   add(int entity, const T& value = T());
+
+	/**
+	*  Removes a component from an entity, if it has one.
+	*  @param [in] entity The id of the entity
+	*/
+	template<typename T>
+	void remove(int entity);
+
+	/**
+	*  Checks whether an entity has a component.
+	*  @param [in] entity The id of the entity
+	*  @return true if the component is present
+	*/
+	template<typename T>
+	bool has(int entity) const;
+
+	/**
+	*  Returns an entity's component.
+	*  @param [in] entity The id of the entity
+	*  @return the component, or null if the entity doesn't have one
+	*/
+	template<typename T>
+	T*   get(int entity);
+
+	/**
+	*  Visits every entity with all of the given components.
+	*  The function is called with the entity's id followed by a
+	*  reference to each component, in the order they were listed.
+	*  @param [in] fnc The function to call for each entity
+	*/
+	template<typename... Ts, typename Fnc>
+	void each(Fnc fnc);
+
+private:
+	struct column_base
+	{
+		virtual ~column_base() = default;
+		virtual std::unique_ptr<column_base> makeEmpty() const = 0;
+		virtual void moveRow(int row, column_base& target) = 0;
+		virtual void removeRow(int row) = 0;
+		virtual void clear() = 0;
+	};
+
+	template<typename T>
+	struct column : column_base
+	{
+		std::unique_ptr<column_base> makeEmpty() const override;
+		void moveRow(int row, column_base& target) override;
+		void removeRow(int row) override;
+		void clear() override;
+
+		std::vector<T> data;
+	};
+
+	struct archetype
+	{
+		uint32_t mask = 0;
+		std::vector<int> entities;                           // the entity in each row
+		std::vector<std::unique_ptr<column_base>> columns;   // indexed by component id
+	};
+
+	struct entity_location
+	{
+		int archetype = -1;
+		int row = -1;
+	};
+
+	static int nextComponentId();
+
+	template<typename T>
+	static int componentId();
+
+	template<typename... Ts>
+	static uint32_t maskOf();
+
+	template<typename T>
+	static std::vector<T>& columnData(archetype& type);
+
+	template<typename... Ts, typename Fnc, size_t... Is>
+	static void eachRow(archetype& type, Fnc& fnc, std::index_sequence<Is...>);
+
+	int  findArchetype(uint32_t mask, int source);
+	void moveEntity(int entity, int target);
+	void removeRow(int entity);
+
+	std::vector<archetype> archetypes;
+	std::map<uint32_t, int> archetype_lookup;
+	std::vector<entity_location> locations;
+	std::vector<int> free_entities;
+	int entity_count = 0;
+};
+
+template<typename T>
+std::unique_ptr<EntityStore::column_base> EntityStore::column<T>::makeEmpty() const
+{
+	return std::unique_ptr<column_base>(new column<T>);
+}
+
+template<typename T>
+void EntityStore::column<T>::moveRow(int row, column_base& target)
+{
+	static_cast<column<T>&>(target).data.push_back(std::move(data[row]));
+}
+
+template<typename T>
+void EntityStore::column<T>::removeRow(int row)
+{
+	if (row != static_cast<int>(data.size()) - 1)
+	{
+		data[row] = std::move(data.back());
+	}
+	data.pop_back();
+}
+
+template<typename T>
+void EntityStore::column<T>::clear()
+{
+	data.clear();
+}
+
+template<typename T>
+int EntityStore::componentId()
+{
+	static const int id = nextComponentId();
+	return id;
+}
+
+template<typename... Ts>
+uint32_t EntityStore::maskOf()
+{
+	uint32_t mask = 0;
+	int expand[] = { 0, (mask |= 1u << componentId<Ts>(), 0)... };
+	(void)expand;
+	return mask;
+}
+
+template<typename T>
+std::vector<T>& EntityStore::columnData(archetype& type)
+{
+	return static_cast<column<T>&>(*type.columns[componentId<T>()]).data;
+}
+
+template<typename T>
+T& EntityStore::add(int entity, const T& value)
+{
+	const int id = componentId<T>();
+	const entity_location location = locations[entity];
+	archetype& source = archetypes[location.archetype];
+
+	if (source.mask & (1u << id))
+	{
+		T& existing = columnData<T>(source)[location.row];
+		existing = value;
+		return existing;
+	}
+
+	int target = findArchetype(source.mask | (1u << id), location.archetype);
+	if (!archetypes[target].columns[id])
+	{
+		archetypes[target].columns[id].reset(new column<T>);
+	}
+
+	std::vector<T>& data = columnData<T>(archetypes[target]);
+	data.push_back(value);
+	moveEntity(entity, target);
+	return data.back();
+}
+
+template<typename T>
+void EntityStore::remove(int entity)
+{
+	const int id = componentId<T>();
+	const entity_location location = locations[entity];
+	const uint32_t mask = archetypes[location.archetype].mask;
+
+	if (mask & (1u << id))
+	{
+		moveEntity(entity, findArchetype(mask & ~(1u << id), location.archetype));
+	}
+}
+
+template<typename T>
+bool EntityStore::has(int entity) const
+{
+	return (archetypes[locations[entity].archetype].mask & (1u << componentId<T>())) != 0;
+}
+
+template<typename T>
+T* EntityStore::get(int entity)
+{
+	const entity_location location = locations[entity];
+	archetype& type = archetypes[location.archetype];
+	if (!(type.mask & (1u << componentId<T>())))
+	{
+		return nullptr;
+	}
+
+	return &columnData<T>(type)[location.row];
+}
+
+template<typename... Ts, typename Fnc>
+void EntityStore::each(Fnc fnc)
+{
+	const uint32_t required = maskOf<Ts...>();
+	for (archetype& type : archetypes)
+	{
+		if ((type.mask & required) == required && !type.entities.empty())
+		{
+			eachRow<Ts...>(type, fnc, std::index_sequence_for<Ts...>());
+		}
+	}
+}
+
+template<typename... Ts, typename Fnc, size_t... Is>
+void EntityStore::eachRow(archetype& type, Fnc& fnc, std::index_sequence<Is...>)
+{
+	std::tuple<Ts*...> columns(columnData<Ts>(type).data()...);
+	const int rows = static_cast<int>(type.entities.size());
+	for (int row = 0; row < rows; row++)
+	{
+		fnc(type.entities[row], std::get<Is>(columns)[row]...);
+	}
+}
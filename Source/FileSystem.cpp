@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include "FileSystem.h"
+#include "Lz4.h"
+#include "Path.h"
+
+bool FileSystem::mount(const std::string& pack_path)
+{
+	std::unique_ptr<ResourcePack> pack(new ResourcePack);
+	if (!pack->open(pack_path))
+	{
+		return false;
+	}
+
+	mounted.push_back(std::move(pack));
+	return true;
+}
+
+void FileSystem::unmountAll()
+{
+	mounted.clear();
+}
+
+/**
+*   @brief   Reads a file.
+*   @details A packed file is viewed in place if it was stored as it
+             is, or decompressed into the buffer. A file in no pack is
+			 mapped from disk.
+*   @return  True if the file was read.
+*/
+bool FileSystem::read(const std::string& path, file_buffer& buffer, file_view& view) const
+{
+	const pack_entry* entry = nullptr;
+	const ResourcePack* pack = find(path, entry);
+	if (!pack)
+	{
+		if (!buffer.loose.open(path))
+		{
+			return false;
+		}
+
+		view.data = buffer.loose.data();
+		view.size = buffer.loose.size();
+		return true;
+	}
+
+	file_view stored = pack->stored(*entry);
+	if (entry->size > 0 && !stored.data)
+	{
+		return false;
+	}
+
+	switch (static_cast<PackCompression>(entry->compression))
+	{
+	case PackCompression::STORED:
+		view = stored;
+		return true;
+
+	case PackCompression::LZ4:
+		buffer.unpacked.resize(static_cast<size_t>(entry->size));
+		if (!decompressLz4(stored.data, stored.size, buffer.unpacked.data(), buffer.unpacked.size()))
+		{
+			return false;
+		}
+		view.data = buffer.unpacked.data();
+		view.size = buffer.unpacked.size();
+		return true;
+	}
+
+	return false;
+}
+
+bool FileSystem::exists(const std::string& path) const
+{
+	const pack_entry* entry = nullptr;
+	if (find(path, entry))
+	{
+		return true;
+	}
+
+	FILE* file = fopen(nativePath(path).c_str(), "rb");
+	if (file)
+	{
+		fclose(file);
+		return true;
+	}
+	return false;
+}
+
+/**
+*   @brief   Stamps a file.
+*   @details A packed file takes the pack's modification time, as
+             every file in it is rewritten when the pack is built, and
+			 its offset, which tells apart files of the same size.
+*   @return  True if the file exists.
+*/
+bool FileSystem::stamp(const std::string& path, file_stamp& stamp) const
+{
+	const pack_entry* entry = nullptr;
+	const ResourcePack* pack = find(path, entry);
+	if (pack)
+	{
+		stamp.size = entry->size;
+		stamp.modified = pack->modified();
+		stamp.offset = entry->offset;
+		return true;
+	}
+
+	stamp.offset = 0;
+	return fileStamp(path, stamp.size, stamp.modified);
+}
+
+int FileSystem::packs() const
+{
+	return static_cast<int>(mounted.size());
+}
+
+const ResourcePack* FileSystem::find(const std::string& path, const pack_entry*& entry) const
+{
+	for (auto pack = mounted.rbegin(); pack != mounted.rend(); ++pack)
+	{
+		entry = (*pack)->find(path);
+		if (entry)
+		{
+			return pack->get();
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "ResourcePack.h"
+
+/**
+*  Holds a file's bytes when they can't be viewed where they lie:
+*  the mapping of a loose file, or a packed file once decompressed.
+*/
+struct file_buffer
+{
+	MappedFile loose;
+	std::vector<char> unpacked;
+};
+
+/**
+*  Tells a version of a file apart from any other without reading it.
+*/
+struct file_stamp
+{
+	uint64_t size = 0;        /**< The file's size once decompressed. */
+	int64_t modified = 0;     /**< When the file, or the pack holding it, was last written. */
+	uint64_t offset = 0;      /**< Where the file lies in its pack, zero if it's loose. */
+};
+
+/**
+*  Reads game files from mounted packs, falling back to loose files.
+*  Files a pack stores uncompressed are served as views into its
+*  mapping without being copied, compressed ones are decompressed into
+*  the caller's buffer. Anything not packed is read from disk as
+*  before, so the game still runs from a plain Resources folder during
+*  development. Reading is safe from several threads at once, so a set
+*  of files can be decompressed in parallel.
+*/
+class FileSystem
+{
+public:
+
+	/**
+	*  Default constructor.
+	*/
+	FileSystem() = default;
+
+	FileSystem(const FileSystem&) = delete;
+	FileSystem& operator=(const FileSystem&) = delete;
+
+	/**
+	*  Mounts a pack. Packs mounted later are searched first, so a
+	*  patch pack can replace files in the one it was built against.
+	*  @param [in] pack_path The path to the pack file
+	*  @return true if the pack was opened
+	*/
+	bool mount(const std::string& pack_path);
+
+	/**
+	*  Unmounts every pack. Views into them are no longer valid.
+	*/
+	void unmountAll();
+
+	/**
+	*  Reads a file from the mounted packs, or maps it from disk.
+	*  @param [in] path The file's path, as it would be opened from disk
+	*  @param [in] buffer Holds the bytes if they can't be viewed in the
+	*  pack. The view is valid until this is cleared or reused.
+	*  @param [out] view The file's contents
+	*  @return true if the file was found and, if compressed, was
+	*  decompressed
+	*/
+	bool read(const std::string& path, file_buffer& buffer, file_view& view) const;
+
+	/**
+	*  Checks whether a file is packed or on disk.
+	*  @param [in] path The file's path
+	*  @return true if the file exists
+	*/
+	bool exists(const std::string& path) const;
+
+	/**
+	*  Stamps a file with its size and modification time, from the pack
+	*  index or the file system, without reading it.
+	*  @param [in] path The file's path
+	*  @param [out] stamp The file's stamp
+	*  @return true if the file exists
+	*/
+	bool stamp(const std::string& path, file_stamp& stamp) const;
+
+	/**
+	*  Returns the number of mounted packs.
+	*  @return the pack count
+	*/
+	int  packs() const;
+
+private:
+	const ResourcePack* find(const std::string& path, const pack_entry*& entry) const;
+
+	std::vector<std::unique_ptr<ResourcePack>> mounted;
+};
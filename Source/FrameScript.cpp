@@ -0,0 +1,177 @@
+#if defined(ASGE_HEADLESS)
+
+#include <algorithm>
+#include <ctype.h>
+#include <sstream>
+#include <stdlib.h>
+#include <Engine/Keys.h>
+
+#include "FrameScript.h"
+#include "MappedFile.h"
+
+namespace
+{
+	struct named_key
+	{
+		const char* name;
+		int key;
+	};
+
+	const named_key NAMED_KEYS[] =
+	{
+		{ "space", ASGE::KEYS::KEY_SPACE },
+		{ "escape", ASGE::KEYS::KEY_ESCAPE },
+		{ "enter", ASGE::KEYS::KEY_ENTER },
+		{ "left", ASGE::KEYS::KEY_LEFT },
+		{ "right", ASGE::KEYS::KEY_RIGHT },
+		{ "up", ASGE::KEYS::KEY_UP },
+		{ "down", ASGE::KEYS::KEY_DOWN }
+	};
+
+	bool parseNumber(const std::string& word, int& number)
+	{
+		if (word.empty() || word.size() > 9 ||
+			!std::all_of(word.begin(), word.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)) != 0; }))
+		{
+			return false;
+		}
+
+		number = atoi(word.c_str());
+		return true;
+	}
+
+	/**
+	*   @brief   Reads a key's name or code.
+	*   @details Letters and digits are their own codes, as letters
+	             are upper case in ASGE::KEYS.
+	*   @return  True if the key was recognised.
+	*/
+	bool parseKey(const std::string& word, int& key)
+	{
+		if (word.size() == 1 && isalnum(static_cast<unsigned char>(word[0])))
+		{
+			key = toupper(static_cast<unsigned char>(word[0]));
+			return true;
+		}
+
+		for (const named_key& named : NAMED_KEYS)
+		{
+			if (word == named.name)
+			{
+				key = named.key;
+				return true;
+			}
+		}
+		return parseNumber(word, key);
+	}
+
+	bool parseState(const std::string& word, bool repeats, int& state)
+	{
+		if (word == "pressed")
+		{
+			state = ASGE::KEYS::KEY_PRESSED;
+		}
+		else if (word == "released")
+		{
+			state = ASGE::KEYS::KEY_RELEASED;
+		}
+		else if (word == "repeated" && repeats)
+		{
+			state = ASGE::KEYS::KEY_REPEATED;
+		}
+		else
+		{
+			return false;
+		}
+		return true;
+	}
+
+	bool parseStep(std::istringstream& words, script_step& step)
+	{
+		std::string action, first, second;
+		if (!(words >> first) || !parseNumber(first, step.frame) || !(words >> action >> first))
+		{
+			return false;
+		}
+
+		if (action == "key")
+		{
+			step.action = ScriptAction::KEY;
+			return parseKey(first, step.code) && words >> second && parseState(second, true, step.state);
+		}
+		if (action == "click")
+		{
+			step.action = ScriptAction::CLICK;
+			return parseNumber(first, step.code) && words >> second && parseState(second, false, step.state);
+		}
+		if (action == "move")
+		{
+			step.action = ScriptAction::MOVE;
+			std::istringstream x(first);
+			return x >> step.position[0] && words >> step.position[1];
+		}
+		if (action == "capture")
+		{
+			step.action = ScriptAction::CAPTURE;
+			step.name = first;
+			return true;
+		}
+		return false;
+	}
+}
+
+/**
+*   @brief   Reads a frame script.
+*   @details A line with anything left over after its step is refused,
+             so a typo can't quietly drop part of a line.
+*   @return  True if every line was read.
+*/
+bool parseFrameScript(const std::string& text, std::vector<script_step>& steps, int& error_line)
+{
+	steps.clear();
+	error_line = 0;
+
+	std::istringstream lines(text);
+	std::string line;
+	for (int number = 1; std::getline(lines, line); number++)
+	{
+		line = line.substr(0, line.find('#'));
+		if (line.find_first_not_of(" \t\r") == std::string::npos)
+		{
+			continue;
+		}
+
+		std::istringstream words(line);
+		script_step step;
+		std::string extra;
+		if (!parseStep(words, step) || words >> extra)
+		{
+			steps.clear();
+			error_line = number;
+			return false;
+		}
+		steps.push_back(step);
+	}
+
+	std::stable_sort(steps.begin(), steps.end(), [](const script_step& lhs, const script_step& rhs)
+	{
+		return lhs.frame < rhs.frame;
+	});
+	return true;
+}
+
+bool loadFrameScript(const std::string& path, std::vector<script_step>& steps, int& error_line)
+{
+	MappedFile file;
+	if (!file.open(path))
+	{
+		steps.clear();
+		error_line = 0;
+		return false;
+	}
+
+	const std::string text = file.data() ? std::string(file.data(), file.size()) : std::string();
+	return parseFrameScript(text, steps, error_line);
+}
+
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+*  What a step of a frame script does.
+*/
+enum class ScriptAction
+{
+	KEY,        /**< A key is pressed, released or repeated. */
+	CLICK,      /**< A mouse button is pressed or released. */
+	MOVE,       /**< The cursor moves. */
+	CAPTURE     /**< The frame is saved under a name. */
+};
+
+/**
+*  A step of a frame script, taken on the frame given.
+*/
+struct script_step
+{
+	int frame = 0;                          // counted from the first frame after loading
+	ScriptAction action = ScriptAction::KEY;
+	int code = 0;                           // the key or mouse button
+	int state = 0;                          // pressed, released or repeated, from ASGE::KEYS
+	double position[2] = { 0, 0 };          // where the cursor moves to
+	std::string name;                       // what a capture is saved as
+};
+
+/**
+*  Reads a frame script, which plays input into the game and names the
+*  frames to capture. Each line is a frame number and a step:
+*
+*      <frame> key <key> pressed|released|repeated
+*      <frame> click <button> pressed|released
+*      <frame> move <x> <y>
+*      <frame> capture <name>
+*
+*  Keys are a letter, a digit, space, escape, enter, left, right, up,
+*  down or an ASGE::KEYS code. Blank lines and anything after a # are
+*  ignored. Input is sent at the start of its frame, in the order
+*  written, and captures are taken once the frame is drawn.
+*  @param [in] text The script
+*  @param [out] steps The steps, sorted by frame, in the order written
+*  within a frame
+*  @param [out] error_line The first line that couldn't be read, or 0
+*  @return true if every line was read
+*/
+bool parseFrameScript(const std::string& text, std::vector<script_step>& steps, int& error_line);
+
+/**
+*  Reads a frame script from a file.
+*  @param [in] path The path to the script
+*  @param [out] steps The steps, sorted by frame
+*  @param [out] error_line The first line that couldn't be read, or 0
+*  if the file couldn't be opened
+*  @return true if the file was read and every line parsed
+*/
+bool loadFrameScript(const std::string& path, std::vector<script_step>& steps, int& error_line);
@@ -0,0 +1,47 @@
+#include <Engine/Renderer.h>
+#include "FrameSnapshot.h"
+
+void FrameSnapshot::clear()
+{
+	sprites.clear();
+	text_count = 0;
+}
+
+void FrameSnapshot::addSprite(const ASGE::Sprite& sprite, DrawLayer layer)
+{
+	sprites.add(sprite, layer);
+}
+
+/**
+*   @brief   Records a line of text.
+*   @details The strings are reused from the last time the frame was
+             recorded, so text that fits in one allocates nothing.
+*   @return  void
+*/
+void FrameSnapshot::addText(const std::string& text, int x, int y, const ASGE::Colour& colour)
+{
+	if (text_count == texts.size())
+	{
+		texts.emplace_back();
+	}
+
+	snapshot_text& line = texts[text_count++];
+	line.text = text;
+	line.x = x;
+	line.y = y;
+	line.colour = colour;
+}
+
+void FrameSnapshot::finish()
+{
+	sprites.sort();
+}
+
+void FrameSnapshot::draw(ASGE::Renderer& renderer) const
+{
+	sprites.submit(renderer);
+	for (size_t i = 0; i < text_count; i++)
+	{
+		renderer.renderText(texts[i].text, texts[i].x, texts[i].y, texts[i].colour);
+	}
+}
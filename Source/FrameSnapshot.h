@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <Engine/Colours.h>
+#include "DrawList.h"
+
+namespace ASGE
+{
+	class Renderer;
+}
+
+/**
+*  A line of text to draw, in the renderer's current font.
+*/
+struct snapshot_text
+{
+	std::string text;
+	int x = 0;
+	int y = 0;
+	ASGE::Colour colour = ASGE::COLOURS::WHITE;
+};
+
+/**
+*  Everything a frame draws, recorded by the game's update.
+*  Sprites are copied and text is kept as it was given, so the frame
+*  holds nothing the game goes on to change. Once finished, it can be
+*  drawn on another thread, while the game updates the next frame, as
+*  often as needed.
+*/
+class FrameSnapshot
+{
+public:
+
+	/**
+	*  Empties the frame to record another.
+	*/
+	void clear();
+
+	/**
+	*  Records a copy of a sprite.
+	*  @param [in] sprite The sprite, drawn as it is now
+	*  @param [in] layer The layer to draw it in
+	*/
+	void addSprite(const ASGE::Sprite& sprite, DrawLayer layer);
+
+	/**
+	*  Records a line of text, drawn over every sprite.
+	*  @param [in] text The text to draw
+	*  @param [in] x The position of the text on the X axis
+	*  @param [in] y The position of the text's baseline on the Y axis
+	*  @param [in] colour The colour of the text
+	*/
+	void addText(const std::string& text, int x, int y, const ASGE::Colour& colour);
+
+	/**
+	*  Puts the sprites in drawing order, once everything is recorded.
+	*/
+	void finish();
+
+	/**
+	*  Draws the frame: the sprites in order, then the text.
+	*  @param [in] renderer The renderer to draw with
+	*/
+	void draw(ASGE::Renderer& renderer) const;
+
+private:
+	DrawList sprites;
+	std::vector<snapshot_text> texts;   // the first text_count are this frame's
+	size_t text_count = 0;
+};
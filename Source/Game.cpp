@@ -1,4 +1,6 @@
+#include <math.h>
 #include <string>
+#include <vector>
 
 #include <Engine/Keys.h>
 #include <Engine/Input.h>
@@ -7,6 +9,38 @@
 
 #include "Game.h"
 
+namespace
+{
+	const char MENU_TEXTURE[] = "Resources\\Textures\\MyAssets\\menu.jpg";
+	const char ROCK_TEXTURE[] = ".\\Resources\\Textures\\MyAssets\\angeryrock.png";
+	const char SLINGSHOT_TEXTURE[] = ".\\Resources\\Textures\\MyAssets\\slingshot.png";
+	const char LOSE_TEXTURE[] = ".\\Resources\\Textures\\MyAssets\\You Lose text.png";
+	const char WIN_TEXTURE[] = ".\\Resources\\Textures\\MyAssets\\You win text.png";
+
+	std::string randomBackground()
+	{
+		std::string filename = "Resources\\Textures\\lvl";
+		filename += std::to_string(std::rand() % 3 + 1);
+		filename += ".png";
+		return filename;
+	}
+
+	/**
+	*   @brief   Records an object's sprite, if it has one.
+	*   @details An object is left without a sprite when its texture
+	             fails to load, and is then just not drawn.
+	*   @return  void
+	*/
+	void addObject(FrameSnapshot& frame, GameObject& object, DrawLayer layer)
+	{
+		SpriteComponent* component = object.spriteComponent();
+		if (component && component->getSprite())
+		{
+			frame.addSprite(*component->getSprite(), layer);
+		}
+	}
+}
+
 /**
 *   @brief   Default Constructor.
 *   @details Consider setting the game's width and height
@@ -29,14 +63,18 @@ AngryBirdsGame::~AngryBirdsGame()
 
 /**
 *   @brief   Initialises the game.
-*   @details The game window is created and all assets required to
-			 run the game are loaded. The keyHandler and clickHandler
-			 callback should also be set in the initialise function.
+*   @details The game window is created and the menu is loaded, while
+			 the rest of the assets stream in behind it. The keyHandler
+			 and clickHandler callback should also be set in the
+			 initialise function.
 *   @return  True if the game initialised correctly.
 */
 bool AngryBirdsGame::init()
 {
 	setupResolution();
+#if defined(ASGE_HEADLESS)
+	threadPool(&thread_pool);
+#endif
 	if (!initAPI())
 	{
 		return false;
@@ -47,6 +85,9 @@ bool AngryBirdsGame::init()
 	renderer->setWindowedMode(ASGE::Renderer::WindowMode::WINDOWED);
 	renderer->setClearColour(ASGE::COLOURS::BLACK);
 
+	// frames hand sprites over sorted, so they're batched as given
+	renderer->setSpriteMode(ASGE::SpriteSortMode::DEFERRED);
+
 	// input handling functions
 	inputs->use_threads = false;
 
@@ -56,36 +97,208 @@ bool AngryBirdsGame::init()
 	mouse_callback_id =inputs->addCallbackFnc(
 		ASGE::E_MOUSE_CLICK, &AngryBirdsGame::clickHandler, this);
 
-	if (!loadBackgrounds())
+	// without a pack, everything is read from the loose files
+	files.mount("Resources.pak");
+
+	// the menu is all the first frame needs, so it's the only texture waited for
+	handle menu = assets.request(MENU_TEXTURE, [this](const std::string& path)
+	{
+		return menu_layer.addSpriteComponent(renderer.get(), path);
+	});
+	bool menu_loaded = assets.finish(menu);
+	assets.release(menu);
+	if (!menu_loaded)
 	{
 		return false;
 	}
 
-	if (!menu_layer.addSpriteComponent(renderer.get(), "Resources\\Textures\\MyAssets\\menu.jpg"))
+	if (!loadAtlases())
 	{
 		return false;
 	}
 
-	setUpGameobjects();
-	setUpActive();
+	world.threadPool(&thread_pool);
+	requestAssets();
 
 	return true;
 }
 
-bool AngryBirdsGame::loadBackgrounds()
+/**
+*   @brief   Shows the prefetched background and prefetches another.
+*   @details Called whenever the level is set up. The next background
+             is picked at random and streamed in during play, so a
+			 restart can switch to it without waiting. If it hasn't
+			 arrived yet, the current background stays.
+*   @return  void
+*/
+void AngryBirdsGame::loadBackgrounds()
+{
+	if (assets.ready(next_background) &&
+		background_layer.addSpriteComponent(renderer.get(), texturePath(next_background_file)))
+	{
+		background_file = next_background_file;
+	}
+	assets.release(next_background);
+
+	next_background_file = randomBackground();
+	next_background = requestTexture(next_background_file);
+}
+
+/**
+*   @brief   Loads the sprite sheets the level is built from.
+*   @details Every block shares the wood sheet's texture and every
+             enemy the aliens', so drawing the level binds two textures
+			 however many pieces it has. The sheets are loaded in
+			 parallel, so any decompressing out of a pack is spread
+			 over the thread pool.
+*   @return  True if both sheets loaded.
+*/
+bool AngryBirdsGame::loadAtlases()
+{
+	TextureAtlas* atlases[] = { &wood_atlas, &alien_atlas };
+	const char* paths[] = {
+		".\\Resources\\Textures\\kenney_physicspack\\Spritesheet\\spritesheet_wood.xml",
+		".\\Resources\\Textures\\kenney_physicspack\\Spritesheet\\spritesheet_aliens.xml" };
+	bool loaded[] = { false, false };
+
+	thread_pool.run(2, [this, &atlases, &paths, &loaded](int i)
+	{
+		loaded[i] = atlases[i]->load(paths[i], files);
+	});
+
+	return loaded[0] && loaded[1];
+}
+
+/**
+*   @brief   Queues every texture the level needs.
+*   @details Each is decoded on the loader's threads while the menu
+             shows, then loaded into the engine a frame at a time by
+			 update, which builds the level once they're all in.
+			 Textures without a decoded copy yet are written to the
+			 cache. Later runs find the copy from the source's size
+			 and modification time, and only read a source again if
+			 those have changed.
+*   @return  void
+*/
+void AngryBirdsGame::requestAssets()
+{
+	background_file = randomBackground();
+	auto place = [this](GameObject& object, float x, float y)
+	{
+		return [this, &object, x, y](const std::string& path)
+		{
+			if (!object.addSpriteComponent(renderer.get(), path))
+			{
+				return false;
+			}
+			object.spriteComponent()->getSprite()->xPos(x);
+			object.spriteComponent()->getSprite()->yPos(y);
+			return true;
+		};
+	};
+
+	level_assets = {
+		assets.request(background_file, place(background_layer, 0.0f, 0.0f)),
+		requestTexture(wood_atlas.imagePath()),
+		requestTexture(alien_atlas.imagePath()),
+		// the largest the rock is drawn at
+		requestTexture(TextureVariants::path(ROCK_TEXTURE, variants.level(files, ROCK_TEXTURE, 48.0f, 48.0f))),
+		assets.request(SLINGSHOT_TEXTURE, place(slingshot, 330.0f, 700.0f)),
+		assets.request(LOSE_TEXTURE, place(lose_sprite, 100.0f, 100.0f)),
+		assets.request(WIN_TEXTURE, place(win_sprite, 100.0f, 100.0f)) };
+}
+
+/**
+*   @brief   Queues a texture to be loaded into the texture cache.
+*   @details The texture is let go as soon as it's loaded, leaving it
+             cached for the sprites that draw it later.
+*   @return  The request's handle.
+*/
+handle AngryBirdsGame::requestTexture(const std::string& texture_file_name)
+{
+	return assets.request(texture_file_name, [this](const std::string& path)
+	{
+		handle texture = textures.acquire(renderer.get(), path);
+		textures.release(texture);
+		return texture != handle();
+	});
+}
+
+/**
+*   @brief   Returns the path to load a texture from.
+*   @details The decoded copy's path, spelt as the texture cache spells
+             it, so the engine reuses the texture if it's cached.
+*   @return  The path.
+*/
+std::string AngryBirdsGame::texturePath(const std::string& texture_file_name)
 {
-	std::string filename = "Resources\\Textures\\lvl";
-	filename += std::to_string(std::rand() % 3 + 1);
-	filename += ".png";
+	return TextureCache::normalise(decoded_textures.resolve(files, texture_file_name));
+}
 
-	if (!background_layer.addSpriteComponent(renderer.get(), filename))
+/**
+*   @brief   Builds the level once its assets have streamed in.
+*   @details The level can't be played without a background, so the
+             game stops if it failed to load. Anything else missing
+			 is simply not drawn.
+*   @return  True once the level is built.
+*/
+bool AngryBirdsGame::buildLevel()
+{
+	if (level_built)
 	{
+		return true;
+	}
+
+	for (handle asset : level_assets)
+	{
+		AssetState state = assets.state(asset);
+		if (state != AssetState::READY && state != AssetState::FAILED)
+		{
+			return false;
+		}
+	}
+
+	if (!assets.ready(level_assets[0]))
+	{
+		signalExit();
 		return false;
 	}
 
+	for (handle asset : level_assets)
+	{
+		assets.release(asset);
+	}
+	level_assets.clear();
+
+	setUpGameobjects();
+	setUpActive();
+	loadBackgrounds();
+	level_built = true;
 	return true;
 }
 
+/**
+*   @brief   Checks whether the first level has streamed in.
+*   @details Until it has, the menu can't be left.
+*   @return  True once the level has been built.
+*/
+bool AngryBirdsGame::levelLoaded() const
+{
+	return level_built;
+}
+
+/**
+*   @brief   Waits for the textures asked for to finish decoding.
+*   @details For repeatable runs, such as frame captures. Each is then
+             finalised in the frames that follow, one a frame as
+			 always, rather than whenever the workers get to it.
+*   @return  void
+*/
+void AngryBirdsGame::settleAssets()
+{
+	assets.settle();
+}
+
 /**
 *   @brief   Sets the game window resolution
 *   @details This function is designed to create the window size, any 
@@ -140,7 +353,7 @@ void AngryBirdsGame::keyHandler(const ASGE::SharedEventData data)
 	else if (in_menu)
 	{
 		if (key->key == ASGE::KEYS::KEY_SPACE
-			&& key->action == ASGE::KEYS::KEY_RELEASED)
+			&& key->action == ASGE::KEYS::KEY_RELEASED && level_built)
 		{
 			in_menu = false;
 			in_tutorial = true;
@@ -166,6 +379,7 @@ void AngryBirdsGame::keyHandler(const ASGE::SharedEventData data)
 				game_state = 0;
 				setUpGameobjects();
 				setUpActive();
+				loadBackgrounds();
 				number_of_enemies = 3;
 				ammo_array_size = 5;
 				score = 0;
@@ -191,13 +405,20 @@ void AngryBirdsGame::clickHandler(const ASGE::SharedEventData data)
 	double x_pos, y_pos;
 	inputs->getCursorPos(x_pos, y_pos);
 
+	SpriteComponent* ammo_component = entity_sprites.get(active_ammo_sprite);
+	if (!ammo_component)
+	{
+		return;
+	}
+
+	ASGE::Sprite* ammo_sprite = ammo_component->getSprite();
 	if(click->action == 1)
 	{
-		if (x_pos >= active_ammo_sprite->xPos() - 50 &&
-			x_pos <= (active_ammo_sprite->xPos() + active_ammo_sprite->width()))
+		if (x_pos >= ammo_sprite->xPos() - 50 &&
+			x_pos <= (ammo_sprite->xPos() + ammo_sprite->width()))
 		{
-			if (y_pos >= active_ammo_sprite->yPos() - 50
-				&& y_pos <= (active_ammo_sprite->yPos() + active_ammo_sprite->height()))
+			if (y_pos >= ammo_sprite->yPos() - 50
+				&& y_pos <= (ammo_sprite->yPos() + ammo_sprite->height()))
 			{
 				bird_grabbed = true;
 			}
@@ -209,7 +430,7 @@ void AngryBirdsGame::clickHandler(const ASGE::SharedEventData data)
 		{
 			velocity.x = start_pos.x - mouse_x_pos;
 			velocity.y = start_pos.y - mouse_y_pos;
-			bird_in_air = true;
+			fire();
 		}
 	}
 
@@ -220,172 +441,353 @@ void AngryBirdsGame::clickHandler(const ASGE::SharedEventData data)
 *   @details Prepares the renderer subsystem before drawing the
 		     current frame. Once the current frame is has finished
 		     the buffers are swapped accordingly and the image shown.
+			 The simulation is advanced in fixed steps, after which
+			 every body's entity is placed between its last two states.
 *   @return  void
 */
 void AngryBirdsGame::update(const ASGE::GameTime& us)
 {
 	auto dt_sec = us.delta_time.count() / 1000.0;
 
+	// one texture a frame, so streaming never stalls the game for long
+	assets.finalise(1);
+	buildLevel();
+
 	if (!in_menu)
 	{
 		//Bird Grabbed
-		preLaunch(dt_sec);
+		preLaunch();
+
+		//Fixed step flight and collision
+		physics_stepper.advance(dt_sec, [this](float step_sec)
+		{
+			simulate(step_sec);
+		});
 
-		//Handles all collision
-		collision();
+		syncBodies(physics_stepper.alpha());
 
 		// Win/Lose State
 		gameState();
 	}
+	else
+	{
+		physics_stepper.reset();
+	}
+
+	FrameSnapshot& frame = frames.back();
+	recordFrame(frame);
+	frames.publish();
 }
 
 /**
 *   @brief   Renders the scene
-*   @details Renders all the game objects to the current frame.
-	         Once the current frame is has finished the buffers are
-			 swapped accordingly and the image shown.
+*   @details Draws the latest frame recorded by update. Once the
+	         current frame is has finished the buffers are swapped
+			 accordingly and the image shown. Nothing the game changes
+			 is read here, so the frame can be drawn on a thread of its
+			 own while the next is updated.
 *   @return  void
 */
 void AngryBirdsGame::render(const ASGE::GameTime &)
 {
 	renderer->setFont(0);
-	
+
+	frames.acquire();
+	frames.front().draw(*renderer);
+}
+
+/**
+*   @brief   Records what the frame draws.
+*   @details The sprites are copied as they stand into the frame, which
+             sorts them by layer and texture, and the text is drawn
+			 over them.
+*   @return  void
+*/
+void AngryBirdsGame::recordFrame(FrameSnapshot& frame)
+{
+	frame.clear();
 	if (in_menu)
 	{
-		renderer->renderSprite(*menu_layer.spriteComponent()->getSprite());
+		addObject(frame, menu_layer, DrawLayer::OVERLAY);
+		if (!level_built)
+		{
+			frame.addText("Loading...", 50, 1030, ASGE::COLOURS::WHITE);
+		}
 	}
 	else
 	{
-		renderer->renderSprite(*background_layer.spriteComponent()->getSprite());
+		addObject(frame, background_layer, DrawLayer::BACKGROUND);
 
 		if (game_state == 0)
 		{
 			if (in_tutorial)
 			{
-				howToPlayUI();
+				howToPlayUI(frame);
 			}
 			else if (!in_tutorial)
 			{
-				inGameUI();
+				inGameUI(frame);
 			}
 		}
 		else if (game_state == 1)
 		{
-			winUI();
+			addObject(frame, win_sprite, DrawLayer::OVERLAY);
 		}
 		else if (game_state == -1)
 		{
-			loseUI();
+			loseUI(frame);
 		}
-		else if (game_state == 0)
-		{
-			inGameUI();
-		}
-
-
-		//debug stuff
-	/*	renderer->renderText(std::to_string(game_state), 1000, 50, ASGE::COLOURS::BLACK);
-		renderer->renderText(std::to_string(velocity.x), 1000, 75, ASGE::COLOURS::BLACK);
-		renderer->renderText(std::to_string(velocity.y), 1000, 100, ASGE::COLOURS::BLACK);*/
-					
 	}
+	frame.finish();
 }
 
 //Setup Functions
 void AngryBirdsGame::setUpGameobjects()
 {
+	world.clear();
+	entities.each<sprite_ref>([this](int, sprite_ref& drawn)
+	{
+		textures.release(drawn.texture);
+	});
+	entities.clear();
+	entity_sprites.releaseAll();
+	active_ammo = -1;
+	active_ammo_sprite = handle();
+	world.gravity(vector2(0.0f, -gravity * move_speed_y));
+
+	body_def ground;
+	ground.position = vector2(game_width * 0.5f, 1000.0f);
+	ground.half_width = game_width * 0.5f;
+	ground.half_height = 50.0f;
+	ground.density = 0.0f;
+	ground_body = world.createBody(ground);
+
 	//Ammo Set Up
-	for (int i = 0; i < ammo_array_size; i++)
+	for (int i = 0; i < 5; i++)
 	{
-		ammo[i].addSpriteComponent(renderer.get(), 
-			".\\Resources\\Textures\\MyAssets\\angeryrock.png");
-		
 		float new_x_pos = (i * 12) + 10;
+		ammo[i] = spawn(ROCK_TEXTURE,
+			vector2(new_x_pos, 825), vector2(48, 48));
+	}
+
+	//Block Set Up, two on the ground with one resting across them
+	const vector2 block_positions[3] = { { 1300, 902 }, { 1440, 902 }, { 1370, 854 } };
+	for (int i = 0; i < block_array_size; i++)
+	{
+		int block = spawn(wood_atlas, "elementWood014.png", block_positions[i], vector2(96, 48));
+		if (block < 0)
+		{
+			continue;
+		}
+
+		object_kind kind;
+		kind.type = ObjectType::BLOCK;
+		entities.add(block, kind);
+		entities.add<ColliderComponent>(block).makeBox(48, 24);
 
-		ammo_sprite = ammo[i].spriteComponent()->getSprite();
-		ammo_sprite->xPos(new_x_pos);
-		ammo_sprite->yPos(825);
-		ammo_sprite->width(48);
-		ammo_sprite->height(48);
+		addBody(block, body_def());
 	}
 
-	//Enemy Set Up
+	//Enemy Set Up, sheltering on and beside the blocks
+	const vector2 enemy_positions[3] = { { 1310, 854 }, { 1394, 806 }, { 1560, 902 } };
 	for (int i = 0; i < enemy_array_size; i++)
 	{
-		enemies[i].addSpriteComponent(renderer.get(),
-			".\\Resources\\Textures\\kenney_physicspack\\PNG\\Aliens\\alienBlue_suit.png");
+		int enemy = spawn(alien_atlas, "alienBlue_suit.png", enemy_positions[i], vector2(48, 48));
+		if (enemy < 0)
+		{
+			continue;
+		}
 
-		float new_x_pos = (i * 140) + 1300;
-		float new_y_pos = (i * -150) + 835;
+		object_kind kind;
+		kind.type = ObjectType::ENEMY;
+		entities.add(enemy, kind);
 
-		enemy_sprite = enemies[i].spriteComponent()->getSprite();
-		enemy_sprite->xPos(new_x_pos);
-		enemy_sprite->yPos(new_y_pos);
-		enemy_sprite->width(48);
-		enemy_sprite->height(48);
-		enemies[i].visibility = true;
+		// the suit's helmet is rounded, so the top corners are cut off
+		const vector2 enemy_outline[6] = {
+			{ -24, -10 }, { -10, -24 }, { 10, -24 }, { 24, -10 }, { 24, 24 }, { -24, 24 } };
+		entities.add<ColliderComponent>(enemy).makePolygon(enemy_outline, 6);
+
+		addBody(enemy, body_def());
 	}
 
-	for (int i = 0; i < block_array_size; i++)
+}
+
+void AngryBirdsGame::setUpActive()
+{
+	active_ammo = spawn(ROCK_TEXTURE, start_pos, vector2(42, 42));
+	if (active_ammo < 0)
 	{
-		blocks[i].addSpriteComponent(renderer.get(),
-			".\\Resources\\Textures\\kenney_physicspack\\PNG\\Wood elements\\elementWood014.png");
+		return;
+	}
 
-		float new_x_pos = (i * 120) + 1300;
-		float new_y_pos = (i * -150) + 880;
+	active_ammo_sprite = entities.get<sprite_ref>(active_ammo)->sprite;
 
-		block_sprite = blocks[i].spriteComponent()->getSprite();
-		block_sprite->xPos(new_x_pos);
-		block_sprite->yPos(new_y_pos);
-		block_sprite->width(96);
-		block_sprite->height(48);
-	}
+	object_kind kind;
+	kind.type = ObjectType::PROJECTILE;
+	entities.add(active_ammo, kind);
+	entities.add<ColliderComponent>(active_ammo).makeCircle(21);
+	entities.add(active_ammo, rigid_body());
+	entities.add(active_ammo, motion());
+}
 
-	//Slingshot Set Up
-	slingshot.addSpriteComponent(renderer.get(),
-		".\\Resources\\Textures\\MyAssets\\slingshot.png");
-	slingshot.spriteComponent()->getSprite()->xPos(330);
-	slingshot.spriteComponent()->getSprite()->yPos(700);
+/**
+*   @brief   Creates an entity that draws a whole texture.
+*   @details The texture's smallest variant that still covers the size
+             it's drawn at is loaded in its place.
+*   @param   texture_file_name The file path to the texture to load.
+*   @param   position The top left of the sprite.
+*   @param   size The width and height to draw the sprite at.
+*   @return  The entity, or -1 if the texture couldn't be loaded.
+*/
+int AngryBirdsGame::spawn(const std::string& texture_file_name,
+	const vector2& position, const vector2& size)
+{
+	int level = variants.level(files, texture_file_name, size.x, size.y);
+	return spawnSprite(TextureVariants::path(texture_file_name, level), position, size);
+}
+
+/**
+*   @brief   Creates an entity that draws a sprite.
+*   @details The sprite comes from the game's pool and goes back to it
+			 when the level is set up again, so rebuilding the level
+			 reuses the same sprites. The texture comes from the cache,
+			 so each file is only decoded once however many entities
+			 draw it, and is loaded from its decoded copy when there
+			 is one. Further components are added by the caller.
+*   @param   texture_file_name The file path to the texture to load.
+*   @param   position The top left of the sprite.
+*   @param   size The width and height to draw the sprite at.
+*   @return  The entity, or -1 if the texture couldn't be loaded.
+*/
+int AngryBirdsGame::spawnSprite(const std::string& texture_file_name,
+	const vector2& position, const vector2& size)
+{
+	handle texture = textures.acquire(renderer.get(), texturePath(texture_file_name));
+	if (texture == handle())
+	{
+		return -1;
+	}
 
-	//Lose Set Up
-	lose_sprite.addSpriteComponent(renderer.get(),
-		".\\Resources\\Textures\\MyAssets\\You Lose text.png");
-	lose_sprite.spriteComponent()->getSprite()->xPos(100);
-	lose_sprite.spriteComponent()->getSprite()->yPos(100);
+	handle pooled = entity_sprites.acquire();
+	SpriteComponent& component = *entity_sprites.get(pooled);
+	if (!component.loadSprite(renderer.get(), textures.path(texture)))
+	{
+		entity_sprites.release(pooled);
+		textures.release(texture);
+		return -1;
+	}
 
-	//Win Set Up
-	win_sprite.addSpriteComponent(renderer.get(),
-		".\\Resources\\Textures\\MyAssets\\You win text.png");
-	win_sprite.spriteComponent()->getSprite()->xPos(100);
-	win_sprite.spriteComponent()->getSprite()->yPos(100);
+	ASGE::Sprite* sprite = component.getSprite();
+	const ASGE::Texture2D* texture_data = sprite->getTexture();
+	float* src = sprite->srcRect();
+	src[0] = 0.0f;
+	src[1] = 0.0f;
+	src[2] = texture_data ? static_cast<float>(texture_data->getWidth()) : 0.0f;
+	src[3] = texture_data ? static_cast<float>(texture_data->getHeight()) : 0.0f;
+
+	sprite->xPos(position.x);
+	sprite->yPos(position.y);
+	sprite->width(size.x);
+	sprite->height(size.y);
+	sprite->rotationInRadians(0.0f);
+
+	int entity = entities.create();
+
+	transform placed;
+	placed.position = position;
+	placed.size = size;
+	entities.add(entity, placed);
+
+	sprite_ref drawn;
+	drawn.sprite = pooled;
+	drawn.texture = texture;
+	entities.add(entity, drawn);
+	entities.add(entity, visibility());
+	return entity;
 }
 
-void AngryBirdsGame::setUpActive()
+/**
+*   @brief   Creates an entity that draws part of a sprite sheet.
+*   @details The sprite loads the sheet's image through the texture
+			 cache, so every entity drawn from the sheet shares it. A
+			 smaller variant of the sheet is used if the region can be
+			 drawn from it at full detail.
+*   @param   atlas The sheet to draw from.
+*   @param   region The name of the image within the sheet.
+*   @param   position The top left of the sprite.
+*   @param   size The width and height to draw the sprite at.
+*   @return  The entity, or -1 if the sheet or region wasn't found.
+*/
+int AngryBirdsGame::spawn(const TextureAtlas& atlas, const std::string& region,
+	const vector2& position, const vector2& size)
 {
-	active_ammo.addSpriteComponent(renderer.get(),
-		".\\Resources\\Textures\\MyAssets\\angeryrock.png");
+	const sub_texture* found = atlas.find(region);
+	if (!found)
+	{
+		return -1;
+	}
 
-	active_ammo_sprite = active_ammo.spriteComponent()->getSprite();
-	active_ammo_sprite->xPos(start_pos.x);
-	active_ammo_sprite->yPos(start_pos.y);
-	active_ammo_sprite->width(42);
-	active_ammo_sprite->height(42);
+	int level = variants.level(files, atlas.imagePath(), *found, size.x, size.y);
+	int entity = spawnSprite(TextureVariants::path(atlas.imagePath(), level), position, size);
+	if (entity < 0)
+	{
+		return -1;
+	}
+
+	SpriteComponent* component = entity_sprites.get(entities.get<sprite_ref>(entity)->sprite);
+	atlas.apply(region, *component->getSprite(), level);
+	return entity;
 }
 
-//Gameplay Functions
-void AngryBirdsGame::preLaunch(float dt_sec)
+/**
+*   @brief   Creates a body for an entity.
+*   @details The body takes its shape from the entity's collider and
+			 is placed at the centre of its transform. Everything else,
+			 such as density or velocity, comes from the definition.
+*   @param   entity The entity the body will move.
+*   @param   def The body's other properties.
+*   @return  void
+*/
+void AngryBirdsGame::addBody(int entity, body_def def)
 {
-	if (bird_grabbed)
+	const transform& placed = *entities.get<transform>(entity);
+	ColliderComponent& collider = *entities.get<ColliderComponent>(entity);
+
+	def.position = vector2(placed.position.x + placed.size.x * 0.5f,
+		placed.position.y + placed.size.y * 0.5f);
+	def.angle = placed.rotation;
+	def.entity = entity;
+	collider.update(def.position, def.angle);
+
+	if (collider.type() == ColliderType::CIRCLE)
+	{
+		def.shape = ShapeType::CIRCLE;
+		def.half_width = collider.radius();
+	}
+	else
 	{
-		active_ammo_sprite->xPos(mouse_x_pos);
-		active_ammo_sprite->yPos(mouse_y_pos);
+		def.shape = ShapeType::POLYGON;
+		def.local_shape = collider.localShape();
 	}
 
+	rigid_body moved;
+	moved.body = world.createBody(def);
+	entities.add(entity, moved);
+
+	motion moving;
+	moving.velocity = def.velocity;
+	entities.add(entity, moving);
+}
 
-	if (bird_in_air)
+//Gameplay Functions
+void AngryBirdsGame::preLaunch()
+{
+	if (bird_grabbed)
 	{
-		fire(dt_sec);
+		entities.get<transform>(active_ammo)->position =
+			vector2(static_cast<float>(mouse_x_pos), static_cast<float>(mouse_y_pos));
 	}
+
 	//Check for slingshot range
 	inputs->getCursorPos(mouse_x_pos, mouse_y_pos);
 	distance = sqrt(pow(start_pos.x - mouse_x_pos, 2) + pow(start_pos.y - mouse_y_pos, 2));
@@ -395,78 +797,236 @@ void AngryBirdsGame::preLaunch(float dt_sec)
 	}
 }
 
-void AngryBirdsGame::fire(float dt_sec)
+/**
+*   @brief   Runs a single fixed step of the simulation.
+*   @details Called by the physics stepper zero or more times a frame.
+			 The contacts are checked after every step so that a frame
+			 taking several steps can't miss any of them.
+*   @param   step_sec The size of the step in seconds.
+*   @return  void
+*/
+void AngryBirdsGame::simulate(float step_sec)
 {
-	bird_grabbed = false;
-	float x_pos = active_ammo_sprite->xPos();
-	float y_pos = active_ammo_sprite->yPos();
+	world.step(step_sec);
 
-	float direction_x = velocity.x *move_speed_x;
-	float direction_y = velocity.y * move_speed_x;
+	entities.each<rigid_body, motion>([this](int, rigid_body& moved, motion& moving)
+	{
+		if (moved.body >= 0)
+		{
+			moving.velocity = world.velocity(moved.body);
+		}
+	});
 
-	x_pos += direction_x * (dt_sec);
-	y_pos += direction_y * (dt_sec);
+	//Handles all collision
+	collision(step_sec);
+}
 
-	velocity.y -= gravity;
-	active_ammo_sprite->xPos(x_pos);
-	active_ammo_sprite->yPos(y_pos);
+/**
+*   @brief   Launches the projectile.
+*   @details The projectile becomes a bullet so it is swept each step,
+			 stopping it passing through thin blocks at full speed.
+*   @return  void
+*/
+void AngryBirdsGame::fire()
+{
+	bird_grabbed = false;
+	bird_in_air = true;
+	flight_time = 0.0f;
+	rest_time = 0.0f;
+
+	world.destroyBody(entities.get<rigid_body>(active_ammo)->body);
+	world.gravity(vector2(0.0f, -gravity * move_speed_y));
+
+	body_def def;
+	def.velocity = vector2(velocity.x * move_speed_x, velocity.y * move_speed_y);
+	def.density = 0.004f;
+	def.restitution = 0.3f;
+	def.bullet = true;
+	addBody(active_ammo, def);
 }
 
-void AngryBirdsGame::collision()
+/**
+*   @brief   Reacts to the contacts from the last step.
+*   @details An enemy is knocked out when the projectile's solid pixels
+			 touch its own, or anything hits it hard enough. The shot is over once the
+			 projectile leaves the screen, comes to rest or has been
+			 flying too long.
+*   @param   step_sec The size of the step in seconds.
+*   @return  void
+*/
+void AngryBirdsGame::collision(float step_sec)
 {
-	active_box = active_ammo.spriteComponent()->getBoundingBox();
+	const float crush_impulse = 150.0f;
+	const float contact_reach = 2.0f;
 
-	if (active_ammo_sprite->yPos() + active_ammo_sprite->height() > 950)
+	for (const contact_report& contact : world.contacts())
 	{
-		reload();
+		int entity_a = world.entity(contact.body_a);
+		int entity_b = world.entity(contact.body_b);
+		if (entity_a < 0 || entity_b < 0)
+		{
+			continue;
+		}
+
+		ObjectType type_a = entities.get<object_kind>(entity_a)->type;
+		ObjectType type_b = entities.get<object_kind>(entity_b)->type;
+		int enemy = type_a == ObjectType::ENEMY ? entity_a :
+			type_b == ObjectType::ENEMY ? entity_b : -1;
+		if (enemy < 0)
+		{
+			continue;
+		}
+
+		int other = enemy == entity_a ? entity_b : entity_a;
+		ObjectType other_type = enemy == entity_a ? type_b : type_a;
+
+		// touching colliders rest a pixel or so apart, so the projectile
+		// is pushed a little towards the enemy before testing pixels
+		float reach = enemy == entity_b ? contact_reach : -contact_reach;
+		vector2 nudge(contact.normal.x * reach, contact.normal.y * reach);
+
+		visibility& shown = *entities.get<visibility>(enemy);
+		if (shown.visible &&
+			((other_type == ObjectType::PROJECTILE && pixelsTouch(other, enemy, nudge)) ||
+			contact.impulse > crush_impulse))
+		{
+			shown.visible = false;
+			rigid_body& moved = *entities.get<rigid_body>(enemy);
+			world.destroyBody(moved.body);
+			moved.body = -1;
+			score += 1000;
+			number_of_enemies--;
+		}
 	}
-	if (active_ammo_sprite->yPos() < 0)
+
+	if (!bird_in_air)
 	{
-		reload();
+		return;
+	}
+
+	flight_time += step_sec;
+
+	vector2 centre = world.position(entities.get<rigid_body>(active_ammo)->body);
+	vector2 speed = entities.get<motion>(active_ammo)->velocity;
+	if (speed.x * speed.x + speed.y * speed.y < 20.0f * 20.0f)
+	{
+		rest_time += step_sec;
 	}
-	if (active_ammo_sprite->xPos() < 0)
+	else
 	{
-		reload();
+		rest_time = 0.0f;
 	}
 
-	if (active_ammo_sprite->xPos() > game_width)
+	if (centre.x < 0 || centre.x > game_width || centre.y > game_height ||
+		rest_time > 0.5f || flight_time > 6.0f)
 	{
 		reload();
 	}
+}
 
-	for (int i = 0; i <= enemy_array_size; i++)
+/**
+*   @brief   Moves every body's entity to match it.
+*   @details The body's last two states are blended by the stepper's
+			 alpha, so motion stays smooth when the frame rate and
+			 step rate differ. Colliders follow their transforms, then
+			 every sprite is moved to its transform in a second pass.
+*   @param   alpha The stepper's blend factor.
+*   @return  void
+*/
+void AngryBirdsGame::syncBodies(float alpha)
+{
+	entities.each<rigid_body, transform, ColliderComponent>([this, alpha](
+		int, rigid_body& moved, transform& placed, ColliderComponent& collider)
 	{
+		if (moved.body < 0)
+		{
+			return;
+		}
+
+		vector2 centre = world.interpolatedPosition(moved.body, alpha);
+		placed.position = vector2(centre.x - placed.size.x * 0.5f, centre.y - placed.size.y * 0.5f);
+		placed.rotation = world.interpolatedAngle(moved.body, alpha);
+		collider.update(centre, placed.rotation);
+	});
 
-		block_box = blocks[i].spriteComponent()->getBoundingBox();
-		if (active_box.isInside(block_box))
+	entities.each<transform, sprite_ref>([this](int, transform& placed, sprite_ref& drawn)
+	{
+		SpriteComponent* component = entity_sprites.get(drawn.sprite);
+		if (component)
 		{
-			reload();
-			break;
+			ASGE::Sprite* sprite = component->getSprite();
+			sprite->xPos(placed.position.x);
+			sprite->yPos(placed.position.y);
+			sprite->rotationInRadians(placed.rotation);
 		}
-	}
+	});
+}
 
-	for (int i = 0; i <= enemy_array_size; i++)
+/**
+*   @brief   Checks whether two entities' solid pixels overlap.
+*   @details Uses where the bodies are now rather than where the sprites
+			 were last drawn. Masks can't turn, so once a non-round
+			 entity has tipped over its collider's contact is trusted.
+*   @param   entity_a The first entity.
+*   @param   entity_b The second entity.
+*   @param   nudge An offset added to the first entity's position.
+*   @return  True if they touch.
+*/
+bool AngryBirdsGame::pixelsTouch(int entity_a, int entity_b, const vector2& nudge)
+{
+	const float upright = 0.1f;
+	const int checked[2] = { entity_a, entity_b };
+	SpriteComponent* sprites[2];
+	vector2 positions[2];
+
+	for (int i = 0; i < 2; i++)
 	{
+		int body = entities.get<rigid_body>(checked[i])->body;
+		ColliderComponent* collider = entities.get<ColliderComponent>(checked[i]);
+		if (body < 0)
+		{
+			return true;
+		}
 
-		enemy_box = enemies[i].spriteComponent()->getBoundingBox();
-		if (active_box.isInside(enemy_box) && enemies[i].visibility == true)
+		if (collider && collider->type() != ColliderType::CIRCLE &&
+			fabsf(world.angle(body)) > upright)
 		{
-			enemies[i].visibility = false;
-			score += 1000;
-			number_of_enemies--;
-			reload();
-			break;
+			return true;
+		}
+
+		const transform& placed = *entities.get<transform>(checked[i]);
+		vector2 centre = world.position(body);
+		positions[i] = vector2(centre.x - placed.size.x * 0.5f, centre.y - placed.size.y * 0.5f);
+		sprites[i] = entity_sprites.get(entities.get<sprite_ref>(checked[i])->sprite);
+		if (!sprites[i])
+		{
+			return true;
 		}
 	}
+
+	positions[0].x += nudge.x;
+	positions[0].y += nudge.y;
+	return pixel_masks.overlaps(*sprites[0]->getSprite(), positions[0],
+		*sprites[1]->getSprite(), positions[1]);
 }
 
 void AngryBirdsGame::reload()
 {
-	active_ammo_sprite->xPos(start_pos.x);
-	active_ammo_sprite->yPos(start_pos.y);
+	rigid_body& moved = *entities.get<rigid_body>(active_ammo);
+	world.destroyBody(moved.body);
+	moved.body = -1;
+
+	transform& placed = *entities.get<transform>(active_ammo);
+	placed.position = start_pos;
+	placed.rotation = 0.0f;
+	entities.get<motion>(active_ammo)->velocity = vector2(0, 0);
 	velocity.x = 0;
 	velocity.y = 0;
 	ammo_array_size--;
+	if (ammo_array_size >= 0 && ammo[ammo_array_size] >= 0)
+	{
+		entities.get<visibility>(ammo[ammo_array_size])->visible = false;
+	}
 	move_speed_x = 5.0;
 	move_speed_y = 5.0;
 	bird_in_air = false;
@@ -486,54 +1046,38 @@ void AngryBirdsGame::gameState()
 }
 
 //UI Functions
-void AngryBirdsGame::howToPlayUI()
+void AngryBirdsGame::howToPlayUI(FrameSnapshot& frame)
 {
-	renderer->renderText("HOW TO PLAY", 50, 100, ASGE::COLOURS::BLUE);
-	renderer->renderText("Use the mouse to aim the rocks in the slingshot.", 60, 150, ASGE::COLOURS::BLACK);
-	renderer->renderText("Try to hit the aliens using the rocks to win the level, complete it in the least number of rocks to earn the most points.", 60, 175, ASGE::COLOURS::BLACK);
+	frame.addText("HOW TO PLAY", 50, 100, ASGE::COLOURS::BLUE);
+	frame.addText("Use the mouse to aim the rocks in the slingshot.", 60, 150, ASGE::COLOURS::BLACK);
+	frame.addText("Try to hit the aliens using the rocks to win the level, complete it in the least number of rocks to earn the most points.", 60, 175, ASGE::COLOURS::BLACK);
 
-	renderer->renderText("Press Space to continue", game_width / 2 - 60, 500, ASGE::COLOURS::BLACK);
+	frame.addText("Press Space to continue", game_width / 2 - 60, 500, ASGE::COLOURS::BLACK);
 }
 
-void AngryBirdsGame::inGameUI()
+void AngryBirdsGame::inGameUI(FrameSnapshot& frame)
 {
 	std::string score_str = "Score: " + std::to_string(score);
-	renderer->renderText(score_str.c_str(), 50, 100, ASGE::COLOURS::BLUE);
-	if (active_ammo.visibility == true)
-	{
-		renderer->renderSprite(*active_ammo.spriteComponent()->getSprite());
-	}
-
-	renderer->renderSprite(*slingshot.spriteComponent()->getSprite());
-
-	for (int i = 0; i < ammo_array_size; i++)
-	{
-		renderer->renderSprite(*ammo[i].spriteComponent()->getSprite());
-	}
-
-	for (int i = 0; i < block_array_size; i++)
-	{
-			renderer->renderSprite(*blocks[i].spriteComponent()->getSprite());
-
-	}
+	frame.addText(score_str, 50, 100, ASGE::COLOURS::BLUE);
 
-	for (int i = 0; i < enemy_array_size; i++)
+	// the projectile waits behind the slingshot, so the slingshot is in
+	// front of the world, which the entities share in whatever order
+	// the frame groups their textures
+	entities.each<sprite_ref, visibility>([this, &frame](int, sprite_ref& drawn, visibility& shown)
 	{
-		if (enemies[i].visibility == true)
+		SpriteComponent* component = entity_sprites.get(drawn.sprite);
+		if (shown.visible && component)
 		{
-			renderer->renderSprite(*enemies[i].spriteComponent()->getSprite());
+			frame.addSprite(*component->getSprite(), DrawLayer::WORLD);
 		}
-	}
-}
+	});
 
-void AngryBirdsGame::winUI()
-{
-	renderer->renderSprite(*win_sprite.spriteComponent()->getSprite());
+	addObject(frame, slingshot, DrawLayer::FOREGROUND);
 }
 
-void AngryBirdsGame::loseUI()
+void AngryBirdsGame::loseUI(FrameSnapshot& frame)
 {
-	renderer->renderSprite(*lose_sprite.spriteComponent()->getSprite());
-	renderer->renderText("Press SPACE to restart", 100, 200, ASGE::COLOURS::BLACK);
+	addObject(frame, lose_sprite, DrawLayer::OVERLAY);
+	frame.addText("Press SPACE to restart", 100, 200, ASGE::COLOURS::BLACK);
 }
 
@@ -1,21 +1,47 @@
 #pragma once
 #include <string>
-#include <Engine/OGLGame.h>
+#include <vector>
 
+#if defined(ASGE_HEADLESS)
+#include "HeadlessGame.h"
+using GamePlatform = HeadlessGame;
+#else
+#include <Engine/OGLGame.h>
+using GamePlatform = ASGE::OGLGame;
+#endif
+
+#include "AssetLoader.h"
+#include "Components.h"
+#include "DecodedTextureCache.h"
+#include "FrameSnapshot.h"
+#include "EntityStore.h"
+#include "FileSystem.h"
 #include "GameObject.h"
+#include "PhysicsStepper.h"
+#include "PhysicsWorld.h"
+#include "PixelMask.h"
+#include "Pool.h"
 #include "Rect.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "TextureVariants.h"
+#include "ThreadPool.h"
+#include "TripleBuffer.h"
 
 
 /**
 *  An OpenGL Game based on ASGE.
+*  Headless builds run it on the null renderer instead.
 */
 class AngryBirdsGame :
-	public ASGE::OGLGame
+	public GamePlatform
 {
 public:
 	AngryBirdsGame();
 	~AngryBirdsGame();
 	virtual bool init() override;
+	bool levelLoaded() const;
+	void settleAssets();
 	
 
 private:
@@ -23,22 +49,34 @@ private:
 	void keyHandler(const ASGE::SharedEventData data);
 	void clickHandler(const ASGE::SharedEventData data);
 	void setupResolution();
-	bool loadBackgrounds();
+	void loadBackgrounds();
 	void setUpGameobjects();
 	void setUpActive();
+	bool loadAtlases();
+	void requestAssets();
+	handle requestTexture(const std::string& texture_file_name);
+	std::string texturePath(const std::string& texture_file_name);
+	bool buildLevel();
+	int  spawn(const std::string& texture_file_name, const vector2& position, const vector2& size);
+	int  spawn(const TextureAtlas& atlas, const std::string& region, const vector2& position, const vector2& size);
+	int  spawnSprite(const std::string& texture_file_name, const vector2& position, const vector2& size);
+	void addBody(int entity, body_def def);
 
 	//Game Functions
-	void preLaunch(float dt_sec);
-	void fire(float dt_sec);
-	void collision();
+	void preLaunch();
+	void simulate(float step_sec);
+	void fire();
+	void collision(float step_sec);
+	void syncBodies(float alpha);
+	bool pixelsTouch(int entity_a, int entity_b, const vector2& nudge);
 	void reload();
 	void gameState();
 
 	//UI Functions
-	void howToPlayUI();
-	void inGameUI();
-	void winUI();
-	void loseUI();
+	void recordFrame(FrameSnapshot& frame);
+	void howToPlayUI(FrameSnapshot& frame);
+	void inGameUI(FrameSnapshot& frame);
+	void loseUI(FrameSnapshot& frame);
 	
 
 	virtual void update(const ASGE::GameTime &) override;
@@ -59,7 +97,9 @@ private:
 	vector2 velocity = { 0,0 };
 	float move_speed_x = 7.0;
 	float move_speed_y = 7.0;
-	float gravity = -0.1;
+	float gravity = -6.0;               /**< Scaled by move_speed_y to give the world's gravity. */
+	float flight_time = 0.0f;           /**< Seconds since the projectile was launched. */
+	float rest_time = 0.0f;             /**< Seconds the projectile has been almost still. */
 	int game_state = 0;
 
 	//Add your GameObjects
@@ -69,26 +109,40 @@ private:
 	GameObject win_sprite;
 	GameObject slingshot;
 
-	GameObject enemies[3];
+	//Gameplay entities, rebuilt on every restart
+	EntityStore entities;
+	FileSystem files;   /**< Declared before the atlases, which point into its packs. */
+	TextureCache textures;
+	DecodedTextureCache decoded_textures;
+	TextureVariants variants;
+	AssetLoader assets { files, decoded_textures };   /**< Declared last of the three, so it stops first. */
+	std::vector<handle> level_assets;   /**< Requests the level waits for before it's built. */
+	bool level_built = false;
+	std::string background_file;        /**< The background showing, picked at random. */
+	std::string next_background_file;   /**< The background prefetched for the next restart. */
+	handle next_background;
+	TextureAtlas wood_atlas;
+	TextureAtlas alien_atlas;
+	Pool<SpriteComponent, 16> entity_sprites;   /**< Sprites entities draw, recycled on restart. */
+	TripleBuffer<FrameSnapshot> frames; /**< Recorded by update, drawn by render. */
+
 	int enemy_array_size = 3;
-	ASGE::Sprite* enemy_sprite = nullptr;
-	rect enemy_box;
 	int number_of_enemies = enemy_array_size;
-	
-	GameObject blocks[3];
 	int block_array_size = 3;
-	ASGE::Sprite* block_sprite = nullptr;
-	rect block_box;
-
 
-	GameObject ammo[5];
+	int ammo[5];                        /**< Entities showing the shots left. */
 	int ammo_array_size = 5;
-	ASGE::Sprite* ammo_sprite = nullptr;
 
-	GameObject active_ammo;
-	ASGE::Sprite* active_ammo_sprite = nullptr;
+	int active_ammo = -1;               /**< Entity of the projectile. */
+	handle active_ammo_sprite;
 	rect active_box;
 
+	PhysicsStepper physics_stepper = { 1.0 / 120.0, 8 };
+	ThreadPool thread_pool;
+	PhysicsWorld world;
+	int ground_body = -1;
+	PixelMaskCache pixel_masks;
+
 	double mouse_x_pos, mouse_y_pos;
 
 };
\ No newline at end of file
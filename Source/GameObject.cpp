@@ -1,23 +1,30 @@
-#include <Engine\Renderer.h>
+#include <Engine/Renderer.h>
 #include "GameObject.h"
 
 GameObject::~GameObject()
 {
 	freeSpriteComponent();
+	freeColliderComponent();
 }
 
 bool GameObject::addSpriteComponent(
 	ASGE::Renderer* renderer, const std::string& texture_file_name)
 {
-	freeSpriteComponent();
+	if (!sprite_component)
+	{
+		sprite_component = new SpriteComponent();
+	}
 
-	sprite_component = new SpriteComponent();
 	if (sprite_component->loadSprite(renderer, texture_file_name))
 	{
 		return true;
 	}
 
-	freeSpriteComponent();
+	// a failed load keeps the sprite the component already had
+	if (!sprite_component->getSprite())
+	{
+		freeSpriteComponent();
+	}
 	return false;
 }
 
@@ -33,3 +40,21 @@ SpriteComponent* GameObject::spriteComponent()
 	return sprite_component;
 }
 
+ColliderComponent* GameObject::addColliderComponent()
+{
+	freeColliderComponent();
+	collider_component = new ColliderComponent();
+	return collider_component;
+}
+
+void GameObject::freeColliderComponent()
+{
+	delete collider_component;
+	collider_component = nullptr;
+}
+
+ColliderComponent* GameObject::colliderComponent()
+{
+	return collider_component;
+}
+
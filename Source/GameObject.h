@@ -1,14 +1,16 @@
 #pragma once
 #include <string>
+#include "ColliderComponent.h"
 #include "SpriteComponent.h"
 #include "Vector2.h"
 
 /**
 *  Objects used throughout the game.
 *  Provides a nice solid base class for objects in this game world.
-*  They currently support only sprite components, but this could easily
-*  be extended to include things like rigid bodies or input systems. 
+*  They currently support sprite and collider components, but this could
+*  easily be extended to include things like rigid bodies or input systems. 
 *  @see SpriteComponent
+*  @see ColliderComponent
 */
 class GameObject
 {
@@ -25,9 +27,11 @@ public:
 
 	/**
 	*  Allocates and attaches a sprite component to the object. 
+	*  An existing component is reused, so calling this again to
+	*  reset the object doesn't allocate.
 	*  Part of this process will attempt to load a texture file.
 	*  If this fails this function will return false and the memory
-	*  allocated, freed. 
+	*  allocated, freed, keeping any sprite the object already had.
 	*  @param [in] renderer The renderer used to perform the allocations
 	*  @param [in] texture_file_name The file path to the the texture to load
 	*  @return true if the component is successfully added
@@ -41,11 +45,28 @@ public:
 	*  @return a pointer to the objects sprite component (if any)
 	*/
 	 SpriteComponent* spriteComponent();
+
+	/**
+	*  Allocates and attaches a collider component to the object.
+	*  Any existing collider is replaced. The collider starts as a box
+	*  and should be given its shape by the caller.
+	*  @return a pointer to the new collider
+	*/
+	 ColliderComponent* addColliderComponent();
+
+	/**
+	*  Returns the collider component.
+	*  @return a pointer to the objects collider component (if any)
+	*/
+	 ColliderComponent* colliderComponent();
+
 	 bool visibility = true;
 
 private:
 
 	void freeSpriteComponent();	
+	void freeColliderComponent();
 	SpriteComponent* sprite_component = nullptr;
+	ColliderComponent* collider_component = nullptr;
 	
 };
\ No newline at end of file
@@ -0,0 +1,191 @@
+#if defined(ASGE_HEADLESS)
+
+#include <chrono>
+#include <string>
+#include <Engine/Game.h>
+#include <Engine/Input.h>
+#include <Engine/Renderer.h>
+#include <Engine/Sprite.h>
+
+/**
+*  The engine's own code, for builds without the engine library.
+*  The ASGE library is only built for Windows and pulls in OpenGL, so
+*  headless builds compile this in its place. It covers the members
+*  the headers declare but don't define, behaving as the library does
+*  as far as the game can tell. Input events are always sent on the
+*  calling thread.
+*/
+
+namespace
+{
+	using clock_type = std::chrono::steady_clock;
+
+	clock_type::time_point fps_start = clock_type::now();
+	int fps_frames = 0;
+	int fps_shown = 0;
+}
+
+namespace ASGE
+{
+	float Sprite::xPos() const noexcept { return position[0]; }
+	void  Sprite::xPos(float x) noexcept { position[0] = x; }
+	float Sprite::yPos() const noexcept { return position[1]; }
+	void  Sprite::yPos(float y) noexcept { position[1] = y; }
+	float Sprite::width() const noexcept { return dims[0]; }
+	void  Sprite::width(float width) noexcept { dims[0] = width; }
+	float Sprite::height() const noexcept { return dims[1]; }
+	void  Sprite::height(float height) noexcept { dims[1] = height; }
+
+	void Sprite::dimensions(float& width, float& height) const noexcept
+	{
+		width = dims[0];
+		height = dims[1];
+	}
+
+	float Sprite::rotationInRadians() const noexcept { return angle; }
+	void  Sprite::rotationInRadians(float rotation_radians) { angle = rotation_radians; }
+	float Sprite::scale() const noexcept { return scale_factor; }
+	void  Sprite::scale(float scale_value) noexcept { scale_factor = scale_value; }
+	Colour Sprite::colour() const noexcept { return tint; }
+	void  Sprite::colour(ASGE::Colour sprite_colour) noexcept { tint = sprite_colour; }
+	bool  Sprite::isFlippedOnX() const noexcept { return (flip_flags & FLIP_X) != 0; }
+	bool  Sprite::isFlippedOnY() const noexcept { return (flip_flags & FLIP_Y) != 0; }
+	void  Sprite::setFlipFlags(FlipFlags flags) noexcept { flip_flags = flags; }
+	void  Sprite::opacity(float alpha) noexcept { this->alpha = alpha; }
+	float Sprite::opacity() const noexcept { return alpha; }
+	float* Sprite::srcRect() noexcept { return src_rect; }
+	const float* Sprite::srcRect() const noexcept { return src_rect; }
+
+	Renderer::RenderLib Renderer::getRenderLibrary() noexcept
+	{
+		return lib;
+	}
+
+	Renderer::WindowMode Renderer::getWindowMode() noexcept
+	{
+		return window_mode;
+	}
+
+	void Renderer::renderText(const std::string str, int x, int y, float scale, const Colour& colour)
+	{
+		renderText(str, x, y, scale, colour, 0.0f);
+	}
+
+	void Renderer::renderText(const std::string str, int x, int y, const Colour& colour)
+	{
+		renderText(str, x, y, 1.0f, colour, 0.0f);
+	}
+
+	void Renderer::renderText(const std::string str, int x, int y)
+	{
+		renderText(str, x, y, 1.0f, default_text_colour, 0.0f);
+	}
+
+	void Renderer::renderSprite(const Sprite& sprite)
+	{
+		renderSprite(sprite, 0.0f);
+	}
+
+	Input::Input() = default;
+
+	Input::~Input()
+	{
+		callback_funcs.clear();
+	}
+
+	void Input::sendEvent(EventType type, SharedEventData data)
+	{
+		for (const InputFncPair& callback : callback_funcs)
+		{
+			if (callback.first == type && callback.second)
+			{
+				callback.second(data);
+			}
+		}
+	}
+
+	/**
+	*   @brief   Registers a callback.
+	*   @details Handles are indices into the list, so a removed
+	             callback leaves an empty function behind rather than
+				 moving the ones after it.
+	*   @return  The callback's handle.
+	*/
+	int Input::registerCallback(EventType type, InputFnc fnc)
+	{
+		callback_funcs.push_back(InputFncPair(type, fnc));
+		return static_cast<int>(callback_funcs.size()) - 1;
+	}
+
+	void Input::unregisterCallback(unsigned int id)
+	{
+		if (id < callback_funcs.size())
+		{
+			callback_funcs[id].second = nullptr;
+		}
+	}
+
+	/**
+	*   @brief   Runs the game in real time until it exits.
+	*   @details Each frame is stepped by the time since the last.
+	*   @return  The exit code.
+	*/
+	int Game::run()
+	{
+		us.frame_time = clock_type::now();
+		while (!exit)
+		{
+			const clock_type::time_point now = clock_type::now();
+			us.delta_time = now - us.frame_time;
+			us.frame_time = now;
+			us.game_time = getGameTime();
+
+			inputs->update();
+			update(us);
+			beginFrame();
+			render(us);
+			endFrame();
+		}
+
+		exitAPI();
+		return 0;
+	}
+
+	void Game::signalExit() noexcept
+	{
+		exit = true;
+	}
+
+	void Game::toggleFPS() noexcept
+	{
+		show_fps = !show_fps;
+	}
+
+	/**
+	*   @brief   Updates and draws the FPS counter.
+	*   @details The count shown is the frames finished in the last
+	             whole second of wall time.
+	*   @return  void
+	*/
+	void Game::updateFPS()
+	{
+		fps_frames++;
+		const clock_type::time_point now = clock_type::now();
+		if (now - fps_start >= std::chrono::seconds(1))
+		{
+			fps_shown = fps_frames;
+			fps_frames = 0;
+			fps_start = now;
+		}
+
+		renderer->renderText("FPS: " + std::to_string(fps_shown), 1, 20, COLOURS::YELLOWGREEN);
+	}
+
+	std::chrono::milliseconds Game::getGameTime() noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(
+			clock_type::now().time_since_epoch());
+	}
+}
+
+#endif
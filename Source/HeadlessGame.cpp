@@ -0,0 +1,176 @@
+#if defined(ASGE_HEADLESS)
+
+#include <math.h>
+#include <thread>
+#include "HeadlessGame.h"
+#include "NullRenderer.h"
+#include "SoftwareRenderer.h"
+
+bool HeadlessGame::initAPI(ASGE::Renderer::WindowMode mode)
+{
+	software = draw_frames ? new SoftwareRenderer(drawing_pool) : nullptr;
+	renderer.reset(software ? software : new NullRenderer);
+
+	if (!renderer->init(game_width, game_height, mode))
+	{
+		return false;
+	}
+
+	inputs = renderer->inputPtr();
+	return inputs->init(renderer.get());
+}
+
+bool HeadlessGame::exitAPI() noexcept
+{
+	return !renderer || renderer->exit();
+}
+
+void HeadlessGame::beginFrame()
+{
+	renderer->preRender();
+}
+
+/**
+*   @brief   Ends the frame.
+*   @details The OpenGL game draws its FPS counter here, so the
+             null renderer is given the same text to count.
+*   @return  void
+*/
+void HeadlessGame::endFrame()
+{
+	if (show_fps)
+	{
+		updateFPS();
+	}
+
+	renderer->postRender();
+	renderer->swapBuffers();
+}
+
+/**
+*   @brief   Runs frames with a fixed step.
+*   @details Each frame polls the input, then updates and renders the
+             game as the real time loop does. Game time is kept to the
+			 nearest millisecond of the summed steps. With a render
+			 thread, it's started for the run and told of each update
+			 instead, and the run waits for it to draw the last.
+*   @return  The number of frames run.
+*/
+int HeadlessGame::runFrames(int frames, double step_ms)
+{
+	std::thread drawing;
+	if (render_thread)
+	{
+		rendering.store(true, std::memory_order_relaxed);
+		drawing = std::thread(&HeadlessGame::renderLoop, this, frames_updated.load(std::memory_order_relaxed));
+	}
+
+	int run = 0;
+	for (; run < frames && !exit; run++)
+	{
+		fixed_ms += step_ms;
+		fixed_time.delta_time = std::chrono::duration<double, std::milli>(step_ms);
+		fixed_time.game_time = std::chrono::milliseconds(llround(fixed_ms));
+		fixed_time.frame_time += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			fixed_time.delta_time);
+
+		inputs->update();
+		update(fixed_time);
+		if (drawing.joinable())
+		{
+			frames_updated.fetch_add(1, std::memory_order_release);
+			continue;
+		}
+
+		beginFrame();
+		render(fixed_time);
+		endFrame();
+	}
+
+	if (drawing.joinable())
+	{
+		rendering.store(false, std::memory_order_release);
+		drawing.join();
+	}
+	return run;
+}
+
+void HeadlessGame::renderOnThread(bool threaded)
+{
+	render_thread = threaded;
+}
+
+void HeadlessGame::drawFrames(bool draw)
+{
+	draw_frames = draw;
+}
+
+void HeadlessGame::threadPool(ThreadPool* pool)
+{
+	drawing_pool = pool;
+}
+
+NullRenderer* HeadlessGame::nullRenderer() const
+{
+	return static_cast<NullRenderer*>(renderer.get());
+}
+
+SoftwareRenderer* HeadlessGame::softwareRenderer() const
+{
+	return software;
+}
+
+NullInput* HeadlessGame::nullInput() const
+{
+	return static_cast<NullInput*>(inputs.get());
+}
+
+bool HeadlessGame::exiting() const
+{
+	return exit;
+}
+
+/**
+*   @brief   Draws frames as they're updated, until told to stop.
+*   @details Updates are counted from the number there were when the
+             thread was started, as the first may beat it. Only the
+			 latest update is drawn, however many went by since the
+			 last was, and the thread yields while there's none.
+			 Whether to stop is read before the updates, so the last
+			 update is always drawn before the thread returns. Frames
+			 are drawn with the time they were drawn at, as fixed_time
+			 belongs to the updating thread.
+*   @return  void
+*/
+void HeadlessGame::renderLoop(uint64_t drawn)
+{
+	ASGE::GameTime now;
+	now.frame_time = std::chrono::steady_clock::now();
+
+	for (;;)
+	{
+		const bool stopping = !rendering.load(std::memory_order_acquire);
+		const uint64_t updated = frames_updated.load(std::memory_order_acquire);
+		if (updated != drawn)
+		{
+			drawn = updated;
+
+			const auto frame_time = std::chrono::steady_clock::now();
+			now.delta_time = frame_time - now.frame_time;
+			now.frame_time = frame_time;
+			beginFrame();
+			render(now);
+			endFrame();
+		}
+		else if (stopping)
+		{
+			return;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,124 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+#include <Engine/Game.h>
+
+class NullInput;
+class NullRenderer;
+class SoftwareRenderer;
+class ThreadPool;
+
+/**
+*  A Game run without a window.
+*  Stands in for OGLGame, creating a NullRenderer and NullInput
+*  rather than an OpenGL context, or a SoftwareRenderer if frames are
+*  to be drawn. Besides the usual real time loop,
+*  frames can be run with a fixed step as fast as the game can go,
+*  so a run does the same work whatever the machine. Those frames can
+*  be drawn on a thread of their own, overlapping the next update.
+*/
+class HeadlessGame :
+	public ASGE::Game
+{
+public:
+
+	virtual ~HeadlessGame() = default;
+
+	/**
+	*  Creates the null renderer and input.
+	*  @return True if successful.
+	*/
+	virtual bool initAPI(ASGE::Renderer::WindowMode mode =
+		ASGE::Renderer::WindowMode::WINDOWED) override final;
+
+	/**
+	*  Closes the null renderer. The renderer and input are kept, as
+	*  the game's destructor still unregisters its callbacks.
+	*  @return True if managed gracefully.
+	*/
+	virtual bool exitAPI() noexcept override final;
+
+	/**
+	*  Starts the renderer's frame.
+	*/
+	virtual void beginFrame() override final;
+
+	/**
+	*  Counts the FPS text if shown, then ends and presents the frame.
+	*/
+	virtual void endFrame() override final;
+
+	/**
+	*  Runs frames with a fixed step, as fast as they can be run.
+	*  Game time carries on from the last call, so a script can run a
+	*  few frames, queue some input and carry on. On a render thread,
+	*  the last frame updated has been drawn by the time this returns,
+	*  though frames updated faster than they could be drawn are
+	*  skipped.
+	*  @param [in] frames The number of frames to run
+	*  @param [in] step_ms The time each frame steps the game by
+	*  @return the number of frames run, fewer if the game exited
+	*/
+	int  runFrames(int frames, double step_ms = 1000.0 / 60.0);
+
+	/**
+	*  Chooses whether runFrames draws on a thread of its own, while
+	*  the next frame is updated. The game must record everything it
+	*  draws during update, leaving render only to draw the latest
+	*  frame recorded, as render is then called on the other thread.
+	*  @param [in] threaded True to draw on a render thread
+	*/
+	void renderOnThread(bool threaded);
+
+	/**
+	*  Chooses whether frames are drawn. Only takes effect if called
+	*  before the game initialises.
+	*  @param [in] draw True to draw frames on the CPU, false to only
+	*  count what would be drawn
+	*/
+	void drawFrames(bool draw);
+
+	/**
+	*  Sets the thread pool frames are drawn across, shared with the
+	*  game's other work. Only takes effect if called before the game
+	*  initialises.
+	*  @param [in] pool The pool to use, or null to draw on one thread
+	*/
+	void threadPool(ThreadPool* pool);
+
+	/**
+	*  Returns the renderer, to read its counts.
+	*  @return the null renderer, or null before initAPI
+	*/
+	NullRenderer* nullRenderer() const;
+
+	/**
+	*  Returns the renderer drawing frames, to read its framebuffer.
+	*  @return the software renderer, or null if frames aren't drawn
+	*/
+	SoftwareRenderer* softwareRenderer() const;
+
+	/**
+	*  Returns the input, to queue events for the game.
+	*  @return the null input, or null before initAPI
+	*/
+	NullInput* nullInput() const;
+
+	/**
+	*  Returns whether the game has asked to exit.
+	*  @return true once signalExit has been called
+	*/
+	bool exiting() const;
+
+private:
+	void renderLoop(uint64_t drawn);
+
+	ASGE::GameTime fixed_time;
+	double fixed_ms = 0.0;
+	SoftwareRenderer* software = nullptr;   // owned by renderer
+	ThreadPool* drawing_pool = nullptr;
+	bool draw_frames = false;
+	bool render_thread = false;
+	std::atomic<bool> rendering { false };          // the render thread is to keep going
+	std::atomic<uint64_t> frames_updated { 0 };     // updates the render thread has to draw
+};
@@ -0,0 +1,224 @@
+#if defined(ASGE_HEADLESS)
+
+#include <algorithm>
+#include <math.h>
+
+#include "ImageDiff.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGE_DIFF_SSE2
+#endif
+
+namespace
+{
+	// the weighted YIQ distance between black and white
+	const float MAX_DELTA = 35215.0f;
+	const float INV_255 = 1.0f / 255.0f;
+
+	// how much of the expected image shows through the heatmap
+	const float HEATMAP_FADE = 0.1f;
+
+	float overWhite(uint8_t channel, float alpha)
+	{
+		return (channel - 255.0f) * alpha + 255.0f;
+	}
+
+	float luma(float r, float g, float b)
+	{
+		return r * 0.29889531f + g * 0.58662247f + b * 0.11448223f;
+	}
+
+	/**
+	*   @brief   Measures how far apart two pixels look.
+	*   @details YIQ is linear in RGB, so the difference in each channel
+	             is converted rather than both colours.
+	*   @return  The weighted squared distance, 0 to MAX_DELTA.
+	*/
+	float pixelDelta(const uint8_t* expected, const uint8_t* actual)
+	{
+		const float expected_alpha = expected[3] * INV_255;
+		const float actual_alpha = actual[3] * INV_255;
+		const float r = overWhite(expected[0], expected_alpha) - overWhite(actual[0], actual_alpha);
+		const float g = overWhite(expected[1], expected_alpha) - overWhite(actual[1], actual_alpha);
+		const float b = overWhite(expected[2], expected_alpha) - overWhite(actual[2], actual_alpha);
+
+		const float y = luma(r, g, b);
+		const float i = r * 0.59597799f - g * 0.27417610f - b * 0.32180189f;
+		const float q = r * 0.21147017f - g * 0.52261711f + b * 0.31114694f;
+		return 0.5053f * y * y + 0.299f * i * i + 0.1957f * q * q;
+	}
+
+#if defined(IMAGE_DIFF_SSE2)
+	/**
+	*   @brief   Splits four RGBA pixels into a vector for each channel.
+	*   @return  void
+	*/
+	void loadChannels(const uint8_t* pixels, __m128 channels[4])
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+		const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+		const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+
+		channels[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero));
+		channels[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero));
+		channels[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero));
+		channels[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero));
+		_MM_TRANSPOSE4_PS(channels[0], channels[1], channels[2], channels[3]);
+
+		const __m128 white = _mm_set1_ps(255.0f);
+		const __m128 alpha = _mm_mul_ps(channels[3], _mm_set1_ps(INV_255));
+		for (int c = 0; c < 3; c++)
+		{
+			channels[c] = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(channels[c], white), alpha), white);
+		}
+	}
+
+	__m128 weigh(__m128 r, __m128 g, __m128 b, float wr, float wg, float wb)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(wr)), _mm_mul_ps(g, _mm_set1_ps(wg))),
+			_mm_mul_ps(b, _mm_set1_ps(wb)));
+	}
+
+	/**
+	*   @brief   Measures four pixels at once, as pixelDelta does.
+	*   @return  The four weighted squared distances.
+	*/
+	__m128 pixelDeltas(const uint8_t* expected, const uint8_t* actual)
+	{
+		__m128 wanted[4];
+		__m128 got[4];
+		loadChannels(expected, wanted);
+		loadChannels(actual, got);
+
+		const __m128 r = _mm_sub_ps(wanted[0], got[0]);
+		const __m128 g = _mm_sub_ps(wanted[1], got[1]);
+		const __m128 b = _mm_sub_ps(wanted[2], got[2]);
+
+		const __m128 y = weigh(r, g, b, 0.29889531f, 0.58662247f, 0.11448223f);
+		const __m128 i = weigh(r, g, b, 0.59597799f, -0.27417610f, -0.32180189f);
+		const __m128 q = weigh(r, g, b, 0.21147017f, -0.52261711f, 0.31114694f);
+		return _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(0.5053f), _mm_mul_ps(y, y)),
+			_mm_mul_ps(_mm_set1_ps(0.299f), _mm_mul_ps(i, i))),
+			_mm_mul_ps(_mm_set1_ps(0.1957f), _mm_mul_ps(q, q)));
+	}
+#endif
+
+	/**
+	*   @brief   Draws a row of the heatmap.
+	*   @details Pixels within the threshold are the expected image in
+	             faint grey. The rest are red, from dull just past the
+				 threshold to full for black against white.
+	*   @return  void
+	*/
+	void drawHeatmapRow(const uint8_t* expected, const float* distances, float threshold,
+		uint8_t* heatmap, int width)
+	{
+		for (int x = 0; x < width; x++, expected += 4, heatmap += 4)
+		{
+			if (distances[x] > threshold)
+			{
+				const float strength = threshold < 1.0f ? (distances[x] - threshold) / (1.0f - threshold) : 1.0f;
+				heatmap[0] = static_cast<uint8_t>(160.0f + 95.0f * std::min(strength, 1.0f) + 0.5f);
+				heatmap[1] = 0;
+				heatmap[2] = 0;
+			}
+			else
+			{
+				const float alpha = expected[3] * INV_255;
+				const float grey = luma(overWhite(expected[0], alpha), overWhite(expected[1], alpha),
+					overWhite(expected[2], alpha));
+				const uint8_t faded = static_cast<uint8_t>((grey - 255.0f) * HEATMAP_FADE + 255.0f + 0.5f);
+				heatmap[0] = faded;
+				heatmap[1] = faded;
+				heatmap[2] = faded;
+			}
+			heatmap[3] = 255;
+		}
+	}
+}
+
+/**
+*   @brief   Compares two images the way they look.
+*   @details Each row is measured into a row of distances, which are
+             then counted and, if asked for, drawn. The sum is kept
+			 per row in double precision, so the mean holds up over
+			 large frames.
+*   @return  False if the images aren't the same size.
+*/
+bool diffImages(const image& expected, const image& actual, float threshold,
+	image_difference& difference, image* heatmap)
+{
+	difference = image_difference();
+	if (expected.width != actual.width || expected.height != actual.height ||
+		expected.pixels.size() < static_cast<size_t>(expected.width) * expected.height * 4 ||
+		actual.pixels.size() < static_cast<size_t>(actual.width) * actual.height * 4)
+	{
+		return false;
+	}
+
+	const int width = expected.width;
+	const int height = expected.height;
+	if (heatmap)
+	{
+		heatmap->width = width;
+		heatmap->height = height;
+		heatmap->pixels.resize(static_cast<size_t>(width) * height * 4);
+	}
+
+	threshold = std::max(threshold, 0.0f);
+	std::vector<float> distances(width);
+	double total = 0.0;
+	for (int y = 0; y < height; y++)
+	{
+		const size_t row = static_cast<size_t>(y) * width * 4;
+		const uint8_t* wanted = expected.pixels.data() + row;
+		const uint8_t* got = actual.pixels.data() + row;
+
+		int x = 0;
+		float row_total = 0.0f;
+#if defined(IMAGE_DIFF_SSE2)
+		const __m128 limit = _mm_set1_ps(threshold);
+		const __m128 scale = _mm_set1_ps(1.0f / MAX_DELTA);
+		__m128 totals = _mm_setzero_ps();
+		__m128 largest = _mm_setzero_ps();
+		for (; x + 4 <= width; x += 4)
+		{
+			const __m128 distance = _mm_sqrt_ps(_mm_mul_ps(pixelDeltas(wanted + x * 4, got + x * 4), scale));
+			_mm_storeu_ps(distances.data() + x, distance);
+
+			const int over = _mm_movemask_ps(_mm_cmpgt_ps(distance, limit));
+			difference.differing += (over & 1) + (over >> 1 & 1) + (over >> 2 & 1) + (over >> 3 & 1);
+			totals = _mm_add_ps(totals, distance);
+			largest = _mm_max_ps(largest, distance);
+		}
+
+		float lanes[4];
+		_mm_storeu_ps(lanes, totals);
+		row_total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		_mm_storeu_ps(lanes, largest);
+		difference.largest = std::max(difference.largest, std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3])));
+#endif
+		for (; x < width; x++)
+		{
+			const float distance = sqrtf(pixelDelta(wanted + x * 4, got + x * 4) * (1.0f / MAX_DELTA));
+			distances[x] = distance;
+			difference.differing += distance > threshold ? 1 : 0;
+			row_total += distance;
+			difference.largest = std::max(difference.largest, distance);
+		}
+
+		total += row_total;
+		if (heatmap)
+		{
+			drawHeatmapRow(wanted, distances.data(), threshold, heatmap->pixels.data() + row, width);
+		}
+	}
+
+	difference.mean = width > 0 && height > 0 ? static_cast<float>(total / (static_cast<double>(width) * height)) : 0.0f;
+	return true;
+}
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+#include "Png.h"
+
+/**
+*  How far apart two images are.
+*/
+struct image_difference
+{
+	int differing = 0;        /**< Pixels further apart than the threshold. */
+	float largest = 0.0f;     /**< The furthest apart any pixel is, 0 to 1. */
+	float mean = 0.0f;        /**< How far apart pixels are on average, 0 to 1. */
+};
+
+/**
+*  Compares two images the way they look rather than byte for byte.
+*  Pixels are composited over white, then the difference between them
+*  is measured in YIQ, weighting brightness above hue as the eye does,
+*  so the one step of rounding a batching or atlasing change might
+*  bring falls well under a sensible threshold. 0 is identical and 1
+*  is black against white. SSE2 compares four pixels at a time.
+*  @param [in] expected The image wanted, such as a golden frame
+*  @param [in] actual The image to check
+*  @param [in] threshold How far apart two pixels can be and still
+*  count as the same, 0.1 being about right for rendering changes
+*  @param [out] difference How far apart the images are
+*  @param [out] heatmap If given, the expected image faded to grey with
+*  pixels that differ drawn over it in red, brighter the further apart
+*  @return false if the images aren't the same size, true otherwise,
+*  whether or not any pixels differ
+*/
+bool diffImages(const image& expected, const image& actual, float threshold,
+	image_difference& difference, image* heatmap = nullptr);
@@ -0,0 +1,661 @@
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include "Jpeg.h"
+
+namespace
+{
+	const int MAX_DIMENSION = 16384;
+	const int MAX_COMPONENTS = 3;
+
+	// the order coefficients are stored in, from low to high frequency
+	const uint8_t ZIGZAG[64] = {
+		0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+		12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+		35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+		58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63 };
+
+	/**
+	*  A Huffman table, stored as the largest code of each length and
+	*  where each length's symbols start.
+	*/
+	struct huffman_table
+	{
+		bool defined = false;
+		uint8_t symbols[256];
+		int max_code[17];   // -1 for lengths with no codes
+		int offset[17];     // symbol index less the first code of the length
+	};
+
+	struct component
+	{
+		int id = 0;
+		int h = 1;
+		int v = 1;
+		int quant = 0;
+		int dc_table = 0;
+		int ac_table = 0;
+		int dc_prediction = 0;
+		int stride = 0;
+		std::vector<uint8_t> plane;
+	};
+
+	/**
+	*  Reads entropy coded bits, highest first, dropping the zero stuffed
+	*  after each 0xFF. Once a marker is reached zeros are returned.
+	*/
+	struct bit_reader
+	{
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+		size_t position = 0;
+		uint32_t bits = 0;
+		int count = 0;
+		bool at_marker = false;
+
+		void fill()
+		{
+			while (count <= 24)
+			{
+				uint32_t byte = 0;
+				if (!at_marker && position < size)
+				{
+					byte = data[position];
+					if (byte != 0xff)
+					{
+						position++;
+					}
+					else if (position + 1 < size && data[position + 1] == 0)
+					{
+						position += 2;
+					}
+					else
+					{
+						at_marker = true;
+						byte = 0;
+					}
+				}
+				bits |= byte << (24 - count);
+				count += 8;
+			}
+		}
+
+		int get(int needed)
+		{
+			if (needed == 0)
+			{
+				return 0;
+			}
+
+			fill();
+			int value = static_cast<int>(bits >> (32 - needed));
+			bits <<= needed;
+			count -= needed;
+			return value;
+		}
+
+		/**
+		*  Skips to the byte after a restart marker.
+		*  @return true if a restart marker was found
+		*/
+		bool restart()
+		{
+			bits = 0;
+			count = 0;
+			at_marker = false;
+			if (position + 1 < size && data[position] == 0xff &&
+				data[position + 1] >= 0xd0 && data[position + 1] <= 0xd7)
+			{
+				position += 2;
+				return true;
+			}
+			return false;
+		}
+	};
+
+	bool buildTable(huffman_table& table, const uint8_t* counts, const uint8_t* symbols, int total)
+	{
+		memcpy(table.symbols, symbols, total);
+
+		int code = 0;
+		int index = 0;
+		for (int length = 1; length <= 16; length++)
+		{
+			int count = counts[length - 1];
+			table.offset[length] = index - code;
+			code += count;
+			index += count;
+			table.max_code[length] = count ? code - 1 : -1;
+			if (code > (1 << length))
+			{
+				return false;
+			}
+			code <<= 1;
+		}
+
+		table.defined = true;
+		return true;
+	}
+
+	/**
+	*   @brief   Reads one Huffman coded symbol.
+	*   @details Peeks at the next 16 bits and takes the shortest prefix
+	             that is a valid code.
+	*   @return  The symbol, or -1 if no code matched.
+	*/
+	int decodeSymbol(bit_reader& in, const huffman_table& table)
+	{
+		in.fill();
+		for (int length = 1; length <= 16; length++)
+		{
+			int code = static_cast<int>(in.bits >> (32 - length));
+			if (code <= table.max_code[length])
+			{
+				in.bits <<= length;
+				in.count -= length;
+				return table.symbols[table.offset[length] + code];
+			}
+		}
+		return -1;
+	}
+
+	int extend(int value, int length)
+	{
+		return length > 0 && value < (1 << (length - 1)) ? value - (1 << length) + 1 : value;
+	}
+
+	struct idct_basis
+	{
+		float weights[8][8];
+
+		idct_basis()
+		{
+			for (int u = 0; u < 8; u++)
+			{
+				float scale = u == 0 ? sqrtf(0.5f) : 1.0f;
+				for (int x = 0; x < 8; x++)
+				{
+					weights[u][x] = 0.5f * scale * cosf((2 * x + 1) * u * 3.14159265f / 16.0f);
+				}
+			}
+		}
+	};
+
+	/**
+	*   @brief   Transforms a block of coefficients back into samples.
+	*   @details A separable floating point IDCT, rows then columns.
+	             Slow next to the fixed point versions, but the cache
+				 means it runs once per image rather than once per run.
+	*   @return  void
+	*/
+	void inverseTransform(const float* coefficients, uint8_t* out, int stride)
+	{
+		static const idct_basis basis;
+
+		float rows[64];
+		for (int v = 0; v < 8; v++)
+		{
+			for (int x = 0; x < 8; x++)
+			{
+				float sum = 0.0f;
+				for (int u = 0; u < 8; u++)
+				{
+					sum += basis.weights[u][x] * coefficients[v * 8 + u];
+				}
+				rows[v * 8 + x] = sum;
+			}
+		}
+
+		for (int y = 0; y < 8; y++)
+		{
+			for (int x = 0; x < 8; x++)
+			{
+				float sum = 128.0f;
+				for (int v = 0; v < 8; v++)
+				{
+					sum += basis.weights[v][y] * rows[v * 8 + x];
+				}
+				int sample = static_cast<int>(floorf(sum + 0.5f));
+				out[y * stride + x] = static_cast<uint8_t>(sample < 0 ? 0 : sample > 255 ? 255 : sample);
+			}
+		}
+	}
+
+	struct jpeg_state
+	{
+		uint16_t quant[4][64];
+		huffman_table dc[4];
+		huffman_table ac[4];
+		component components[MAX_COMPONENTS];
+		int component_count = 0;
+		int width = 0;
+		int height = 0;
+		int h_max = 1;
+		int v_max = 1;
+		int mcus_x = 0;
+		int mcus_y = 0;
+		int restart_interval = 0;
+		bool has_frame = false;
+		bool has_scan = false;
+	};
+
+	bool decodeBlock(bit_reader& in, jpeg_state& state, component& comp, int block_x, int block_y)
+	{
+		const huffman_table& dc = state.dc[comp.dc_table];
+		const huffman_table& ac = state.ac[comp.ac_table];
+		const uint16_t* quant = state.quant[comp.quant];
+		float coefficients[64] = {};
+
+		int length = decodeSymbol(in, dc);
+		if (length < 0 || length > 11)
+		{
+			return false;
+		}
+		comp.dc_prediction += extend(in.get(length), length);
+		coefficients[0] = static_cast<float>(comp.dc_prediction * quant[0]);
+
+		for (int k = 1; k < 64;)
+		{
+			int symbol = decodeSymbol(in, ac);
+			if (symbol < 0)
+			{
+				return false;
+			}
+
+			int run = symbol >> 4;
+			length = symbol & 15;
+			if (length == 0)
+			{
+				if (run != 15)
+				{
+					break;
+				}
+				k += 16;
+				continue;
+			}
+
+			k += run;
+			if (k > 63)
+			{
+				return false;
+			}
+			coefficients[ZIGZAG[k]] = static_cast<float>(extend(in.get(length), length) * quant[k]);
+			k++;
+		}
+
+		inverseTransform(coefficients,
+			comp.plane.data() + static_cast<size_t>(block_y) * 8 * comp.stride + block_x * 8, comp.stride);
+		return true;
+	}
+
+	/**
+	*   @brief   Decodes one scan's entropy coded data.
+	*   @details A scan of several components interleaves them, each MCU
+	             holding every component's blocks. A scan of one
+				 component codes its blocks in plain raster order.
+	*   @return  True if every block decoded.
+	*/
+	bool decodeScan(bit_reader& in, jpeg_state& state, component** scan, int scan_count)
+	{
+		for (int i = 0; i < scan_count; i++)
+		{
+			scan[i]->dc_prediction = 0;
+		}
+
+		int units_x = state.mcus_x;
+		int units_y = state.mcus_y;
+		if (scan_count == 1)
+		{
+			int width = (state.width * scan[0]->h + state.h_max - 1) / state.h_max;
+			int height = (state.height * scan[0]->v + state.v_max - 1) / state.v_max;
+			units_x = (width + 7) / 8;
+			units_y = (height + 7) / 8;
+		}
+
+		int restart_count = 0;
+		for (int unit_y = 0; unit_y < units_y; unit_y++)
+		{
+			for (int unit_x = 0; unit_x < units_x; unit_x++)
+			{
+				if (state.restart_interval && restart_count == state.restart_interval)
+				{
+					if (!in.restart())
+					{
+						return false;
+					}
+					for (int i = 0; i < scan_count; i++)
+					{
+						scan[i]->dc_prediction = 0;
+					}
+					restart_count = 0;
+				}
+				restart_count++;
+
+				if (scan_count == 1)
+				{
+					if (!decodeBlock(in, state, *scan[0], unit_x, unit_y))
+					{
+						return false;
+					}
+					continue;
+				}
+
+				for (int i = 0; i < scan_count; i++)
+				{
+					component& comp = *scan[i];
+					for (int y = 0; y < comp.v; y++)
+					{
+						for (int x = 0; x < comp.h; x++)
+						{
+							if (!decodeBlock(in, state, comp, unit_x * comp.h + x, unit_y * comp.v + y))
+							{
+								return false;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool readFrame(const uint8_t* segment, int length, jpeg_state& state)
+	{
+		if (length < 6 || segment[0] != 8)
+		{
+			return false;
+		}
+
+		state.height = (segment[1] << 8) | segment[2];
+		state.width = (segment[3] << 8) | segment[4];
+		state.component_count = segment[5];
+		if (state.width <= 0 || state.height <= 0 || state.width > MAX_DIMENSION || state.height > MAX_DIMENSION ||
+			(state.component_count != 1 && state.component_count != 3) || length < 6 + state.component_count * 3)
+		{
+			return false;
+		}
+
+		for (int i = 0; i < state.component_count; i++)
+		{
+			component& comp = state.components[i];
+			comp.id = segment[6 + i * 3];
+			comp.h = segment[7 + i * 3] >> 4;
+			comp.v = segment[7 + i * 3] & 15;
+			comp.quant = segment[8 + i * 3];
+			if (comp.h < 1 || comp.h > 2 || comp.v < 1 || comp.v > 2 || comp.quant > 3)
+			{
+				return false;
+			}
+			state.h_max = comp.h > state.h_max ? comp.h : state.h_max;
+			state.v_max = comp.v > state.v_max ? comp.v : state.v_max;
+		}
+
+		state.mcus_x = (state.width + state.h_max * 8 - 1) / (state.h_max * 8);
+		state.mcus_y = (state.height + state.v_max * 8 - 1) / (state.v_max * 8);
+		for (int i = 0; i < state.component_count; i++)
+		{
+			component& comp = state.components[i];
+			comp.stride = state.mcus_x * comp.h * 8;
+			comp.plane.assign(static_cast<size_t>(comp.stride) * state.mcus_y * comp.v * 8, 0);
+		}
+
+		state.has_frame = true;
+		return true;
+	}
+
+	bool readTables(const uint8_t* segment, int length, jpeg_state& state)
+	{
+		while (length > 0)
+		{
+			if (length < 17)
+			{
+				return false;
+			}
+
+			int type = segment[0] >> 4;
+			int slot = segment[0] & 15;
+			int total = 0;
+			for (int i = 1; i <= 16; i++)
+			{
+				total += segment[i];
+			}
+			if (type > 1 || slot > 3 || total > 256 || length < 17 + total)
+			{
+				return false;
+			}
+
+			huffman_table& table = type == 0 ? state.dc[slot] : state.ac[slot];
+			if (!buildTable(table, segment + 1, segment + 17, total))
+			{
+				return false;
+			}
+
+			segment += 17 + total;
+			length -= 17 + total;
+		}
+		return true;
+	}
+
+	bool readQuantisation(const uint8_t* segment, int length, jpeg_state& state)
+	{
+		while (length > 0)
+		{
+			int precision = segment[0] >> 4;
+			int slot = segment[0] & 15;
+			int table_length = 1 + 64 * (precision ? 2 : 1);
+			if (slot > 3 || precision > 1 || length < table_length)
+			{
+				return false;
+			}
+
+			for (int i = 0; i < 64; i++)
+			{
+				state.quant[slot][i] = precision ?
+					static_cast<uint16_t>((segment[1 + i * 2] << 8) | segment[2 + i * 2]) : segment[1 + i];
+			}
+
+			segment += table_length;
+			length -= table_length;
+		}
+		return true;
+	}
+
+	/**
+	*   @brief   Reads a scan header and decodes the data after it.
+	*   @return  The offset of the first byte after the scan, or zero
+	             on failure.
+	*/
+	size_t readScan(const uint8_t* data, size_t size, size_t position, int length, jpeg_state& state)
+	{
+		const uint8_t* segment = data + position;
+		int scan_count = segment[0];
+		if (!state.has_frame || scan_count < 1 || scan_count > state.component_count || length < 4 + scan_count * 2)
+		{
+			return 0;
+		}
+
+		component* scan[MAX_COMPONENTS];
+		for (int i = 0; i < scan_count; i++)
+		{
+			int id = segment[1 + i * 2];
+			scan[i] = nullptr;
+			for (int c = 0; c < state.component_count; c++)
+			{
+				if (state.components[c].id == id)
+				{
+					scan[i] = &state.components[c];
+				}
+			}
+
+			if (!scan[i])
+			{
+				return 0;
+			}
+			scan[i]->dc_table = segment[2 + i * 2] >> 4;
+			scan[i]->ac_table = segment[2 + i * 2] & 15;
+			if (scan[i]->dc_table > 3 || scan[i]->ac_table > 3 ||
+				!state.dc[scan[i]->dc_table].defined || !state.ac[scan[i]->ac_table].defined)
+			{
+				return 0;
+			}
+		}
+
+		bit_reader in;
+		in.data = data;
+		in.size = size;
+		in.position = position + length - 2;
+		if (!decodeScan(in, state, scan, scan_count))
+		{
+			return 0;
+		}
+
+		// the scan ends at the first marker that isn't a restart
+		size_t end = in.position;
+		while (end + 1 < size && !(data[end] == 0xff && data[end + 1] != 0 &&
+			(data[end + 1] < 0xd0 || data[end + 1] > 0xd7)))
+		{
+			end++;
+		}
+
+		state.has_scan = true;
+		return end;
+	}
+
+	void convertColour(const jpeg_state& state, image& decoded)
+	{
+		decoded.width = state.width;
+		decoded.height = state.height;
+		decoded.pixels.resize(static_cast<size_t>(state.width) * state.height * 4);
+
+		const component* comps = state.components;
+		uint8_t* pixel = decoded.pixels.data();
+		for (int y = 0; y < state.height; y++)
+		{
+			const uint8_t* rows[MAX_COMPONENTS];
+			for (int c = 0; c < state.component_count; c++)
+			{
+				rows[c] = comps[c].plane.data() + static_cast<size_t>(y * comps[c].v / state.v_max) * comps[c].stride;
+			}
+
+			for (int x = 0; x < state.width; x++, pixel += 4)
+			{
+				int luma = rows[0][x * comps[0].h / state.h_max];
+				if (state.component_count == 1)
+				{
+					pixel[0] = pixel[1] = pixel[2] = static_cast<uint8_t>(luma);
+					pixel[3] = 255;
+					continue;
+				}
+
+				float cb = rows[1][x * comps[1].h / state.h_max] - 128.0f;
+				float cr = rows[2][x * comps[2].h / state.h_max] - 128.0f;
+				float rgb[3] = {
+					luma + 1.402f * cr,
+					luma - 0.344136f * cb - 0.714136f * cr,
+					luma + 1.772f * cb };
+
+				for (int c = 0; c < 3; c++)
+				{
+					int value = static_cast<int>(floorf(rgb[c] + 0.5f));
+					pixel[c] = static_cast<uint8_t>(value < 0 ? 0 : value > 255 ? 255 : value);
+				}
+				pixel[3] = 255;
+			}
+		}
+	}
+}
+
+/**
+*   @brief   Decodes a baseline JPEG held in memory.
+*   @details Walks the markers, reading the tables and frame header as
+             they come and decoding each scan into per component
+			 planes, which are then upsampled and converted to RGB.
+*   @return  True if the image was decoded.
+*/
+bool decodeJpeg(const uint8_t* data, size_t size, image& decoded)
+{
+	if (size < 4 || data[0] != 0xff || data[1] != 0xd8)
+	{
+		return false;
+	}
+
+	jpeg_state state;
+	size_t position = 2;
+	while (position + 4 <= size)
+	{
+		if (data[position] != 0xff)
+		{
+			return false;
+		}
+
+		int marker = data[position + 1];
+		position += 2;
+		if (marker == 0xff)
+		{
+			// fill byte before a marker
+			position--;
+			continue;
+		}
+		if (marker == 0xd9)
+		{
+			break;
+		}
+		if (marker == 0x01 || (marker >= 0xd0 && marker <= 0xd7))
+		{
+			continue;
+		}
+
+		int length = (data[position] << 8) | data[position + 1];
+		if (length < 2 || position + length > size)
+		{
+			return false;
+		}
+		const uint8_t* segment = data + position + 2;
+		const int segment_length = length - 2;
+
+		bool read = true;
+		switch (marker)
+		{
+		case 0xc0:
+		case 0xc1:
+			read = readFrame(segment, segment_length, state);
+			break;
+		case 0xc4:
+			read = readTables(segment, segment_length, state);
+			break;
+		case 0xdb:
+			read = readQuantisation(segment, segment_length, state);
+			break;
+		case 0xdd:
+			read = segment_length >= 2;
+			state.restart_interval = read ? (segment[0] << 8) | segment[1] : 0;
+			break;
+		case 0xda:
+			position = readScan(data, size, position + 2, length, state);
+			if (position == 0)
+			{
+				return false;
+			}
+			continue;
+		default:
+			// other frame types are progressive, lossless or arithmetic coded
+			read = marker < 0xc2 || marker > 0xcf || marker == 0xc4 || marker == 0xc8 || marker == 0xcc;
+			break;
+		}
+
+		if (!read)
+		{
+			return false;
+		}
+		position += length;
+	}
+
+	if (!state.has_scan)
+	{
+		return false;
+	}
+
+	convertColour(state, decoded);
+	return true;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "Png.h"
+
+/**
+*  Decodes a baseline JPEG held in memory.
+*  Greyscale and YCbCr images with any chroma subsampling up to 2x2
+*  and restart intervals are supported, which covers what cameras and
+*  image editors save by default and the menu the game ships.
+*  Progressive and arithmetic coded images are rejected.
+*  @param [in] data The contents of the JPEG file
+*  @param [in] size The size of the data in bytes
+*  @param [out] decoded The image, converted to RGBA with full alpha
+*  @return true if the image was decoded
+*/
+bool decodeJpeg(const uint8_t* data, size_t size, image& decoded);
@@ -0,0 +1,205 @@
+#include <stdint.h>
+#include <string.h>
+#include "Lz4.h"
+
+namespace
+{
+	const int HASH_BITS = 16;
+	const size_t MIN_MATCH = 4;
+	const size_t LAST_LITERALS = 5;    // the block must end with this many literals
+	const size_t MATCH_LIMIT = 12;     // no match may start closer to the end than this
+	const size_t MAX_DISTANCE = 65535;
+
+	uint32_t read32(const char* at)
+	{
+		uint32_t value;
+		memcpy(&value, at, sizeof(value));
+		return value;
+	}
+
+	uint32_t hash32(uint32_t value)
+	{
+		return (value * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	void writeLength(std::vector<char>& out, size_t length)
+	{
+		for (; length >= 255; length -= 255)
+		{
+			out.push_back(static_cast<char>(255));
+		}
+		out.push_back(static_cast<char>(length));
+	}
+
+	/**
+	*   @brief   Writes one sequence: literals, then optionally a match.
+	*   @details The token's high nibble holds the literal count and its
+	             low nibble the match length less four, each overflowing
+				 into extra bytes when it reaches 15.
+	*   @return  void
+	*/
+	void writeSequence(std::vector<char>& out, const char* literals, size_t literal_count,
+		size_t distance, size_t match_length)
+	{
+		size_t match_code = match_length ? match_length - MIN_MATCH : 0;
+		uint8_t token = static_cast<uint8_t>((literal_count < 15 ? literal_count : 15) << 4);
+		token |= static_cast<uint8_t>(match_code < 15 ? match_code : 15);
+		out.push_back(static_cast<char>(token));
+
+		if (literal_count >= 15)
+		{
+			writeLength(out, literal_count - 15);
+		}
+		out.insert(out.end(), literals, literals + literal_count);
+
+		if (match_length == 0)
+		{
+			return;
+		}
+
+		out.push_back(static_cast<char>(distance & 0xff));
+		out.push_back(static_cast<char>(distance >> 8));
+		if (match_code >= 15)
+		{
+			writeLength(out, match_code - 15);
+		}
+	}
+
+	bool readLength(const uint8_t*& in, const uint8_t* end, size_t& length)
+	{
+		uint8_t byte;
+		do
+		{
+			if (in >= end)
+			{
+				return false;
+			}
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+}
+
+/**
+*   @brief   Compresses data into an LZ4 block.
+*   @details Each position is looked up by the hash of its next four
+             bytes. A hit within range that really matches is extended
+			 forwards as far as it goes and written out, otherwise the
+			 byte becomes a literal.
+*   @return  void
+*/
+void compressLz4(const char* data, size_t size, std::vector<char>& compressed)
+{
+	compressed.clear();
+	compressed.reserve(size + size / 255 + 16);
+
+	std::vector<uint32_t> table(1 << HASH_BITS, 0);
+	size_t anchor = 0;
+	size_t position = 0;
+
+	if (size >= MATCH_LIMIT + 1)
+	{
+		const size_t match_end = size - MATCH_LIMIT;
+		const size_t search_end = size - LAST_LITERALS;
+
+		while (position < match_end)
+		{
+			uint32_t hash = hash32(read32(data + position));
+			size_t candidate = table[hash];
+			table[hash] = static_cast<uint32_t>(position);
+
+			if (candidate >= position || position - candidate > MAX_DISTANCE ||
+				read32(data + candidate) != read32(data + position))
+			{
+				position++;
+				continue;
+			}
+
+			size_t length = MIN_MATCH;
+			while (position + length < search_end && data[candidate + length] == data[position + length])
+			{
+				length++;
+			}
+
+			writeSequence(compressed, data + anchor, position - anchor, position - candidate, length);
+			position += length;
+			anchor = position;
+		}
+	}
+
+	writeSequence(compressed, data + anchor, size - anchor, 0, 0);
+}
+
+bool decompressLz4(const char* data, size_t size, char* out, size_t out_size)
+{
+	const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+	const uint8_t* in_end = in + size;
+	size_t written = 0;
+
+	while (in < in_end)
+	{
+		const uint8_t token = *in++;
+
+		size_t literal_count = token >> 4;
+		if (literal_count == 15 && !readLength(in, in_end, literal_count))
+		{
+			return false;
+		}
+		if (literal_count > static_cast<size_t>(in_end - in) || literal_count > out_size - written)
+		{
+			return false;
+		}
+		memcpy(out + written, in, literal_count);
+		in += literal_count;
+		written += literal_count;
+
+		// the last sequence has literals only
+		if (in == in_end)
+		{
+			break;
+		}
+
+		if (in_end - in < 2)
+		{
+			return false;
+		}
+		size_t distance = in[0] | (in[1] << 8);
+		in += 2;
+
+		size_t length = token & 0x0f;
+		if (length == 15 && !readLength(in, in_end, length))
+		{
+			return false;
+		}
+		length += MIN_MATCH;
+
+		if (distance == 0 || distance > written || length > out_size - written)
+		{
+			return false;
+		}
+
+		// matches may overlap what they write, so copy forwards. Eight
+		// bytes back or more, each eight read were written before the
+		// copy reaches them, so whole words can be moved at a time
+		char* to = out + written;
+		const char* from = to - distance;
+		size_t i = 0;
+		if (distance >= sizeof(uint64_t))
+		{
+			for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
+			{
+				uint64_t word;
+				memcpy(&word, from + i, sizeof(word));
+				memcpy(to + i, &word, sizeof(word));
+			}
+		}
+		for (; i < length; i++)
+		{
+			to[i] = from[i];
+		}
+		written += length;
+	}
+
+	return written == out_size;
+}
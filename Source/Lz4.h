@@ -0,0 +1,26 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+/**
+*  Compresses data into an LZ4 block.
+*  Matches are found through a single hash table with no chains, which
+*  is the trade LZ4 makes: poorer ratios than deflate in exchange for
+*  decompression that runs close to memory speed.
+*  @param [in] data The data to compress
+*  @param [in] size The size of the data in bytes
+*  @param [out] compressed The block, in the standard LZ4 block format
+*/
+void compressLz4(const char* data, size_t size, std::vector<char>& compressed);
+
+/**
+*  Decompresses an LZ4 block.
+*  Every read and write is bounds checked, so a damaged block fails
+*  rather than overrunning either buffer.
+*  @param [in] data The block
+*  @param [in] size The size of the block in bytes
+*  @param [out] out Where to write the data
+*  @param [in] out_size The size of the data once decompressed
+*  @return true if the block decompressed to exactly out_size bytes
+*/
+bool decompressLz4(const char* data, size_t size, char* out, size_t out_size);
@@ -0,0 +1,133 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Path.h"
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+/**
+*   @brief   Maps a file into memory.
+*   @details Empty files can't be mapped, so they are opened with a
+             null view and a size of zero. Off Windows, the path is
+			 first matched against the disk ignoring case.
+*   @return  True if the file was opened.
+*/
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	file_handle = file;
+	length = static_cast<size_t>(file_size.QuadPart);
+	if (length == 0)
+	{
+		return true;
+	}
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping)
+	{
+		view = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	}
+#else
+	descriptor = ::open(nativePath(path).c_str(), O_RDONLY);
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(descriptor, &info) != 0)
+	{
+		close();
+		return false;
+	}
+
+	length = static_cast<size_t>(info.st_size);
+	if (length == 0)
+	{
+		return true;
+	}
+
+	void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	view = mapped != MAP_FAILED ? static_cast<const char*>(mapped) : nullptr;
+#endif
+
+	if (!view)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (view)
+	{
+		UnmapViewOfFile(view);
+	}
+	if (mapping)
+	{
+		CloseHandle(mapping);
+	}
+	if (file_handle)
+	{
+		CloseHandle(file_handle);
+	}
+	mapping = nullptr;
+	file_handle = nullptr;
+#else
+	if (view)
+	{
+		munmap(const_cast<char*>(view), length);
+	}
+	if (descriptor >= 0)
+	{
+		::close(descriptor);
+	}
+	descriptor = -1;
+#endif
+
+	view = nullptr;
+	length = 0;
+}
+
+const char* MappedFile::data() const
+{
+	return view;
+}
+
+size_t MappedFile::size() const
+{
+	return length;
+}
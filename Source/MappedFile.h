@@ -0,0 +1,62 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+
+/**
+*  A read only view of a whole file, mapped into memory.
+*  The operating system pages the file in as it is read, so nothing is
+*  copied into the process up front and parsers can point straight
+*  into the data. The view stays valid until the file is closed.
+*/
+class MappedFile
+{
+public:
+
+	/**
+	*  Default constructor.
+	*/
+	MappedFile() = default;
+
+	/**
+	*  Destructor. Unmaps the file.
+	*/
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	*  Maps a file, closing any file already mapped.
+	*  @param [in] path The path to the file
+	*  @return true if the file was mapped, empty files included
+	*/
+	bool open(const std::string& path);
+
+	/**
+	*  Unmaps the file.
+	*/
+	void close();
+
+	/**
+	*  Returns the start of the file's contents.
+	*  @return the mapped data, or null if nothing is mapped
+	*/
+	const char* data() const;
+
+	/**
+	*  Returns the size of the file.
+	*  @return the size in bytes
+	*/
+	size_t size() const;
+
+private:
+	const char* view = nullptr;
+	size_t length = 0;
+
+#ifdef _WIN32
+	void* file_handle = nullptr;
+	void* mapping = nullptr;
+#else
+	int descriptor = -1;
+#endif
+};
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <climits>
+#include "MaxRects.h"
+
+namespace
+{
+	bool contains(const pixel_rect& outer, const pixel_rect& inner)
+	{
+		return inner.x >= outer.x && inner.y >= outer.y &&
+			inner.x + inner.width <= outer.x + outer.width &&
+			inner.y + inner.height <= outer.y + outer.height;
+	}
+}
+
+MaxRects::MaxRects(int width, int height)
+{
+	reset(width, height);
+}
+
+void MaxRects::reset(int width, int height)
+{
+	bin_width = width;
+	bin_height = height;
+	used_area = 0;
+
+	pixel_rect whole;
+	whole.width = width;
+	whole.height = height;
+	free_rects.assign(1, whole);
+}
+
+/**
+*   @brief   Places a rectangle in the bin.
+*   @details Best short side fit: of the free rectangles big enough,
+             picks the one the rectangle fills most closely along its
+			 tighter side, breaking ties on the other side.
+*   @return  True if there was room for it.
+*/
+bool MaxRects::insert(int width, int height, pixel_rect& placed)
+{
+	int best_short = INT_MAX;
+	int best_long = INT_MAX;
+	int best = -1;
+
+	for (int i = 0; i < static_cast<int>(free_rects.size()); i++)
+	{
+		const pixel_rect& free = free_rects[i];
+		if (free.width < width || free.height < height)
+		{
+			continue;
+		}
+
+		int leftover_x = free.width - width;
+		int leftover_y = free.height - height;
+		int short_side = std::min(leftover_x, leftover_y);
+		int long_side = std::max(leftover_x, leftover_y);
+		if (short_side < best_short || (short_side == best_short && long_side < best_long))
+		{
+			best_short = short_side;
+			best_long = long_side;
+			best = i;
+		}
+	}
+
+	if (best < 0)
+	{
+		return false;
+	}
+
+	placed.x = free_rects[best].x;
+	placed.y = free_rects[best].y;
+	placed.width = width;
+	placed.height = height;
+
+	new_rects.clear();
+	for (size_t i = 0; i < free_rects.size();)
+	{
+		if (split(free_rects[i], placed))
+		{
+			free_rects[i] = free_rects.back();
+			free_rects.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+	prune();
+
+	used_area += static_cast<long long>(width) * height;
+	return true;
+}
+
+float MaxRects::occupancy() const
+{
+	long long area = static_cast<long long>(bin_width) * bin_height;
+	return area > 0 ? static_cast<float>(used_area) / area : 0.0f;
+}
+
+/**
+*   @brief   Splits a free rectangle around a used one.
+*   @details Up to four maximal pieces are kept, one for each side of
+             the used rectangle the free one extends past. They go in
+			 a separate list until pruning.
+*   @return  True if the rectangles overlapped and the free one was
+             split, meaning it should be removed.
+*/
+bool MaxRects::split(const pixel_rect& free, const pixel_rect& used)
+{
+	if (used.x >= free.x + free.width || used.x + used.width <= free.x ||
+		used.y >= free.y + free.height || used.y + used.height <= free.y)
+	{
+		return false;
+	}
+
+	if (used.x > free.x)
+	{
+		pixel_rect left = free;
+		left.width = used.x - free.x;
+		new_rects.push_back(left);
+	}
+	if (used.x + used.width < free.x + free.width)
+	{
+		pixel_rect right = free;
+		right.x = used.x + used.width;
+		right.width = free.x + free.width - right.x;
+		new_rects.push_back(right);
+	}
+	if (used.y > free.y)
+	{
+		pixel_rect top = free;
+		top.height = used.y - free.y;
+		new_rects.push_back(top);
+	}
+	if (used.y + used.height < free.y + free.height)
+	{
+		pixel_rect bottom = free;
+		bottom.y = used.y + used.height;
+		bottom.height = free.y + free.height - bottom.y;
+		new_rects.push_back(bottom);
+	}
+
+	return true;
+}
+
+/**
+*   @brief   Drops free rectangles held inside others.
+*   @details The untouched free rectangles are already maximal among
+             themselves, so only the pieces just split off need to be
+			 checked, against each other and against the rest.
+*   @return  void
+*/
+void MaxRects::prune()
+{
+	for (size_t i = 0; i < new_rects.size();)
+	{
+		bool covered = false;
+		for (const pixel_rect& free : free_rects)
+		{
+			if (contains(free, new_rects[i]))
+			{
+				covered = true;
+				break;
+			}
+		}
+		for (size_t j = 0; j < new_rects.size() && !covered; j++)
+		{
+			covered = j != i && contains(new_rects[j], new_rects[i]) &&
+				(!contains(new_rects[i], new_rects[j]) || j < i);
+		}
+
+		if (covered)
+		{
+			new_rects[i] = new_rects.back();
+			new_rects.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	// pieces can't hold untouched rectangles, as each lies inside the
+	// free rectangle it was cut from, which didn't hold any either
+	free_rects.insert(free_rects.end(), new_rects.begin(), new_rects.end());
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+
+/**
+*  A rectangle of whole pixels inside a bin.
+*/
+struct pixel_rect
+{
+	int x = 0;
+	int y = 0;
+	int width = 0;
+	int height = 0;
+};
+
+/**
+*  Packs rectangles into a fixed size bin.
+*  The bin's empty space is tracked as the list of the largest free
+*  rectangles, which may overlap. Each rectangle goes where it leaves
+*  the shortest side of leftover space, then every free rectangle it
+*  overlaps is split around it and any free rectangle held inside
+*  another is dropped. Rectangles are never rotated, as the atlas
+*  format has no way of saying a region was turned.
+*/
+class MaxRects
+{
+public:
+
+	/**
+	*  Constructor.
+	*  @param [in] width The bin's width
+	*  @param [in] height The bin's height
+	*/
+	MaxRects(int width, int height);
+
+	/**
+	*  Empties the bin and changes its size.
+	*  @param [in] width The bin's width
+	*  @param [in] height The bin's height
+	*/
+	void reset(int width, int height);
+
+	/**
+	*  Places a rectangle in the bin.
+	*  @param [in] width The rectangle's width
+	*  @param [in] height The rectangle's height
+	*  @param [out] placed Where the rectangle was put
+	*  @return true if there was room for it
+	*/
+	bool insert(int width, int height, pixel_rect& placed);
+
+	/**
+	*  Returns how much of the bin is used.
+	*  @return the used area over the bin's area
+	*/
+	float occupancy() const;
+
+private:
+	bool split(const pixel_rect& free, const pixel_rect& used);
+	void prune();
+
+	int bin_width = 0;
+	int bin_height = 0;
+	long long used_area = 0;
+	std::vector<pixel_rect> free_rects;
+	std::vector<pixel_rect> new_rects;
+};
@@ -0,0 +1,428 @@
+#include <float.h>
+#include <math.h>
+#include "Narrowphase.h"
+
+namespace
+{
+	const float EPSILON = 1e-6f;
+
+	/**
+	*  How much better the second polygon's axis must be before it is
+	*  used as the reference face. Stops the faces flip-flopping when
+	*  two boxes rest flat on one another, which would upset warm starting.
+	*/
+	const float AXIS_TOLERANCE = 0.05f;
+
+	inline vector2 sub(const vector2& a, const vector2& b)
+	{
+		return vector2(a.x - b.x, a.y - b.y);
+	}
+
+	inline float dot(const vector2& a, const vector2& b)
+	{
+		return a.x * b.x + a.y * b.y;
+	}
+
+	inline float distance(const vector2& a, const vector2& b)
+	{
+		float dx = a.x - b.x;
+		float dy = a.y - b.y;
+		return sqrtf(dx * dx + dy * dy);
+	}
+
+	struct clip_vertex
+	{
+		vector2      position;
+		unsigned int id = 0;
+	};
+
+	unsigned int featureId(int reference_edge, int index, int type, bool flip)
+	{
+		return static_cast<unsigned int>(reference_edge) |
+			(static_cast<unsigned int>(index) << 8) |
+			(static_cast<unsigned int>(type) << 16) |
+			(static_cast<unsigned int>(flip ? 1 : 0) << 24);
+	}
+
+	/**
+	*   @brief   Finds the edge of one polygon that best separates another.
+	*   @details For each edge normal the deepest vertex of the other
+	             polygon is found. The edge where this is shallowest is
+				 the axis of least penetration.
+	*   @return  The separation along the best edge.
+	*/
+	float findMaxSeparation(int& edge, const polygon& poly_1, const polygon& poly_2)
+	{
+		float best = -FLT_MAX;
+		edge = 0;
+
+		for (int i = 0; i < poly_1.count; i++)
+		{
+			const vector2& normal = poly_1.normals[i];
+			const vector2& vertex = poly_1.vertices[i];
+
+			float deepest = FLT_MAX;
+			for (int j = 0; j < poly_2.count; j++)
+			{
+				float separation = dot(normal, sub(poly_2.vertices[j], vertex));
+				deepest = separation < deepest ? separation : deepest;
+			}
+
+			if (deepest > best)
+			{
+				best = deepest;
+				edge = i;
+			}
+		}
+
+		return best;
+	}
+
+	/**
+	*   @brief   Clips a segment against a plane.
+	*   @details Keeps the parts of the segment behind the plane,
+	             creating a new vertex where the segment crosses it.
+	*   @return  The number of vertices kept.
+	*/
+	int clipSegment(clip_vertex out[2], const clip_vertex in[2],
+		const vector2& normal, float offset, unsigned int clip_id)
+	{
+		int count = 0;
+		float distance_0 = dot(normal, in[0].position) - offset;
+		float distance_1 = dot(normal, in[1].position) - offset;
+
+		if (distance_0 <= 0.0f)
+		{
+			out[count++] = in[0];
+		}
+		if (distance_1 <= 0.0f)
+		{
+			out[count++] = in[1];
+		}
+
+		if (distance_0 * distance_1 < 0.0f)
+		{
+			float interp = distance_0 / (distance_0 - distance_1);
+			out[count].position.x = in[0].position.x + interp * (in[1].position.x - in[0].position.x);
+			out[count].position.y = in[0].position.y + interp * (in[1].position.y - in[0].position.y);
+			out[count].id = clip_id;
+			count++;
+		}
+
+		return count;
+	}
+}
+
+/**
+*   @brief   Builds an oriented box.
+*   @details The corners are rotated around the centre.
+*   @return  A four sided polygon.
+*/
+polygon makeBox(const vector2& centre, float half_width, float half_height, float angle)
+{
+	const float corners[4][2] = {
+		{ -half_width, -half_height },
+		{  half_width, -half_height },
+		{  half_width,  half_height },
+		{ -half_width,  half_height } };
+
+	const float edge_normals[4][2] = {
+		{ 0.0f, -1.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f }, { -1.0f, 0.0f } };
+
+	float c = cosf(angle);
+	float s = sinf(angle);
+
+	polygon box;
+	box.count = 4;
+	for (int i = 0; i < 4; i++)
+	{
+		box.vertices[i].x = centre.x + c * corners[i][0] - s * corners[i][1];
+		box.vertices[i].y = centre.y + s * corners[i][0] + c * corners[i][1];
+		box.normals[i].x = c * edge_normals[i][0] - s * edge_normals[i][1];
+		box.normals[i].y = s * edge_normals[i][0] + c * edge_normals[i][1];
+	}
+
+	return box;
+}
+
+/**
+*   @brief   Builds a convex polygon.
+*   @details Reverses the vertices if they wind the wrong way, so the
+             normals always face out of the polygon.
+*   @return  The polygon.
+*/
+polygon makePolygon(const vector2* vertices, int count)
+{
+	polygon poly;
+	poly.count = count < MAX_POLYGON_VERTICES ? count : MAX_POLYGON_VERTICES;
+
+	float area = 0.0f;
+	for (int i = 0; i < poly.count; i++)
+	{
+		const vector2& a = vertices[i];
+		const vector2& b = vertices[i + 1 < poly.count ? i + 1 : 0];
+		area += a.x * b.y - a.y * b.x;
+	}
+
+	for (int i = 0; i < poly.count; i++)
+	{
+		poly.vertices[i] = area >= 0.0f ? vertices[i] : vertices[poly.count - 1 - i];
+	}
+
+	for (int i = 0; i < poly.count; i++)
+	{
+		vector2 edge = sub(poly.vertices[i + 1 < poly.count ? i + 1 : 0], poly.vertices[i]);
+		float length = sqrtf(dot(edge, edge));
+		if (length > EPSILON)
+		{
+			poly.normals[i] = vector2(edge.y / length, -edge.x / length);
+		}
+	}
+
+	return poly;
+}
+
+polygon transformPolygon(const polygon& local, const vector2& position, float angle)
+{
+	float c = cosf(angle);
+	float s = sinf(angle);
+
+	polygon poly;
+	poly.count = local.count;
+	for (int i = 0; i < local.count; i++)
+	{
+		const vector2& v = local.vertices[i];
+		const vector2& n = local.normals[i];
+		poly.vertices[i].x = position.x + c * v.x - s * v.y;
+		poly.vertices[i].y = position.y + s * v.x + c * v.y;
+		poly.normals[i].x = c * n.x - s * n.y;
+		poly.normals[i].y = s * n.x + c * n.y;
+	}
+
+	return poly;
+}
+
+/**
+*   @brief   Circle against circle.
+*   @details The normal runs between the two centres.
+*   @return  True if they touch.
+*/
+bool collideCircles(const vector2& centre_a, float radius_a,
+	const vector2& centre_b, float radius_b, manifold& result)
+{
+	float dist = distance(centre_a, centre_b);
+	float separation = dist - radius_a - radius_b;
+	if (separation > 0.0f)
+	{
+		return false;
+	}
+
+	vector2 normal(0.0f, 1.0f);
+	if (dist > EPSILON)
+	{
+		normal.x = (centre_b.x - centre_a.x) / dist;
+		normal.y = (centre_b.y - centre_a.y) / dist;
+	}
+
+	float to_mid = radius_a + 0.5f * separation;
+	result.normal = normal;
+	result.count = 1;
+	result.points[0].position.x = centre_a.x + normal.x * to_mid;
+	result.points[0].position.y = centre_a.y + normal.y * to_mid;
+	result.points[0].separation = separation;
+	result.points[0].id = 0;
+	return true;
+}
+
+/**
+*   @brief   Polygon against circle.
+*   @details Finds the edge the centre is furthest in front of. The
+             centre is then classified as facing that edge or one of
+			 its end vertices, which decides the normal.
+*   @return  True if they touch.
+*/
+bool collidePolygonCircle(const polygon& poly_a,
+	const vector2& centre_b, float radius_b, manifold& result)
+{
+	int   edge = 0;
+	float separation = -FLT_MAX;
+	for (int i = 0; i < poly_a.count; i++)
+	{
+		float s = dot(poly_a.normals[i], sub(centre_b, poly_a.vertices[i]));
+		if (s > radius_b)
+		{
+			return false;
+		}
+
+		if (s > separation)
+		{
+			separation = s;
+			edge = i;
+		}
+	}
+
+	const vector2& v1 = poly_a.vertices[edge];
+	const vector2& v2 = poly_a.vertices[edge + 1 < poly_a.count ? edge + 1 : 0];
+
+	vector2 normal = poly_a.normals[edge];
+	vector2 surface;
+	unsigned int id = static_cast<unsigned int>(edge);
+
+	if (separation < EPSILON)
+	{
+		// centre is inside the polygon
+		surface.x = centre_b.x - normal.x * separation;
+		surface.y = centre_b.y - normal.y * separation;
+	}
+	else if (dot(sub(centre_b, v1), sub(v2, v1)) <= 0.0f)
+	{
+		separation = distance(centre_b, v1);
+		if (separation > radius_b || separation < EPSILON)
+		{
+			return false;
+		}
+
+		normal = sub(centre_b, v1);
+		normal.x /= separation;
+		normal.y /= separation;
+		surface = v1;
+		id |= 1u << 8;
+	}
+	else if (dot(sub(centre_b, v2), sub(v1, v2)) <= 0.0f)
+	{
+		separation = distance(centre_b, v2);
+		if (separation > radius_b || separation < EPSILON)
+		{
+			return false;
+		}
+
+		normal = sub(centre_b, v2);
+		normal.x /= separation;
+		normal.y /= separation;
+		surface = v2;
+		id |= 2u << 8;
+	}
+	else
+	{
+		surface.x = centre_b.x - normal.x * separation;
+		surface.y = centre_b.y - normal.y * separation;
+	}
+
+	float depth = separation - radius_b;
+	result.normal = normal;
+	result.count = 1;
+	result.points[0].position.x = surface.x + normal.x * 0.5f * depth;
+	result.points[0].position.y = surface.y + normal.y * 0.5f * depth;
+	result.points[0].separation = depth;
+	result.points[0].id = id;
+	return true;
+}
+
+/**
+*   @brief   Polygon against polygon.
+*   @details Uses the separating axis test to find the reference face,
+             then clips the incident face against the reference face's
+			 side planes. Points behind the reference face are kept.
+*   @return  True if they touch.
+*/
+bool collidePolygons(const polygon& poly_a, const polygon& poly_b, manifold& result)
+{
+	int edge_a = 0;
+	float separation_a = findMaxSeparation(edge_a, poly_a, poly_b);
+	if (separation_a > 0.0f)
+	{
+		return false;
+	}
+
+	int edge_b = 0;
+	float separation_b = findMaxSeparation(edge_b, poly_b, poly_a);
+	if (separation_b > 0.0f)
+	{
+		return false;
+	}
+
+	const polygon* poly_1 = &poly_a;
+	const polygon* poly_2 = &poly_b;
+	int  edge_1 = edge_a;
+	bool flip = false;
+
+	if (separation_b > separation_a + AXIS_TOLERANCE)
+	{
+		poly_1 = &poly_b;
+		poly_2 = &poly_a;
+		edge_1 = edge_b;
+		flip = true;
+	}
+
+	// the incident edge is the one most opposed to the reference normal
+	const vector2& reference_normal = poly_1->normals[edge_1];
+	int incident = 0;
+	float min_dot = FLT_MAX;
+	for (int i = 0; i < poly_2->count; i++)
+	{
+		float d = dot(reference_normal, poly_2->normals[i]);
+		if (d < min_dot)
+		{
+			min_dot = d;
+			incident = i;
+		}
+	}
+
+	int incident_next = incident + 1 < poly_2->count ? incident + 1 : 0;
+	clip_vertex incident_edge[2];
+	incident_edge[0].position = poly_2->vertices[incident];
+	incident_edge[0].id = featureId(edge_1, incident, 0, flip);
+	incident_edge[1].position = poly_2->vertices[incident_next];
+	incident_edge[1].id = featureId(edge_1, incident_next, 0, flip);
+
+	int edge_1_next = edge_1 + 1 < poly_1->count ? edge_1 + 1 : 0;
+	const vector2& v11 = poly_1->vertices[edge_1];
+	const vector2& v12 = poly_1->vertices[edge_1_next];
+
+	vector2 tangent = sub(v12, v11);
+	float length = sqrtf(dot(tangent, tangent));
+	if (length < EPSILON)
+	{
+		return false;
+	}
+	tangent.x /= length;
+	tangent.y /= length;
+
+	vector2 normal(tangent.y, -tangent.x);
+	float front_offset = dot(normal, v11);
+	float side_offset_1 = -dot(tangent, v11);
+	float side_offset_2 = dot(tangent, v12);
+
+	clip_vertex clip_1[2];
+	clip_vertex clip_2[2];
+	vector2 negative_tangent(-tangent.x, -tangent.y);
+
+	if (clipSegment(clip_1, incident_edge, negative_tangent, side_offset_1,
+		featureId(edge_1, edge_1, 1, flip)) < 2)
+	{
+		return false;
+	}
+
+	if (clipSegment(clip_2, clip_1, tangent, side_offset_2,
+		featureId(edge_1, edge_1_next, 1, flip)) < 2)
+	{
+		return false;
+	}
+
+	result.normal = flip ? vector2(-normal.x, -normal.y) : normal;
+	result.count = 0;
+	for (int i = 0; i < 2; i++)
+	{
+		float separation = dot(normal, clip_2[i].position) - front_offset;
+		if (separation <= 0.0f)
+		{
+			contact_point& point = result.points[result.count++];
+			point.position.x = clip_2[i].position.x - normal.x * 0.5f * separation;
+			point.position.y = clip_2[i].position.y - normal.y * 0.5f * separation;
+			point.separation = separation;
+			point.id = clip_2[i].id;
+		}
+	}
+
+	return result.count > 0;
+}
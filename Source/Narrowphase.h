@@ -0,0 +1,96 @@
+#pragma once
+#include "Vector2.h"
+
+/**
+*  The most vertices a convex polygon may have.
+*/
+const int MAX_POLYGON_VERTICES = 8;
+
+/**
+*  A convex polygon in world space.
+*  Vertices are wound so that each edge's outward normal is found by
+*  rotating the edge direction a quarter turn towards negative y.
+*  The normals are stored alongside, one per edge.
+*/
+struct polygon
+{
+	vector2 vertices[MAX_POLYGON_VERTICES];
+	vector2 normals[MAX_POLYGON_VERTICES];
+	int     count = 0;
+};
+
+/**
+*  A single point of contact between two shapes.
+*/
+struct contact_point
+{
+	vector2      position;         /**< Midway between the two surfaces. */
+	float        separation = 0;   /**< Negative when the shapes overlap. */
+	unsigned int id = 0;           /**< Identifies the features in contact. */
+};
+
+/**
+*  The contact between two shapes.
+*  The normal always points from the first shape towards the second.
+*  Feature ids are stable between steps while the same edges and
+*  vertices remain in contact, which allows impulses to be reused.
+*/
+struct manifold
+{
+	vector2       normal;
+	contact_point points[2];
+	int           count = 0;
+};
+
+/**
+*  Builds an oriented box polygon.
+*  @param [in] centre The centre of the box
+*  @param [in] half_width Half of the box's width
+*  @param [in] half_height Half of the box's height
+*  @param [in] angle The rotation around the centre in radians
+*  @return the box as a four sided polygon
+*/
+polygon makeBox(const vector2& centre, float half_width, float half_height, float angle);
+
+/**
+*  Builds a convex polygon from its vertices.
+*  The vertices are rewound if needed and the edge normals calculated.
+*  Anything past MAX_POLYGON_VERTICES is ignored.
+*  @param [in] vertices The corners of the polygon, in order
+*  @param [in] count The number of corners
+*  @return the polygon
+*/
+polygon makePolygon(const vector2* vertices, int count);
+
+/**
+*  Moves a polygon from local space into world space.
+*  @param [in] local The polygon around its own origin
+*  @param [in] position Where the origin is placed
+*  @param [in] angle The rotation around the origin in radians
+*  @return the transformed polygon
+*/
+polygon transformPolygon(const polygon& local, const vector2& position, float angle);
+
+/**
+*  Generates the contact between two circles.
+*  @return true if the circles are touching
+*/
+bool collideCircles(const vector2& centre_a, float radius_a,
+	const vector2& centre_b, float radius_b, manifold& result);
+
+/**
+*  Generates the contact between a polygon and a circle.
+*  The normal points from the polygon towards the circle.
+*  @return true if the shapes are touching
+*/
+bool collidePolygonCircle(const polygon& poly_a,
+	const vector2& centre_b, float radius_b, manifold& result);
+
+/**
+*  Generates the contact between two polygons.
+*  Finds the axis of least penetration, then clips the most opposed
+*  edge of the other polygon against the reference edge to give up to
+*  two contact points.
+*  @return true if the polygons are touching
+*/
+bool collidePolygons(const polygon& poly_a, const polygon& poly_b, manifold& result);
@@ -0,0 +1,442 @@
+#if defined(ASGE_HEADLESS)
+
+#include <algorithm>
+#include <string.h>
+
+#include "Jpeg.h"
+#include "MappedFile.h"
+#include "NullRenderer.h"
+#include "Png.h"
+
+namespace
+{
+	bool decode(const MappedFile& file, image& decoded)
+	{
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(file.data());
+		if (file.size() >= 2 && data[0] == 0xff && data[1] == 0xd8)
+		{
+			return decodeJpeg(data, file.size(), decoded);
+		}
+		return decodePng(data, file.size(), decoded);
+	}
+
+	bool isGlyph(char c)
+	{
+		return c != ' ' && c != '\t' && c != '\r' && c != '\n';
+	}
+}
+
+NullTexture::NullTexture(int width, int height, int id) :
+	ASGE::Texture2D(width, height),
+	texture_id(id)
+{
+	setFormat(ASGE::Texture2D::RGBA);
+	pixels.assign(static_cast<size_t>(width) * height * 4, 0);
+}
+
+void NullTexture::setData(void* data)
+{
+	const uint8_t* source = static_cast<const uint8_t*>(data);
+	pixels.assign(source, source + static_cast<size_t>(dims[0]) * dims[1] * format);
+}
+
+void* NullTexture::getData()
+{
+	return pixels.data();
+}
+
+const uint8_t* NullTexture::texels() const
+{
+	return pixels.data();
+}
+
+int NullTexture::id() const
+{
+	return texture_id;
+}
+
+NullSprite::NullSprite(NullRenderer& renderer) :
+	renderer(renderer)
+{
+	// the engine's sprite leaves the flags for its subclasses to set
+	flip_flags = ASGE::Sprite::NORMAL;
+}
+
+/**
+*   @brief   Loads a texture for the sprite.
+*   @details The sprite is sized to the whole texture, as the OpenGL
+             sprite is. A texture that can't be loaded leaves the
+			 sprite as it was.
+*   @return  True if the texture was loaded.
+*/
+bool NullSprite::loadTexture(const std::string& path)
+{
+	const NullTexture* loaded = renderer.loadTexture(path);
+	if (!loaded)
+	{
+		return false;
+	}
+
+	texture = loaded;
+	dims[0] = static_cast<float>(loaded->getWidth());
+	dims[1] = static_cast<float>(loaded->getHeight());
+	src_rect[0] = 0;
+	src_rect[1] = 0;
+	src_rect[2] = dims[0];
+	src_rect[3] = dims[1];
+	return true;
+}
+
+const ASGE::Texture2D* NullSprite::getTexture() const
+{
+	return texture;
+}
+
+bool NullInput::init(ASGE::Renderer*)
+{
+	return true;
+}
+
+/**
+*   @brief   Sends the events queued since the last update.
+*   @details The cursor is moved as each move is sent, so a click
+             queued after a move is handled with the cursor in its
+			 new place.
+*   @return  void
+*/
+void NullInput::update()
+{
+	while (!queued.empty())
+	{
+		queued_event event = queued.front();
+		queued.pop_front();
+
+		if (event.type == ASGE::E_MOUSE_MOVE)
+		{
+			cursor[0] = event.cursor[0];
+			cursor[1] = event.cursor[1];
+		}
+		sendEvent(event.type, event.data);
+	}
+}
+
+void NullInput::getCursorPos(double& xpos, double& ypos) const
+{
+	xpos = cursor[0];
+	ypos = cursor[1];
+}
+
+void NullInput::setCursorMode(ASGE::CursorMode)
+{
+}
+
+const GamePadData NullInput::getGamePad(int idx) const
+{
+	return GamePadData(idx, "", 0, nullptr, 0, nullptr);
+}
+
+void NullInput::key(int key, int action, int mods)
+{
+	auto data = std::make_shared<ASGE::KeyEvent>();
+	data->key = key;
+	data->scancode = key;
+	data->action = action;
+	data->mods = mods;
+	queued.push_back({ ASGE::E_KEY, data, { 0, 0 } });
+}
+
+void NullInput::click(int button, int action, int mods)
+{
+	auto data = std::make_shared<ASGE::ClickEvent>();
+	data->button = button;
+	data->action = action;
+	data->mods = mods;
+	queued.push_back({ ASGE::E_MOUSE_CLICK, data, { 0, 0 } });
+}
+
+void NullInput::moveCursor(double x, double y)
+{
+	auto data = std::make_shared<ASGE::MoveEvent>();
+	data->xpos = x;
+	data->ypos = y;
+	queued.push_back({ ASGE::E_MOUSE_MOVE, data, { x, y } });
+}
+
+NullRenderer::NullRenderer() :
+	ASGE::Renderer(ASGE::Renderer::RenderLib::INVALID)
+{
+	loadFont("default", 12);
+}
+
+NullRenderer::~NullRenderer() = default;
+
+void NullRenderer::setClearColour(ASGE::Colour rgb)
+{
+	cls = rgb;
+}
+
+/**
+*   @brief   Adds a font.
+*   @details Nothing is read, the font only records its name and size,
+             with a line height a little over the size as the OpenGL
+			 renderer gives.
+*   @return  The font's id.
+*/
+int NullRenderer::loadFont(const char* font, int pt)
+{
+	font_names.push_back(font ? font : "");
+
+	ASGE::Font loaded_font;
+	loaded_font.font_name = font_names.back().c_str();
+	loaded_font.font_size = pt;
+	loaded_font.line_height = pt + pt / 4;
+	fonts.push_back(loaded_font);
+	return static_cast<int>(fonts.size()) - 1;
+}
+
+bool NullRenderer::init(int w, int h, ASGE::Renderer::WindowMode mode)
+{
+	width = w;
+	height = h;
+	window_mode = mode;
+	return true;
+}
+
+bool NullRenderer::exit()
+{
+	return true;
+}
+
+void NullRenderer::preRender()
+{
+	sprites.clear();
+	frame = render_stats();
+}
+
+/**
+*   @brief   Ends the frame.
+*   @details The sprites are put in the order the sprite mode would
+             draw them and counted into batches, then the frame's
+			 counts are added to the totals.
+*   @return  void
+*/
+void NullRenderer::postRender()
+{
+	sortSprites();
+	countBatches();
+
+	frame.frames = 1;
+	total.frames += frame.frames;
+	total.sprites += frame.sprites;
+	total.draw_calls += frame.draw_calls;
+	total.texture_switches += frame.texture_switches;
+	total.text_calls += frame.text_calls;
+	total.text_glyphs += frame.text_glyphs;
+}
+
+void NullRenderer::renderText(const std::string str, int, int, float,
+	const ASGE::Colour&, float)
+{
+	frame.text_calls++;
+	frame.text_glyphs += std::count_if(str.begin(), str.end(), isGlyph);
+}
+
+void NullRenderer::setDefaultTextColour(const ASGE::Colour& colour)
+{
+	default_text_colour = colour;
+}
+
+const ASGE::Font& NullRenderer::getActiveFont() const
+{
+	return fonts[active_font];
+}
+
+void NullRenderer::setFont(int id)
+{
+	if (id >= 0 && id < static_cast<int>(fonts.size()))
+	{
+		active_font = id;
+	}
+}
+
+/**
+*   @brief   Queues a sprite.
+*   @details The sprite is copied as it stands, so it can be moved
+             before the frame ends without changing what was drawn.
+*   @return  void
+*/
+void NullRenderer::renderSprite(const ASGE::Sprite& sprite, float z_order)
+{
+	const ASGE::Texture2D* texture = sprite.getTexture();
+
+	sprite_draw draw;
+	draw.texture = texture;
+	draw.texture_id = texture ? static_cast<const NullTexture*>(texture)->id() : 0;
+	draw.position[0] = sprite.xPos();
+	draw.position[1] = sprite.yPos();
+	draw.dims[0] = sprite.width();
+	draw.dims[1] = sprite.height();
+	memcpy(draw.src_rect, sprite.srcRect(), sizeof(draw.src_rect));
+	draw.angle = sprite.rotationInRadians();
+	draw.scale = sprite.scale();
+	draw.alpha = sprite.opacity();
+	draw.flip_x = sprite.isFlippedOnX();
+	draw.flip_y = sprite.isFlippedOnY();
+	draw.tint = sprite.colour();
+	draw.z_order = z_order;
+	draw.sequence = static_cast<int>(sprites.size());
+	sprites.push_back(draw);
+
+	frame.sprites++;
+}
+
+void NullRenderer::setSpriteMode(ASGE::SpriteSortMode mode)
+{
+	sort_mode = mode;
+}
+
+void NullRenderer::setWindowedMode(ASGE::Renderer::WindowMode mode)
+{
+	window_mode = mode;
+}
+
+void NullRenderer::setWindowTitle(const char* str)
+{
+	title = str ? str : "";
+}
+
+void NullRenderer::swapBuffers()
+{
+}
+
+std::unique_ptr<ASGE::Input> NullRenderer::inputPtr()
+{
+	return std::unique_ptr<ASGE::Input>(new NullInput);
+}
+
+std::unique_ptr<ASGE::Sprite> NullRenderer::createUniqueSprite()
+{
+	return std::unique_ptr<ASGE::Sprite>(new NullSprite(*this));
+}
+
+ASGE::Sprite* NullRenderer::createRawSprite()
+{
+	return new NullSprite(*this);
+}
+
+/**
+*   @brief   Finds or loads a texture.
+*   @details Textures are decoded whole into memory. A failed load
+             isn't remembered, so the file is tried again next time.
+*   @return  The texture, or null.
+*/
+const NullTexture* NullRenderer::loadTexture(const std::string& path)
+{
+	auto found = loaded.find(path);
+	if (found != loaded.end())
+	{
+		return found->second.get();
+	}
+
+	MappedFile file;
+	image decoded;
+	if (!file.open(path) || !file.data() || !decode(file, decoded))
+	{
+		return nullptr;
+	}
+
+	const int id = static_cast<int>(loaded.size()) + 1;
+	std::unique_ptr<NullTexture> texture(new NullTexture(decoded.width, decoded.height, id));
+	texture->setData(decoded.pixels.data());
+	return (loaded[path] = std::move(texture)).get();
+}
+
+const render_stats& NullRenderer::frameStats() const
+{
+	return frame;
+}
+
+const render_stats& NullRenderer::totalStats() const
+{
+	return total;
+}
+
+const std::vector<sprite_draw>& NullRenderer::frameSprites() const
+{
+	return sprites;
+}
+
+int NullRenderer::textures() const
+{
+	return static_cast<int>(loaded.size());
+}
+
+void NullRenderer::windowSize(int& width, int& height) const
+{
+	width = this->width;
+	height = this->height;
+}
+
+/**
+*   @brief   Puts the frame's sprites in drawing order.
+*   @details The sorting modes order by texture, after z-order if they
+             use it. Sprites that tie keep the order they came in.
+*   @return  void
+*/
+void NullRenderer::sortSprites()
+{
+	switch (sort_mode)
+	{
+	case ASGE::SpriteSortMode::TEXTURE:
+		std::stable_sort(sprites.begin(), sprites.end(), [](const sprite_draw& lhs, const sprite_draw& rhs)
+		{
+			return lhs.texture_id < rhs.texture_id;
+		});
+		break;
+
+	case ASGE::SpriteSortMode::BACK_TO_FRONT:
+		std::stable_sort(sprites.begin(), sprites.end(), [](const sprite_draw& lhs, const sprite_draw& rhs)
+		{
+			return lhs.z_order != rhs.z_order ? lhs.z_order < rhs.z_order : lhs.texture_id < rhs.texture_id;
+		});
+		break;
+
+	case ASGE::SpriteSortMode::FRONT_TO_BACK:
+		std::stable_sort(sprites.begin(), sprites.end(), [](const sprite_draw& lhs, const sprite_draw& rhs)
+		{
+			return lhs.z_order != rhs.z_order ? lhs.z_order > rhs.z_order : lhs.texture_id < rhs.texture_id;
+		});
+		break;
+
+	default:
+		break;
+	}
+}
+
+/**
+*   @brief   Counts the draws and texture binds the frame would take.
+*   @details Every sprite is a draw of its own in immediate mode. The
+             other modes draw a batch for each run of sprites sharing
+			 a texture. Text goes through the font's own batch and
+			 isn't counted here.
+*   @return  void
+*/
+void NullRenderer::countBatches()
+{
+	int bound = -1;
+	for (const sprite_draw& draw : sprites)
+	{
+		if (draw.texture_id != bound)
+		{
+			bound = draw.texture_id;
+			frame.texture_switches++;
+			frame.draw_calls++;
+		}
+		else if (sort_mode == ASGE::SpriteSortMode::IMMEDIATE)
+		{
+			frame.draw_calls++;
+		}
+	}
+}
+
+#endif
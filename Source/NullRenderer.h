@@ -0,0 +1,278 @@
+#pragma once
+#include <deque>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <Engine/Font.h>
+#include <Engine/Input.h>
+#include <Engine/Renderer.h>
+#include <Engine/Sprite.h>
+#include <Engine/Texture.h>
+
+class NullRenderer;
+
+/**
+*  What the null renderer counted over a frame, or over every frame.
+*/
+struct render_stats
+{
+	uint64_t frames = 0;            /**< Frames presented. */
+	uint64_t sprites = 0;           /**< Sprites submitted. */
+	uint64_t draw_calls = 0;        /**< Sprite batches the OpenGL renderer would draw. */
+	uint64_t texture_switches = 0;  /**< Times the bound texture would change. */
+	uint64_t text_calls = 0;        /**< Strings submitted. */
+	uint64_t text_glyphs = 0;       /**< Characters drawn, spaces and line breaks aside. */
+};
+
+/**
+*  A sprite as it was when it was submitted.
+*/
+struct sprite_draw
+{
+	const ASGE::Texture2D* texture = nullptr;
+	int texture_id = 0;   // 0 for a sprite without a texture
+	float position[2] = { 0, 0 };
+	float dims[2] = { 0, 0 };
+	float src_rect[4] = { 0, 0, 0, 0 };
+	float angle = 0.0f;
+	float scale = 1.0f;
+	float alpha = 1.0f;
+	bool flip_x = false;
+	bool flip_y = false;
+	ASGE::Colour tint = ASGE::COLOURS::WHITE;
+	float z_order = 0.0f;
+	int sequence = 0;   // submission order within the frame
+};
+
+/**
+*  A texture held in memory.
+*  The pixels stay on the CPU, so anything the game reads back from a
+*  texture reads what the file decoded to.
+*/
+class NullTexture :
+	public ASGE::Texture2D
+{
+public:
+
+	/**
+	*  Constructor. The texture is RGBA and starts transparent.
+	*  @param [in] width The width in pixels
+	*  @param [in] height The height in pixels
+	*  @param [in] id The texture's number, counting up from 1 as
+	*  textures are loaded
+	*/
+	NullTexture(int width, int height, int id);
+
+	/**
+	*  Copies in a full set of pixels in the texture's format.
+	*  @param [in] data The pixels, rows top to bottom
+	*/
+	virtual void  setData(void* data) override;
+
+	/**
+	*  Returns the pixels.
+	*  @return the pixels, rows top to bottom
+	*/
+	virtual void* getData() override;
+
+	/**
+	*  Returns the pixels for reading.
+	*  @return the pixels, rows top to bottom
+	*/
+	const uint8_t* texels() const;
+
+	/**
+	*  Returns the texture's number, which the sorting sprite modes
+	*  order by as the OpenGL renderer orders by texture name.
+	*  @return the number given on construction
+	*/
+	int  id() const;
+
+private:
+	std::vector<uint8_t> pixels;
+	int texture_id = 0;
+};
+
+/**
+*  A sprite drawn by the null renderer.
+*  Loading a texture sets the sprite's size and source rectangle to
+*  the whole texture, as the OpenGL sprite does.
+*/
+class NullSprite :
+	public ASGE::Sprite
+{
+public:
+
+	/**
+	*  Constructor.
+	*  @param [in] renderer The renderer that loads and shares textures
+	*/
+	explicit NullSprite(NullRenderer& renderer);
+
+	virtual bool loadTexture(const std::string& path) override;
+	virtual const ASGE::Texture2D* getTexture() const override;
+
+private:
+	NullRenderer& renderer;
+	const NullTexture* texture = nullptr;
+};
+
+/**
+*  Input fed by the program rather than a window.
+*  Events are queued and sent on the next update, where the game would
+*  receive the window's events, so a scripted run sees them in the
+*  same place in the frame a player's would.
+*/
+class NullInput :
+	public ASGE::Input
+{
+public:
+	virtual bool init(ASGE::Renderer* renderer) override;
+	virtual void update() override;
+	virtual void getCursorPos(double& xpos, double& ypos) const override;
+	virtual void setCursorMode(ASGE::CursorMode mode) override;
+	virtual const GamePadData getGamePad(int idx) const override;
+
+	/**
+	*  Queues a key event.
+	*  @param [in] key The key, from ASGE::KEYS
+	*  @param [in] action Pressed, released or repeated
+	*  @param [in] mods Any modifier keys held
+	*/
+	void key(int key, int action, int mods = 0);
+
+	/**
+	*  Queues a mouse button event at the cursor.
+	*  @param [in] button The mouse button
+	*  @param [in] action Pressed or released
+	*  @param [in] mods Any modifier keys held
+	*/
+	void click(int button, int action, int mods = 0);
+
+	/**
+	*  Queues a move of the cursor.
+	*  @param [in] x The new position on the X axis
+	*  @param [in] y The new position on the Y axis
+	*/
+	void moveCursor(double x, double y);
+
+private:
+	struct queued_event
+	{
+		ASGE::EventType type;
+		ASGE::SharedEventData data;
+		double cursor[2];   // where a move leaves the cursor
+	};
+
+	std::deque<queued_event> queued;
+	double cursor[2] = { 0, 0 };
+};
+
+/**
+*  A renderer that draws nothing.
+*  Textures are decoded into memory and every sprite and string is
+*  accepted, so the whole game can run without a window or a graphics
+*  driver: on a build machine, for soak tests, or to time the game's
+*  own work free of the GPU. Draw calls, texture switches and glyphs
+*  are counted as the OpenGL renderer would issue them. Sprites are
+*  kept until the frame ends, as the batching modes sort by texture
+*  before anything is bound.
+*/
+class NullRenderer :
+	public ASGE::Renderer
+{
+public:
+
+	/**
+	*  Default constructor. Font 0 is the default font, as in the
+	*  OpenGL renderer.
+	*/
+	NullRenderer();
+	virtual ~NullRenderer();
+
+	using ASGE::Renderer::renderSprite;
+	using ASGE::Renderer::renderText;
+
+	virtual void setClearColour(ASGE::Colour rgb) override;
+	virtual int  loadFont(const char* font, int pt) override;
+	virtual bool init(int w, int h, ASGE::Renderer::WindowMode mode) override;
+	virtual bool exit() override;
+	virtual void preRender() override;
+	virtual void postRender() override;
+	virtual void renderText(const std::string str, int x, int y, float scale,
+		const ASGE::Colour& colour, float z_order) override;
+	virtual void setDefaultTextColour(const ASGE::Colour& colour) override;
+	virtual const ASGE::Font& getActiveFont() const override;
+	virtual void setFont(int id) override;
+	virtual void renderSprite(const ASGE::Sprite& sprite, float z_order) override;
+	virtual void setSpriteMode(ASGE::SpriteSortMode mode) override;
+	virtual void setWindowedMode(ASGE::Renderer::WindowMode mode) override;
+	virtual void setWindowTitle(const char* str) override;
+	virtual void swapBuffers() override;
+	virtual std::unique_ptr<ASGE::Input> inputPtr() override;
+	virtual std::unique_ptr<ASGE::Sprite> createUniqueSprite() override;
+	virtual ASGE::Sprite* createRawSprite() override;
+
+	/**
+	*  Finds or loads a texture.
+	*  Like the OpenGL renderer, a texture is shared only between
+	*  paths spelt exactly the same, and is kept until the renderer
+	*  is destroyed.
+	*  @param [in] path The PNG or JPEG to load
+	*  @return the texture, or null if it couldn't be loaded
+	*/
+	const NullTexture* loadTexture(const std::string& path);
+
+	/**
+	*  Returns what was counted during the last frame presented, or
+	*  the frame being drawn if called between preRender and postRender.
+	*  @return the frame's counts
+	*/
+	const render_stats& frameStats() const;
+
+	/**
+	*  Returns what was counted over every frame presented.
+	*  @return the running totals
+	*/
+	const render_stats& totalStats() const;
+
+	/**
+	*  Returns the sprites submitted in the frame being drawn, or the
+	*  last frame once it has been presented, in the order the sprite
+	*  mode draws them.
+	*  @return the frame's sprites
+	*/
+	const std::vector<sprite_draw>& frameSprites() const;
+
+	/**
+	*  Returns the number of textures loaded.
+	*  @return the texture count
+	*/
+	int  textures() const;
+
+	/**
+	*  Returns the size the game's window was opened at.
+	*  @param [out] width The width in pixels
+	*  @param [out] height The height in pixels
+	*/
+	void windowSize(int& width, int& height) const;
+
+private:
+	void sortSprites();
+	void countBatches();
+
+	std::map<std::string, std::unique_ptr<NullTexture>> loaded;
+	std::deque<ASGE::Font> fonts;
+	std::deque<std::string> font_names;   // fonts point into these
+	std::vector<sprite_draw> sprites;
+	render_stats frame;
+	render_stats total;
+	ASGE::SpriteSortMode sort_mode = ASGE::SpriteSortMode::DEFERRED;
+	std::string title;
+	int active_font = 0;
+	int width = 0;
+	int height = 0;
+};
@@ -0,0 +1,171 @@
+#include <ctype.h>
+#include <vector>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <strings.h>
+#include <unistd.h>
+#endif
+
+#include "Path.h"
+
+/**
+*   @brief   Normalises a path.
+*   @details Splits the path into folders, dropping "." and stepping
+             back for "..", then joins it with forward slashes. A ".."
+			 with nothing to step back over is kept.
+*   @return  The normalised path.
+*/
+std::string normalisePath(const std::string& path)
+{
+	std::vector<std::string> parts;
+	std::string part;
+
+	for (size_t i = 0; i <= path.size(); i++)
+	{
+		char c = i < path.size() ? path[i] : '/';
+		if (c != '/' && c != '\\')
+		{
+			part += static_cast<char>(tolower(static_cast<unsigned char>(c)));
+			continue;
+		}
+
+		if (part == "..")
+		{
+			if (!parts.empty() && parts.back() != "..")
+			{
+				parts.pop_back();
+			}
+			else
+			{
+				parts.push_back(part);
+			}
+		}
+		else if (!part.empty() && part != ".")
+		{
+			parts.push_back(part);
+		}
+		part.clear();
+	}
+
+	std::string normalised;
+	if (!path.empty() && (path[0] == '/' || path[0] == '\\'))
+	{
+		normalised += '/';
+	}
+
+	for (const std::string& folder : parts)
+	{
+		if (!normalised.empty() && normalised.back() != '/')
+		{
+			normalised += '/';
+		}
+		normalised += folder;
+	}
+
+	return normalised;
+}
+
+/**
+*   @brief   Converts a path for the platform.
+*   @details Only a path that can't be opened as spelt is matched part
+             by part, so the folder scans are paid for once per load
+			 of a misspelt file rather than for every file.
+*   @return  The path to open.
+*/
+std::string nativePath(const std::string& path)
+{
+#ifdef _WIN32
+	return path;
+#else
+	std::string native = path;
+	for (char& c : native)
+	{
+		if (c == '\\')
+		{
+			c = '/';
+		}
+	}
+
+	if (native.empty() || access(native.c_str(), F_OK) == 0)
+	{
+		return native;
+	}
+
+	std::string matched = native[0] == '/' ? "/" : "";
+	size_t start = native[0] == '/' ? 1 : 0;
+	while (start <= native.size())
+	{
+		size_t end = native.find('/', start);
+		if (end == std::string::npos)
+		{
+			end = native.size();
+		}
+		std::string part = native.substr(start, end - start);
+		start = end + 1;
+
+		if (part.empty())
+		{
+			continue;
+		}
+
+		if (part != "." && part != ".." && access((matched + part).c_str(), F_OK) != 0)
+		{
+			DIR* folder = opendir(matched.empty() ? "." : matched.c_str());
+			if (folder)
+			{
+				while (dirent* entry = readdir(folder))
+				{
+					if (strcasecmp(entry->d_name, part.c_str()) == 0)
+					{
+						part = entry->d_name;
+						break;
+					}
+				}
+				closedir(folder);
+			}
+		}
+
+		matched += part;
+		if (end < native.size())
+		{
+			matched += '/';
+		}
+	}
+
+	return matched;
+#endif
+}
+
+bool fileStamp(const std::string& path, uint64_t& size, int64_t& modified)
+{
+	const std::string native = nativePath(path);
+#ifdef _WIN32
+	struct _stat64 status;
+	if (_stat64(native.c_str(), &status) != 0)
+#else
+	struct stat status;
+	if (stat(native.c_str(), &status) != 0)
+#endif
+	{
+		return false;
+	}
+
+	size = static_cast<uint64_t>(status.st_size);
+	modified = static_cast<int64_t>(status.st_mtime);
+	return true;
+}
+
+void makeFolder(const std::string& folder)
+{
+#ifdef _WIN32
+	_mkdir(folder.c_str());
+#else
+	mkdir(folder.c_str(), 0755);
+#endif
+}
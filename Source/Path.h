@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+/**
+*  Turns a path into the form used to look files up.
+*  Separators become forward slashes, "." and empty parts are removed,
+*  ".." steps back a folder and the path is lowercased, as the game's
+*  files are on a case insensitive file system. A path starting with a
+*  separator keeps one.
+*  @param [in] path The path to normalise
+*  @return the normalised path
+*/
+std::string normalisePath(const std::string& path);
+
+/**
+*  Turns a path as the game spells it into one the platform can open.
+*  The game's paths were written for Windows, with backslashes and in
+*  whatever case came to mind. Elsewhere backslashes become forward
+*  slashes and, if the file isn't there as spelt, each part is matched
+*  against the folder's contents ignoring case. Parts with no match
+*  are kept, so paths to files about to be written still work.
+*  @param [in] path The path to convert
+*  @return the path to open, unchanged on Windows
+*/
+std::string nativePath(const std::string& path);
+
+/**
+*  Reads a file's size and when it was last modified, without opening
+*  it.
+*  @param [in] path The path to the file
+*  @param [out] size The file's size in bytes
+*  @param [out] modified When the file was last written, in seconds
+*  since 1970
+*  @return true if the file exists
+*/
+bool fileStamp(const std::string& path, uint64_t& size, int64_t& modified);
+
+/**
+*  Creates a folder, if it isn't there already. The folder it goes in
+*  must exist.
+*  @param [in] folder The folder to create
+*/
+void makeFolder(const std::string& folder);
@@ -0,0 +1,67 @@
+#include "PhysicsStepper.h"
+
+/**
+*   @brief   Constructor.
+*   @details Requires the step size and the cap on steps per frame.
+*   @return  void
+*/
+PhysicsStepper::PhysicsStepper(double step_sec, int max_steps)
+{
+	stepSize(step_sec);
+	maxSteps(max_steps);
+}
+
+/**
+*   @brief   Empties the accumulator.
+*   @details Any partial step is thrown away and the step count reset.
+*   @return  void
+*/
+void PhysicsStepper::reset()
+{
+	accumulator = 0;
+	steps_last_frame = 0;
+}
+
+double PhysicsStepper::stepSize() const
+{
+	return step_size;
+}
+
+void PhysicsStepper::stepSize(double step_sec)
+{
+	if (step_sec > 0)
+	{
+		step_size = step_sec;
+	}
+}
+
+int PhysicsStepper::maxSteps() const
+{
+	return max_steps;
+}
+
+void PhysicsStepper::maxSteps(int steps)
+{
+	max_steps = steps < 1 ? 1 : steps;
+}
+
+/**
+*   @brief   Interpolation factor.
+*   @details The fraction of a step that remains in the accumulator.
+*   @return  The blend between the previous and current state.
+*/
+float PhysicsStepper::alpha() const
+{
+	float blend = static_cast<float>(accumulator / step_size);
+	return blend < 1.0f ? blend : 1.0f;
+}
+
+int PhysicsStepper::stepsLastFrame() const
+{
+	return steps_last_frame;
+}
+
+double PhysicsStepper::droppedTime() const
+{
+	return dropped_time;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <math.h>
+
+/**
+*  Drives the simulation using a fixed timestep.
+*  Frame deltas are accumulated and then consumed in steps of a fixed
+*  size, so the result of a simulation no longer depends on the frame
+*  rate it was run at. The number of steps taken in a single frame is
+*  capped, with any time beyond the cap being discarded. This stops a
+*  slow frame from snowballing into even slower ones. The time left
+*  over is exposed as a blend factor for interpolating render state.
+*/
+class PhysicsStepper
+{
+public:
+
+	/**
+	*  Default constructor.
+	*/
+	PhysicsStepper() = default;
+
+	/**
+	*  Constructor.
+	*  @param [in] step_sec The size of a single step in seconds
+	*  @param [in] max_steps The maximum number of steps ran per frame
+	*/
+	PhysicsStepper(double step_sec, int max_steps);
+
+	/**
+	*  Advances the simulation by a frame.
+	*  The frame delta is added to the accumulator and the step function
+	*  is called once for every whole step that can be consumed from it.
+	*  @param [in] dt_sec The frame delta in seconds
+	*  @param [in] step A callable taking the step size in seconds
+	*  @return the number of steps that were ran
+	*/
+	template<typename StepFnc>
+	int  advance(double dt_sec, StepFnc step);
+
+	/**
+	*  Discards any accumulated time.
+	*  Useful after loading or restarting a level, so that the time
+	*  spent doing so is not simulated on the following frame.
+	*/
+	void reset();
+
+	/**
+	*  Returns the size of a single step.
+	*  @return the step size in seconds
+	*/
+	double stepSize() const;
+
+	/**
+	*  Sets the size of a single step.
+	*  @param [in] step_sec The step size in seconds
+	*/
+	void stepSize(double step_sec);
+
+	/**
+	*  Returns the maximum number of steps ran per frame.
+	*  @return the step cap
+	*/
+	int  maxSteps() const;
+
+	/**
+	*  Sets the maximum number of steps ran per frame.
+	*  This caps the cost of the simulation when under load.
+	*  @param [in] steps The step cap, must be at least 1
+	*/
+	void maxSteps(int steps);
+
+	/**
+	*  Returns the interpolation factor.
+	*  This is the fraction of a step left in the accumulator after the
+	*  last advance, to be used when blending the previous and current
+	*  simulation states together for rendering.
+	*  @return the blend factor in the range [0, 1)
+	*/
+	float alpha() const;
+
+	/**
+	*  Returns how many steps were ran by the last advance.
+	*  @return the step count of the last frame
+	*/
+	int  stepsLastFrame() const;
+
+	/**
+	*  Returns the total time discarded due to the step cap.
+	*  @return the dropped time in seconds
+	*/
+	double droppedTime() const;
+
+private:
+	double step_size = 1.0 / 120.0;
+	double accumulator = 0;
+	double dropped_time = 0;
+	int    max_steps = 8;
+	int    steps_last_frame = 0;
+};
+
+template<typename StepFnc>
+int PhysicsStepper::advance(double dt_sec, StepFnc step)
+{
+	if (dt_sec > 0)
+	{
+		accumulator += dt_sec;
+	}
+
+	int steps = 0;
+	while (accumulator >= step_size && steps < max_steps)
+	{
+		step(static_cast<float>(step_size));
+		accumulator -= step_size;
+		steps++;
+	}
+
+	// whole steps left after the cap are time we could not afford
+	if (accumulator >= step_size)
+	{
+		double excess = accumulator - fmod(accumulator, step_size);
+		dropped_time += excess;
+		accumulator -= excess;
+	}
+
+	steps_last_frame = steps;
+	return steps;
+}
@@ -0,0 +1,1079 @@
+#include <algorithm>
+#include <math.h>
+#include "PhysicsWorld.h"
+#include "Sweep.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	const float PI = 3.14159265f;
+	const float BAUMGARTE = 0.2f;              /**< Fraction of overlap corrected per step. */
+	const float LINEAR_SLOP = 0.5f;            /**< Overlap in pixels left alone to keep contacts alive. */
+	const float RESTITUTION_THRESHOLD = 40.0f; /**< Slower impacts than this don't bounce. */
+	const float TIME_TO_SLEEP = 0.5f;          /**< Seconds an island must be still before sleeping. */
+	const float LINEAR_SLEEP_TOLERANCE = 2.0f; /**< Pixels per second. */
+	const float ANGULAR_SLEEP_TOLERANCE = 0.035f; /**< Radians per second. */
+
+	/**
+	*   @brief   Mass and rotational inertia of a polygon.
+	*   @details Sums the triangles fanning out from the origin, which
+	             should be the polygon's centroid.
+	*   @return  void
+	*/
+	void polygonMass(const polygon& poly, float density, float& mass, float& inertia)
+	{
+		float area = 0.0f;
+		float second_moment = 0.0f;
+		for (int i = 0; i < poly.count; i++)
+		{
+			const vector2& e1 = poly.vertices[i];
+			const vector2& e2 = poly.vertices[i + 1 < poly.count ? i + 1 : 0];
+			float cross = e1.x * e2.y - e1.y * e2.x;
+			area += 0.5f * cross;
+
+			float int_x2 = e1.x * e1.x + e2.x * e1.x + e2.x * e2.x;
+			float int_y2 = e1.y * e1.y + e2.y * e1.y + e2.y * e2.y;
+			second_moment += (0.25f / 3.0f) * cross * (int_x2 + int_y2);
+		}
+
+		mass = density * area;
+		inertia = density * second_moment;
+	}
+
+	unsigned long long pairKey(int body_a, int body_b)
+	{
+		if (body_a > body_b)
+		{
+			int swap = body_a;
+			body_a = body_b;
+			body_b = swap;
+		}
+
+		return (static_cast<unsigned long long>(body_a) << 32) |
+			static_cast<unsigned long long>(static_cast<unsigned int>(body_b));
+	}
+}
+
+PhysicsWorld::PhysicsWorld()
+{
+	grid_pairs.reserve(256);
+	query_results.reserve(64);
+	candidates.reserve(64);
+	pairs.reserve(256);
+	arbiters.reserve(256);
+	previous_arbiters.reserve(256);
+	reports.reserve(256);
+	pending_wakes.reserve(64);
+}
+
+/**
+*   @brief   Adds a body to the world.
+*   @details Mass and rotational inertia are derived from the shape and
+             density. Moving bodies are placed in the dynamic grid and
+			 static bodies in the static tree.
+*   @return  The id of the new body.
+*/
+int PhysicsWorld::createBody(const body_def& def)
+{
+	int body = 0;
+	if (!free_bodies.empty())
+	{
+		body = free_bodies.back();
+		free_bodies.pop_back();
+	}
+	else
+	{
+		body = static_cast<int>(alive.size());
+		pos_x.push_back(0); pos_y.push_back(0); rotation.push_back(0);
+		prev_x.push_back(0); prev_y.push_back(0); prev_rotation.push_back(0);
+		vel_x.push_back(0); vel_y.push_back(0); ang_vel.push_back(0);
+		inv_mass.push_back(0); inv_inertia.push_back(0);
+		radii.push_back(0);
+		local_shapes.push_back(polygon());
+		world_shapes.push_back(polygon());
+		restitution.push_back(0); friction.push_back(0);
+		shapes.push_back(ShapeType::BOX);
+		entities.push_back(-1);
+		proxies.push_back(-1);
+		alive.push_back(0);
+		bullets.push_back(0);
+		awake_bodies.push_back(0);
+		sleep_time.push_back(0);
+		islands.push_back(body);
+		island_links.push_back(body);
+	}
+
+	pos_x[body] = prev_x[body] = def.position.x;
+	pos_y[body] = prev_y[body] = def.position.y;
+	rotation[body] = prev_rotation[body] = def.angle;
+	vel_x[body] = def.velocity.x;
+	vel_y[body] = def.velocity.y;
+	ang_vel[body] = def.angular_velocity;
+	radii[body] = def.shape == ShapeType::CIRCLE ? def.half_width : 0.0f;
+	restitution[body] = def.restitution;
+	friction[body] = def.friction;
+	shapes[body] = def.shape;
+	entities[body] = def.entity;
+	alive[body] = 1;
+	bullets[body] = def.bullet ? 1 : 0;
+
+	float mass = 0.0f;
+	float inertia = 0.0f;
+	if (def.shape == ShapeType::CIRCLE)
+	{
+		float radius = def.half_width;
+		mass = def.density * PI * radius * radius;
+		inertia = 0.5f * mass * radius * radius;
+
+		local_shapes[body] = polygon();
+		local_shapes[body].count = 1;
+	}
+	else
+	{
+		local_shapes[body] = def.shape == ShapeType::BOX ?
+			makeBox(vector2(0.0f, 0.0f), def.half_width, def.half_height, 0.0f) :
+			def.local_shape;
+		polygonMass(local_shapes[body], def.density, mass, inertia);
+	}
+
+	updateShape(body);
+
+	inv_mass[body] = mass > 0.0f ? 1.0f / mass : 0.0f;
+	inv_inertia[body] = inertia > 0.0f ? 1.0f / inertia : 0.0f;
+
+	if (!isDynamic(body))
+	{
+		vel_x[body] = vel_y[body] = ang_vel[body] = 0.0f;
+	}
+
+	awake_bodies[body] = isDynamic(body) ? 1 : 0;
+	sleep_time[body] = 0.0f;
+	islands[body] = body;
+
+	int proxy = 0;
+	if (isDynamic(body))
+	{
+		proxy = dynamic_grid.insert(bounds(body));
+		if (proxy >= static_cast<int>(grid_body.size()))
+		{
+			grid_body.resize(proxy + 1, -1);
+		}
+		grid_body[proxy] = body;
+	}
+	else
+	{
+		proxy = static_tree.insert(bounds(body));
+		if (proxy >= static_cast<int>(tree_body.size()))
+		{
+			tree_body.resize(proxy + 1, -1);
+		}
+		tree_body[proxy] = body;
+	}
+
+	proxies[body] = proxy;
+	return body;
+}
+
+/**
+*   @brief   Removes a body from the world.
+*   @details Any contacts involving the body are dropped so their
+             impulses aren't handed to a new body reusing the id, and
+			 anything that was resting on it is woken.
+*   @return  void
+*/
+void PhysicsWorld::destroyBody(int body)
+{
+	if (body < 0 || body >= static_cast<int>(alive.size()) || !alive[body])
+	{
+		return;
+	}
+
+	if (isDynamic(body))
+	{
+		dynamic_grid.remove(proxies[body]);
+	}
+	else
+	{
+		static_tree.remove(proxies[body]);
+	}
+
+	for (const arbiter& arb : arbiters)
+	{
+		if (arb.body_a == body || arb.body_b == body)
+		{
+			wake(arb.body_a == body ? arb.body_b : arb.body_a);
+		}
+	}
+
+	arbiters.erase(std::remove_if(arbiters.begin(), arbiters.end(),
+		[body](const arbiter& arb)
+		{
+			return arb.body_a == body || arb.body_b == body;
+		}), arbiters.end());
+
+	alive[body] = 0;
+	awake_bodies[body] = 0;
+	inv_mass[body] = 0.0f;
+	inv_inertia[body] = 0.0f;
+	vel_x[body] = vel_y[body] = ang_vel[body] = 0.0f;
+	entities[body] = -1;
+	proxies[body] = -1;
+	free_bodies.push_back(body);
+}
+
+void PhysicsWorld::clear()
+{
+	pos_x.clear(); pos_y.clear(); rotation.clear();
+	prev_x.clear(); prev_y.clear(); prev_rotation.clear();
+	vel_x.clear(); vel_y.clear(); ang_vel.clear();
+	inv_mass.clear(); inv_inertia.clear();
+	radii.clear();
+	local_shapes.clear();
+	world_shapes.clear();
+	restitution.clear(); friction.clear();
+	shapes.clear();
+	entities.clear();
+	proxies.clear();
+	alive.clear();
+	bullets.clear();
+	awake_bodies.clear();
+	sleep_time.clear();
+	islands.clear();
+	island_links.clear();
+	free_bodies.clear();
+
+	dynamic_grid.clear();
+	static_tree.clear();
+	grid_body.clear();
+	tree_body.clear();
+
+	arbiters.clear();
+	previous_arbiters.clear();
+	reports.clear();
+	pending_wakes.clear();
+}
+
+/**
+*   @brief   Advances the simulation by a single step.
+*   @details Contacts are generated from the current positions, then
+             gravity is applied and the contacts solved. The resulting
+			 velocities are integrated and the broadphase updated.
+			 Sleeping bodies are skipped throughout. Each island is
+			 solved as a separate task on the thread pool.
+*   @return  void
+*/
+void PhysicsWorld::step(float dt_sec)
+{
+	if (dt_sec <= 0.0f)
+	{
+		return;
+	}
+
+	const int count = static_cast<int>(alive.size());
+
+	for (int i = 0; i < count; i++)
+	{
+		prev_x[i] = pos_x[i];
+		prev_y[i] = pos_y[i];
+		prev_rotation[i] = rotation[i];
+	}
+
+	findPairs();
+	updateContacts();
+
+	// only awake bodies move, static and destroyed ones never wake
+	const float gravity_dx = gravity_x * dt_sec;
+	const float gravity_dy = gravity_y * dt_sec;
+	for (int i = 0; i < count; i++)
+	{
+		if (awake_bodies[i])
+		{
+			vel_x[i] += gravity_dx;
+			vel_y[i] += gravity_dy;
+		}
+	}
+
+	buildIslands();
+
+	const float inv_dt = 1.0f / dt_sec;
+	const int island_count = static_cast<int>(island_offsets.size()) - 1;
+	if (thread_pool && island_count > 1)
+	{
+		thread_pool->run(island_count, [this, inv_dt](int island)
+		{
+			solveIsland(island, inv_dt);
+		});
+	}
+	else
+	{
+		for (int i = 0; i < island_count; i++)
+		{
+			solveIsland(i, inv_dt);
+		}
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		if (awake_bodies[i])
+		{
+			pos_x[i] += vel_x[i] * dt_sec;
+			pos_y[i] += vel_y[i] * dt_sec;
+			rotation[i] += ang_vel[i] * dt_sec;
+		}
+	}
+
+	sweepBullets();
+	updateBroadphase();
+	updateIslands(dt_sec);
+
+	reports.clear();
+	for (const arbiter& arb : arbiters)
+	{
+		if (!isActive(arb))
+		{
+			continue;
+		}
+
+		contact_report report;
+		report.body_a = arb.body_a;
+		report.body_b = arb.body_b;
+		report.normal = arb.contact.normal;
+		for (int i = 0; i < arb.contact.count; i++)
+		{
+			report.impulse += arb.points[i].normal_impulse;
+		}
+		reports.push_back(report);
+	}
+}
+
+void PhysicsWorld::applyImpulse(int body, const vector2& impulse, const vector2& point)
+{
+	wake(body);
+
+	float r_x = point.x - pos_x[body];
+	float r_y = point.y - pos_y[body];
+	vel_x[body] += inv_mass[body] * impulse.x;
+	vel_y[body] += inv_mass[body] * impulse.y;
+	ang_vel[body] += inv_inertia[body] * (r_x * impulse.y - r_y * impulse.x);
+}
+
+vector2 PhysicsWorld::position(int body) const
+{
+	return vector2(pos_x[body], pos_y[body]);
+}
+
+vector2 PhysicsWorld::velocity(int body) const
+{
+	return vector2(vel_x[body], vel_y[body]);
+}
+
+float PhysicsWorld::angle(int body) const
+{
+	return rotation[body];
+}
+
+vector2 PhysicsWorld::interpolatedPosition(int body, float alpha) const
+{
+	return vector2(
+		prev_x[body] + (pos_x[body] - prev_x[body]) * alpha,
+		prev_y[body] + (pos_y[body] - prev_y[body]) * alpha);
+}
+
+float PhysicsWorld::interpolatedAngle(int body, float alpha) const
+{
+	return prev_rotation[body] + (rotation[body] - prev_rotation[body]) * alpha;
+}
+
+bool PhysicsWorld::awake(int body) const
+{
+	return awake_bodies[body] != 0;
+}
+
+/**
+*   @brief   Wakes a body's island.
+*   @details Islands are rebuilt every step, so every body sharing the
+             body's island id was touching it when it fell asleep.
+			 Only the island's ring is walked. A body made since the
+			 islands were built is still linked into its id's old
+			 ring, so each body's island id is checked as well.
+*   @return  void
+*/
+void PhysicsWorld::wake(int body)
+{
+	if (body < 0 || body >= static_cast<int>(alive.size()) ||
+		!alive[body] || !isDynamic(body) || awake_bodies[body])
+	{
+		return;
+	}
+
+	const int island = islands[body];
+	int i = body;
+	do
+	{
+		if (alive[i] && !awake_bodies[i] && islands[i] == island && isDynamic(i))
+		{
+			awake_bodies[i] = 1;
+			sleep_time[i] = 0.0f;
+		}
+		i = island_links[i];
+	} while (i != body);
+}
+
+int PhysicsWorld::entity(int body) const
+{
+	return entities[body];
+}
+
+const std::vector<contact_report>& PhysicsWorld::contacts() const
+{
+	return reports;
+}
+
+void PhysicsWorld::gravity(const vector2& acceleration)
+{
+	gravity_x = acceleration.x;
+	gravity_y = acceleration.y;
+}
+
+void PhysicsWorld::iterations(int count)
+{
+	solver_iterations = count < 1 ? 1 : count;
+}
+
+void PhysicsWorld::threadPool(ThreadPool* pool)
+{
+	thread_pool = pool;
+}
+
+/**
+*   @brief   Finds the pairs of bodies that may be touching.
+*   @details Moving pairs come straight from the dynamic grid. Each
+             moving body then queries the static tree, with the
+			 candidates' tight bounds being tested in a single batch
+			 as the tree only stores fattened bounds. The pairs are
+			 sorted so the contacts are always solved in the same order.
+			 Pairs without an awake body are left out entirely.
+*   @return  void
+*/
+void PhysicsWorld::findPairs()
+{
+	pairs.clear();
+
+	grid_pairs.clear();
+	dynamic_grid.queryPairs(grid_pairs);
+	for (const auto& pair : grid_pairs)
+	{
+		int body_a = grid_body[pair.first];
+		int body_b = grid_body[pair.second];
+		if (awake_bodies[body_a] || awake_bodies[body_b])
+		{
+			pairs.push_back(pairKey(body_a, body_b));
+		}
+	}
+
+	const int count = static_cast<int>(alive.size());
+	for (int body = 0; body < count; body++)
+	{
+		if (!awake_bodies[body])
+		{
+			continue;
+		}
+
+		rect body_bounds = bounds(body);
+		query_results.clear();
+		static_tree.query(body_bounds, query_results);
+		if (query_results.empty())
+		{
+			continue;
+		}
+
+		candidates.clear();
+		candidate_bounds.clear();
+		for (int proxy : query_results)
+		{
+			int other = tree_body[proxy];
+			candidates.push_back(other);
+			candidate_bounds.add(bounds(other));
+		}
+
+		if (candidate_bounds.overlaps(body_bounds, candidate_mask) == 0)
+		{
+			continue;
+		}
+
+		for (int i = 0; i < static_cast<int>(candidates.size()); i++)
+		{
+			if (candidate_mask[i >> 5] & (1u << (i & 31)))
+			{
+				pairs.push_back(pairKey(body, candidates[i]));
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+}
+
+/**
+*   @brief   Generates the contact between two bodies.
+*   @details Picks the routine for the pair of shapes, using the world
+             shapes cached when the bodies last moved. Boxes are just
+			 four sided polygons. The normal is flipped when the shapes
+			 had to be passed in reverse.
+*   @return  True if the bodies are touching.
+*/
+bool PhysicsWorld::collide(int body_a, int body_b, manifold& result) const
+{
+	const bool circle_a = shapes[body_a] == ShapeType::CIRCLE;
+	const bool circle_b = shapes[body_b] == ShapeType::CIRCLE;
+	vector2 centre_a(pos_x[body_a], pos_y[body_a]);
+	vector2 centre_b(pos_x[body_b], pos_y[body_b]);
+
+	if (circle_a && circle_b)
+	{
+		return collideCircles(centre_a, radii[body_a], centre_b, radii[body_b], result);
+	}
+
+	if (circle_b)
+	{
+		return collidePolygonCircle(world_shapes[body_a], centre_b, radii[body_b], result);
+	}
+
+	if (circle_a)
+	{
+		if (!collidePolygonCircle(world_shapes[body_b], centre_a, radii[body_a], result))
+		{
+			return false;
+		}
+
+		result.normal.x = -result.normal.x;
+		result.normal.y = -result.normal.y;
+		return true;
+	}
+
+	return collidePolygons(world_shapes[body_a], world_shapes[body_b], result);
+}
+
+/**
+*   @brief   Rebuilds the contact list.
+*   @details Both the new and old lists are sorted by pair key, so they
+             can be walked together. When a pair was touching last step,
+			 the impulses of any contact points sharing a feature id are
+			 carried over to warm start the solver. Contacts between
+			 sleeping bodies are kept as they are without being tested,
+			 and sleeping bodies touched by awake ones are woken once
+			 the list is complete.
+*   @return  void
+*/
+void PhysicsWorld::updateContacts()
+{
+	std::swap(arbiters, previous_arbiters);
+	arbiters.clear();
+	pending_wakes.clear();
+
+	size_t old = 0;
+	for (unsigned long long key : pairs)
+	{
+		while (old < previous_arbiters.size() && previous_arbiters[old].key < key)
+		{
+			if (!isActive(previous_arbiters[old]))
+			{
+				arbiters.push_back(previous_arbiters[old]);
+			}
+			old++;
+		}
+
+		int body_a = static_cast<int>(key >> 32);
+		int body_b = static_cast<int>(key & 0xffffffff);
+
+		arbiter arb;
+		if (!collide(body_a, body_b, arb.contact))
+		{
+			continue;
+		}
+
+		arb.key = key;
+		arb.body_a = body_a;
+		arb.body_b = body_b;
+		arb.friction = sqrtf(friction[body_a] * friction[body_b]);
+		arb.restitution = std::max(restitution[body_a], restitution[body_b]);
+
+		if (!awake_bodies[body_a] || !awake_bodies[body_b])
+		{
+			pending_wakes.push_back(awake_bodies[body_a] ? body_b : body_a);
+		}
+
+		if (old < previous_arbiters.size() && previous_arbiters[old].key == key)
+		{
+			const arbiter& last = previous_arbiters[old];
+			for (int i = 0; i < arb.contact.count; i++)
+			{
+				for (int j = 0; j < last.contact.count; j++)
+				{
+					if (arb.contact.points[i].id == last.contact.points[j].id)
+					{
+						arb.points[i].normal_impulse = last.points[j].normal_impulse;
+						arb.points[i].tangent_impulse = last.points[j].tangent_impulse;
+						break;
+					}
+				}
+			}
+		}
+
+		arbiters.push_back(arb);
+	}
+
+	for (; old < previous_arbiters.size(); old++)
+	{
+		if (!isActive(previous_arbiters[old]))
+		{
+			arbiters.push_back(previous_arbiters[old]);
+		}
+	}
+
+	for (int body : pending_wakes)
+	{
+		wake(body);
+	}
+}
+
+/**
+*   @brief   Prepares the contacts for solving.
+*   @details Calculates the effective mass along the normal and tangent
+             of every contact point in an island and the velocity bias
+			 used to push overlapping bodies apart or make them bounce.
+			 The impulses carried over from last step are then applied
+			 up front.
+*   @return  void
+*/
+void PhysicsWorld::preStep(int island, float inv_dt)
+{
+	for (int contact = island_offsets[island]; contact < island_offsets[island + 1]; contact++)
+	{
+		arbiter& arb = arbiters[island_contacts[contact]];
+		const int a = arb.body_a;
+		const int b = arb.body_b;
+		const float n_x = arb.contact.normal.x;
+		const float n_y = arb.contact.normal.y;
+		const float t_x = n_y;
+		const float t_y = -n_x;
+
+		for (int i = 0; i < arb.contact.count; i++)
+		{
+			const contact_point& cp = arb.contact.points[i];
+			solver_point& sp = arb.points[i];
+
+			sp.ra_x = cp.position.x - pos_x[a];
+			sp.ra_y = cp.position.y - pos_y[a];
+			sp.rb_x = cp.position.x - pos_x[b];
+			sp.rb_y = cp.position.y - pos_y[b];
+
+			float rn_a = sp.ra_x * n_y - sp.ra_y * n_x;
+			float rn_b = sp.rb_x * n_y - sp.rb_y * n_x;
+			float k_normal = inv_mass[a] + inv_mass[b] +
+				inv_inertia[a] * rn_a * rn_a + inv_inertia[b] * rn_b * rn_b;
+			sp.normal_mass = k_normal > 0.0f ? 1.0f / k_normal : 0.0f;
+
+			float rt_a = sp.ra_x * t_y - sp.ra_y * t_x;
+			float rt_b = sp.rb_x * t_y - sp.rb_y * t_x;
+			float k_tangent = inv_mass[a] + inv_mass[b] +
+				inv_inertia[a] * rt_a * rt_a + inv_inertia[b] * rt_b * rt_b;
+			sp.tangent_mass = k_tangent > 0.0f ? 1.0f / k_tangent : 0.0f;
+
+			float penetration = cp.separation + LINEAR_SLOP;
+			sp.bias = penetration < 0.0f ? -BAUMGARTE * inv_dt * penetration : 0.0f;
+
+			float dv_x = vel_x[b] - ang_vel[b] * sp.rb_y - vel_x[a] + ang_vel[a] * sp.ra_y;
+			float dv_y = vel_y[b] + ang_vel[b] * sp.rb_x - vel_y[a] - ang_vel[a] * sp.ra_x;
+			float approach = dv_x * n_x + dv_y * n_y;
+			if (approach < -RESTITUTION_THRESHOLD)
+			{
+				sp.bias = std::max(sp.bias, -arb.restitution * approach);
+			}
+
+			float p_x = sp.normal_impulse * n_x + sp.tangent_impulse * t_x;
+			float p_y = sp.normal_impulse * n_y + sp.tangent_impulse * t_y;
+			applyContactImpulse(a, b, sp, p_x, p_y);
+		}
+	}
+}
+
+/**
+*   @brief   Runs a single iteration of the contact solver on an island.
+*   @details Every contact point has a friction impulse applied along
+             its tangent, bounded by the normal impulse, followed by a
+			 normal impulse stopping the bodies moving into each other.
+			 Impulses are accumulated and clamped rather than each
+			 increment, which lets later iterations correct earlier ones.
+*   @return  void
+*/
+void PhysicsWorld::solveVelocities(int island)
+{
+	for (int contact = island_offsets[island]; contact < island_offsets[island + 1]; contact++)
+	{
+		arbiter& arb = arbiters[island_contacts[contact]];
+		const int a = arb.body_a;
+		const int b = arb.body_b;
+		const float n_x = arb.contact.normal.x;
+		const float n_y = arb.contact.normal.y;
+		const float t_x = n_y;
+		const float t_y = -n_x;
+
+		for (int i = 0; i < arb.contact.count; i++)
+		{
+			solver_point& sp = arb.points[i];
+
+			// friction
+			float dv_x = vel_x[b] - ang_vel[b] * sp.rb_y - vel_x[a] + ang_vel[a] * sp.ra_y;
+			float dv_y = vel_y[b] + ang_vel[b] * sp.rb_x - vel_y[a] - ang_vel[a] * sp.ra_x;
+			float vt = dv_x * t_x + dv_y * t_y;
+
+			float max_friction = arb.friction * sp.normal_impulse;
+			float tangent_impulse = sp.tangent_impulse - sp.tangent_mass * vt;
+			tangent_impulse = std::max(-max_friction, std::min(tangent_impulse, max_friction));
+			float dpt = tangent_impulse - sp.tangent_impulse;
+			sp.tangent_impulse = tangent_impulse;
+
+			applyContactImpulse(a, b, sp, dpt * t_x, dpt * t_y);
+
+			// non-penetration
+			dv_x = vel_x[b] - ang_vel[b] * sp.rb_y - vel_x[a] + ang_vel[a] * sp.ra_y;
+			dv_y = vel_y[b] + ang_vel[b] * sp.rb_x - vel_y[a] - ang_vel[a] * sp.ra_x;
+			float vn = dv_x * n_x + dv_y * n_y;
+
+			float normal_impulse = std::max(sp.normal_impulse + sp.normal_mass * (sp.bias - vn), 0.0f);
+			float dpn = normal_impulse - sp.normal_impulse;
+			sp.normal_impulse = normal_impulse;
+
+			applyContactImpulse(a, b, sp, dpn * n_x, dpn * n_y);
+		}
+	}
+}
+
+void PhysicsWorld::solveIsland(int island, float inv_dt)
+{
+	preStep(island, inv_dt);
+	for (int i = 0; i < solver_iterations; i++)
+	{
+		solveVelocities(island);
+	}
+}
+
+/**
+*   @brief   Applies a contact impulse to both bodies.
+*   @details The impulse pushes body_b and the opposite pushes body_a.
+             Static bodies may be shared by several islands solved at
+			 once, so they are never written to.
+*   @return  void
+*/
+void PhysicsWorld::applyContactImpulse(int body_a, int body_b, const solver_point& point, float p_x, float p_y)
+{
+	if (inv_mass[body_a] > 0.0f)
+	{
+		vel_x[body_a] -= inv_mass[body_a] * p_x;
+		vel_y[body_a] -= inv_mass[body_a] * p_y;
+		ang_vel[body_a] -= inv_inertia[body_a] * (point.ra_x * p_y - point.ra_y * p_x);
+	}
+
+	if (inv_mass[body_b] > 0.0f)
+	{
+		vel_x[body_b] += inv_mass[body_b] * p_x;
+		vel_y[body_b] += inv_mass[body_b] * p_y;
+		ang_vel[body_b] += inv_inertia[body_b] * (point.rb_x * p_y - point.rb_y * p_x);
+	}
+}
+
+/**
+*   @brief   Stops bullets passing through other bodies.
+*   @details Each bullet's motion over the step is swept against the
+             shape of every body near its path, rotated as it is. If
+			 it would have hit one part way through the step, the
+			 bullet is moved back to the point of impact and the solver
+			 resolves the contact next step. Bodies it already overlaps
+			 are left to the solver.
+*   @return  void
+*/
+void PhysicsWorld::sweepBullets()
+{
+	const int count = static_cast<int>(alive.size());
+	for (int body = 0; body < count; body++)
+	{
+		if (!awake_bodies[body] || !bullets[body])
+		{
+			continue;
+		}
+
+		vector2 motion(pos_x[body] - prev_x[body], pos_y[body] - prev_y[body]);
+		float radius = radii[body];
+		vector2 start(prev_x[body], prev_y[body]);
+
+		rect start_bounds;
+		start_bounds.x = start.x - radius;
+		start_bounds.y = start.y - radius;
+		start_bounds.length = 2.0f * radius;
+		start_bounds.height = 2.0f * radius;
+		rect swept = sweptBounds(start_bounds, motion);
+
+		candidates.clear();
+		query_results.clear();
+		static_tree.query(swept, query_results);
+		for (int proxy : query_results)
+		{
+			candidates.push_back(tree_body[proxy]);
+		}
+
+		query_results.clear();
+		dynamic_grid.query(swept, query_results);
+		for (int proxy : query_results)
+		{
+			if (grid_body[proxy] != body)
+			{
+				candidates.push_back(grid_body[proxy]);
+			}
+		}
+
+		float earliest = 1.0f;
+		sweep_hit hit;
+		for (int other : candidates)
+		{
+			bool touched = false;
+			if (shapes[other] == ShapeType::CIRCLE)
+			{
+				touched = sweepCircleCircle(start, radius, motion,
+					vector2(pos_x[other], pos_y[other]), radii[other], hit);
+			}
+			else
+			{
+				touched = sweepCirclePolygon(start, radius, motion, world_shapes[other], hit);
+			}
+
+			if (touched && hit.time > 0.0f && hit.time < earliest)
+			{
+				earliest = hit.time;
+			}
+		}
+
+		if (earliest < 1.0f)
+		{
+			pos_x[body] = start.x + motion.x * earliest;
+			pos_y[body] = start.y + motion.y * earliest;
+		}
+	}
+}
+
+void PhysicsWorld::updateBroadphase()
+{
+	const int count = static_cast<int>(alive.size());
+	for (int body = 0; body < count; body++)
+	{
+		if (awake_bodies[body])
+		{
+			updateShape(body);
+			dynamic_grid.update(proxies[body], bounds(body));
+		}
+	}
+}
+
+/**
+*   @brief   Splits the contacts into islands.
+*   @details The contact graph is split using union find, with static
+             bodies being left out so that everything on the ground
+			 doesn't become one island. Roots are always the lowest id
+			 in an island. Contacts needing solving are then grouped by
+			 island, in key order, with islands numbered in the order
+			 their first contact appears. This keeps the grouping the
+			 same from run to run. Each island's bodies are also linked
+			 into a ring, so waking an island visits only its bodies.
+*   @return  void
+*/
+void PhysicsWorld::buildIslands()
+{
+	const int count = static_cast<int>(alive.size());
+	for (int i = 0; i < count; i++)
+	{
+		islands[i] = i;
+	}
+
+	for (const arbiter& arb : arbiters)
+	{
+		if (isDynamic(arb.body_a) && isDynamic(arb.body_b))
+		{
+			int island_a = findIsland(arb.body_a);
+			int island_b = findIsland(arb.body_b);
+			if (island_a != island_b)
+			{
+				islands[std::max(island_a, island_b)] = std::min(island_a, island_b);
+			}
+		}
+	}
+
+	// a root is always below the rest of its island, so its ring is
+	// started before any other body joins it
+	for (int i = 0; i < count; i++)
+	{
+		const int root = findIsland(i);
+		islands[i] = root;
+		if (root == i)
+		{
+			island_links[i] = i;
+		}
+		else
+		{
+			island_links[i] = island_links[root];
+			island_links[root] = i;
+		}
+	}
+
+	const int contact_count = static_cast<int>(arbiters.size());
+	island_ids.assign(count, -1);
+	contact_islands.assign(contact_count, -1);
+	island_offsets.assign(1, 0);
+
+	for (int i = 0; i < contact_count; i++)
+	{
+		const arbiter& arb = arbiters[i];
+		if (!isActive(arb))
+		{
+			continue;
+		}
+
+		int root = islands[isDynamic(arb.body_a) ? arb.body_a : arb.body_b];
+		if (island_ids[root] < 0)
+		{
+			island_ids[root] = static_cast<int>(island_offsets.size()) - 1;
+			island_offsets.push_back(0);
+		}
+
+		contact_islands[i] = island_ids[root];
+		island_offsets[island_ids[root] + 1]++;
+	}
+
+	const int island_count = static_cast<int>(island_offsets.size()) - 1;
+	for (int i = 0; i < island_count; i++)
+	{
+		island_offsets[i + 1] += island_offsets[i];
+	}
+
+	// counting sort, filling each island from its start
+	island_contacts.resize(island_offsets[island_count]);
+	island_ids.assign(island_offsets.begin(), island_offsets.end() - 1);
+	for (int i = 0; i < contact_count; i++)
+	{
+		if (contact_islands[i] >= 0)
+		{
+			island_contacts[island_ids[contact_islands[i]]++] = i;
+		}
+	}
+}
+
+/**
+*   @brief   Puts still islands to sleep.
+*   @details Bodies moving slower than the tolerances accumulate sleep
+             time. An island sleeps once all of its bodies have been
+			 still long enough.
+*   @return  void
+*/
+void PhysicsWorld::updateIslands(float dt_sec)
+{
+	const int count = static_cast<int>(alive.size());
+	const float linear_tolerance = LINEAR_SLEEP_TOLERANCE * LINEAR_SLEEP_TOLERANCE;
+	const float angular_tolerance = ANGULAR_SLEEP_TOLERANCE * ANGULAR_SLEEP_TOLERANCE;
+
+	for (int i = 0; i < count; i++)
+	{
+		if (!awake_bodies[i])
+		{
+			continue;
+		}
+
+		float speed = vel_x[i] * vel_x[i] + vel_y[i] * vel_y[i];
+		float spin = ang_vel[i] * ang_vel[i];
+		if (speed > linear_tolerance || spin > angular_tolerance)
+		{
+			sleep_time[i] = 0.0f;
+		}
+		else
+		{
+			sleep_time[i] += dt_sec;
+		}
+	}
+
+	island_sleep.assign(count, TIME_TO_SLEEP);
+	for (int i = 0; i < count; i++)
+	{
+		if (awake_bodies[i])
+		{
+			island_sleep[islands[i]] = std::min(island_sleep[islands[i]], sleep_time[i]);
+		}
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		if (awake_bodies[i] && island_sleep[islands[i]] >= TIME_TO_SLEEP)
+		{
+			awake_bodies[i] = 0;
+			vel_x[i] = vel_y[i] = ang_vel[i] = 0.0f;
+		}
+	}
+}
+
+int PhysicsWorld::findIsland(int body)
+{
+	while (islands[body] != body)
+	{
+		islands[body] = islands[islands[body]];
+		body = islands[body];
+	}
+	return body;
+}
+
+bool PhysicsWorld::isActive(const arbiter& arb) const
+{
+	return awake_bodies[arb.body_a] || awake_bodies[arb.body_b];
+}
+
+/**
+*   @brief   Axis aligned bounds of a body.
+*   @details Circles are bounded by their radius and everything else
+             by the corners of its cached world shape.
+*   @return  The smallest rectangle containing the body.
+*/
+rect PhysicsWorld::bounds(int body) const
+{
+	rect box;
+	if (shapes[body] == ShapeType::CIRCLE)
+	{
+		box.x = pos_x[body] - radii[body];
+		box.y = pos_y[body] - radii[body];
+		box.length = 2.0f * radii[body];
+		box.height = 2.0f * radii[body];
+		return box;
+	}
+
+	const polygon& shape = world_shapes[body];
+	float min_x = shape.vertices[0].x, max_x = min_x;
+	float min_y = shape.vertices[0].y, max_y = min_y;
+	for (int i = 1; i < shape.count; i++)
+	{
+		min_x = std::min(min_x, shape.vertices[i].x);
+		max_x = std::max(max_x, shape.vertices[i].x);
+		min_y = std::min(min_y, shape.vertices[i].y);
+		max_y = std::max(max_y, shape.vertices[i].y);
+	}
+
+	box.x = min_x;
+	box.y = min_y;
+	box.length = max_x - min_x;
+	box.height = max_y - min_y;
+	return box;
+}
+
+void PhysicsWorld::updateShape(int body)
+{
+	world_shapes[body] = transformPolygon(local_shapes[body],
+		vector2(pos_x[body], pos_y[body]), rotation[body]);
+}
+
+bool PhysicsWorld::isDynamic(int body) const
+{
+	return inv_mass[body] > 0.0f;
+}
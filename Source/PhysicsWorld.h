@@ -0,0 +1,290 @@
+#pragma once
+#include <vector>
+
+#include "AABBTree.h"
+#include "Narrowphase.h"
+#include "RectBatch.h"
+#include "SpatialHash.h"
+#include "Vector2.h"
+
+class ThreadPool;
+
+/**
+*  The shapes a rigid body may have.
+*/
+enum class ShapeType
+{
+	CIRCLE, /**< A circle, using half_width as the radius. */
+	BOX,    /**< An oriented box. */
+	POLYGON /**< A convex polygon, given by local_shape. */
+};
+
+/**
+*  Describes a rigid body to be created.
+*  Positions are the centre of the body, in the same pixel space
+*  the sprites use. A density of zero creates a static body.
+*/
+struct body_def
+{
+	ShapeType   shape = ShapeType::BOX;
+	vector2     position;              /**< Centre of the body. */
+	vector2     velocity;              /**< Initial linear velocity in pixels per second. */
+	float       angle = 0.0f;          /**< Rotation in radians. */
+	float       angular_velocity = 0.0f;
+	float       half_width = 0.5f;     /**< Radius when the shape is a circle. */
+	float       half_height = 0.5f;
+	polygon     local_shape;           /**< Corners around the centre when the shape is a polygon. */
+	float       density = 0.001f;      /**< Mass per square pixel, zero for static bodies. */
+	float       restitution = 0.1f;
+	float       friction = 0.6f;
+	bool        bullet = false;        /**< Sweeps its motion to stop it tunnelling. */
+	int         entity = -1;           /**< The entity the body moves. */
+};
+
+/**
+*  The contact between two bodies over the last step.
+*/
+struct contact_report
+{
+	int     body_a = -1;
+	int     body_b = -1;
+	vector2 normal;                    /**< Points from body_a towards body_b. */
+	float   impulse = 0.0f;            /**< The total normal impulse applied. */
+};
+
+/**
+*  A 2D rigid body simulation.
+*  Bodies have mass, rotational inertia, restitution and friction, and
+*  are stored as a structure of arrays so the integration loops run
+*  over contiguous memory. Contacts are found using a two part
+*  broadphase: moving bodies live in a spatial hash that reports their
+*  overlapping pairs, while static bodies, which vary wildly in size,
+*  live in an AABB tree that each moving body queries. Contacts are
+*  resolved by a sequential impulse solver, which is warm started
+*  using the impulses applied to the same features last step so that
+*  stacks settle in a handful of iterations.
+*  Bodies touching each other form islands. Once every body in an
+*  island has been still for a while, the whole island is put to sleep
+*  and skipped until something touches it or an impulse is applied.
+*  Islands share no moving bodies, so they are solved in parallel when
+*  a thread pool is given. Each island is always solved in the same
+*  order, so the results don't depend on the number of threads.
+*  @see PhysicsStepper
+*  @see ThreadPool
+*/
+class PhysicsWorld
+{
+public:
+
+	/**
+	*  Default constructor.
+	*/
+	PhysicsWorld();
+
+	/**
+	*  Adds a body to the world.
+	*  @param [in] def The description of the body
+	*  @return the id of the body
+	*/
+	int  createBody(const body_def& def);
+
+	/**
+	*  Removes a body from the world.
+	*  The id is freed and may be handed out again.
+	*  @param [in] body The id of the body
+	*/
+	void destroyBody(int body);
+
+	/**
+	*  Removes every body from the world.
+	*/
+	void clear();
+
+	/**
+	*  Advances the simulation.
+	*  Should be called with a fixed step size for stable results.
+	*  @param [in] dt_sec The step size in seconds
+	*/
+	void step(float dt_sec);
+
+	/**
+	*  Applies an impulse at a point on a body.
+	*  @param [in] body The id of the body
+	*  @param [in] impulse The impulse to apply
+	*  @param [in] point The point in world space to apply it at
+	*/
+	void applyImpulse(int body, const vector2& impulse, const vector2& point);
+
+	/**
+	*  Returns the position of a body.
+	*  @param [in] body The id of the body
+	*  @return the centre of the body
+	*/
+	vector2 position(int body) const;
+
+	/**
+	*  Returns the velocity of a body.
+	*  @param [in] body The id of the body
+	*  @return the linear velocity in pixels per second
+	*/
+	vector2 velocity(int body) const;
+
+	/**
+	*  Returns the rotation of a body.
+	*  @param [in] body The id of the body
+	*  @return the angle in radians
+	*/
+	float angle(int body) const;
+
+	/**
+	*  Blends a body's position between the last two steps.
+	*  @param [in] body The id of the body
+	*  @param [in] alpha The blend factor from the stepper
+	*  @return the interpolated centre of the body
+	*/
+	vector2 interpolatedPosition(int body, float alpha) const;
+
+	/**
+	*  Blends a body's rotation between the last two steps.
+	*  @param [in] body The id of the body
+	*  @param [in] alpha The blend factor from the stepper
+	*  @return the interpolated angle in radians
+	*/
+	float interpolatedAngle(int body, float alpha) const;
+
+	/**
+	*  Returns whether a body is being simulated.
+	*  @param [in] body The id of the body
+	*  @return false if the body is asleep or static
+	*/
+	bool awake(int body) const;
+
+	/**
+	*  Wakes a body along with the rest of its island.
+	*  @param [in] body The id of the body
+	*/
+	void wake(int body);
+
+	/**
+	*  Returns the entity a body moves.
+	*  @param [in] body The id of the body
+	*  @return the entity given when the body was created
+	*/
+	int  entity(int body) const;
+
+	/**
+	*  Returns the contacts resolved during the last step.
+	*  @return a report for every touching pair of bodies
+	*/
+	const std::vector<contact_report>& contacts() const;
+
+	/**
+	*  Sets the acceleration due to gravity.
+	*  @param [in] acceleration The acceleration in pixels per second squared
+	*/
+	void gravity(const vector2& acceleration);
+
+	/**
+	*  Sets the number of solver iterations per step.
+	*  More iterations give stiffer stacks at a higher cost.
+	*  @param [in] iterations The iteration count
+	*/
+	void iterations(int iterations);
+
+	/**
+	*  Sets the thread pool islands are solved on.
+	*  @param [in] pool The pool to use, or null to solve on the calling thread
+	*/
+	void threadPool(ThreadPool* pool);
+
+private:
+	struct solver_point
+	{
+		float ra_x = 0, ra_y = 0;
+		float rb_x = 0, rb_y = 0;
+		float normal_mass = 0;
+		float tangent_mass = 0;
+		float normal_impulse = 0;
+		float tangent_impulse = 0;
+		float bias = 0;
+	};
+
+	struct arbiter
+	{
+		unsigned long long key = 0;
+		int   body_a = -1;
+		int   body_b = -1;
+		float friction = 0;
+		float restitution = 0;
+		manifold     contact;
+		solver_point points[2];
+	};
+
+	void    findPairs();
+	bool    collide(int body_a, int body_b, manifold& result) const;
+	void    updateContacts();
+	void    buildIslands();
+	void    solveIsland(int island, float inv_dt);
+	void    preStep(int island, float inv_dt);
+	void    solveVelocities(int island);
+	void    applyContactImpulse(int body_a, int body_b, const solver_point& point, float p_x, float p_y);
+	void    sweepBullets();
+	void    updateBroadphase();
+	void    updateIslands(float dt_sec);
+	int     findIsland(int body);
+	bool    isActive(const arbiter& arb) const;
+	rect    bounds(int body) const;
+	void    updateShape(int body);
+	bool    isDynamic(int body) const;
+
+	// body state, one entry per body id
+	std::vector<float> pos_x, pos_y, rotation;
+	std::vector<float> prev_x, prev_y, prev_rotation;
+	std::vector<float> vel_x, vel_y, ang_vel;
+	std::vector<float> inv_mass, inv_inertia;
+	std::vector<float> radii;
+	std::vector<polygon> local_shapes;
+	std::vector<polygon> world_shapes;  // refreshed whenever a body moves
+	std::vector<float> restitution, friction;
+	std::vector<ShapeType>   shapes;
+	std::vector<int> entities;
+	std::vector<int>  proxies;
+	std::vector<char> alive;
+	std::vector<char> bullets;
+	std::vector<char> awake_bodies;
+	std::vector<float> sleep_time;
+	std::vector<int>  islands;
+	std::vector<int>  island_links;  // each island's bodies in a ring, as last built
+	std::vector<int>  free_bodies;
+
+	// broadphase
+	SpatialHash dynamic_grid = SpatialHash(64.0f);
+	AABBTree    static_tree = AABBTree(64);
+	std::vector<int> grid_body;
+	std::vector<int> tree_body;
+	std::vector<SpatialHash::ProxyPair> grid_pairs;
+	std::vector<int> query_results;
+	std::vector<int> candidates;
+	std::vector<uint32_t> candidate_mask;
+	RectBatch candidate_bounds;
+	std::vector<unsigned long long> pairs;
+
+	// contacts, sorted by key so they can be matched between steps
+	std::vector<arbiter> arbiters;
+	std::vector<arbiter> previous_arbiters;
+	std::vector<contact_report> reports;
+	std::vector<int> pending_wakes;
+
+	// active contacts grouped by island, island i owning the contacts
+	// from island_offsets[i] up to island_offsets[i + 1]
+	std::vector<int> island_contacts;
+	std::vector<int> island_offsets;
+	std::vector<int> island_ids;
+	std::vector<int> contact_islands;
+	std::vector<float> island_sleep;    // the least sleep time in each island, by root
+	ThreadPool* thread_pool = nullptr;
+
+	float gravity_x = 0.0f;
+	float gravity_y = 600.0f;
+	int   solver_iterations = 8;
+};
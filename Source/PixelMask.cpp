@@ -0,0 +1,252 @@
+#include <math.h>
+#include <Engine/Sprite.h>
+#include <Engine/Texture.h>
+#include "PixelMask.h"
+
+/**
+*   @brief   Builds the mask from a block of pixels.
+*   @details Every mask pixel samples the source pixel nearest its
+             centre. Pixel data without an alpha channel is solid.
+*   @return  True if the mask was built.
+*/
+bool PixelMask::build(const uint8_t* pixels, int pitch, int channels,
+	int src_x, int src_y, int src_width, int src_height,
+	int width, int height, uint8_t threshold)
+{
+	bits.clear();
+	mask_width = mask_height = words_per_row = 0;
+
+	if (!pixels || channels < 1 || width <= 0 || height <= 0 ||
+		src_width <= 0 || src_height <= 0)
+	{
+		return false;
+	}
+
+	mask_width = width;
+	mask_height = height;
+	words_per_row = (width + 63) / 64;
+	bits.assign(static_cast<size_t>(words_per_row) * height, 0);
+
+	const bool has_alpha = channels == 2 || channels == 4;
+	const float step_x = static_cast<float>(src_width) / width;
+	const float step_y = static_cast<float>(src_height) / height;
+
+	for (int y = 0; y < height; y++)
+	{
+		int row = src_y + static_cast<int>((y + 0.5f) * step_y);
+		uint64_t* words = &bits[static_cast<size_t>(y) * words_per_row];
+
+		for (int x = 0; x < width; x++)
+		{
+			int column = src_x + static_cast<int>((x + 0.5f) * step_x);
+			const uint8_t* pixel = pixels + (static_cast<size_t>(row) * pitch + column) * channels;
+
+			if (!has_alpha || pixel[channels - 1] > threshold)
+			{
+				words[x >> 6] |= 1ull << (x & 63);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool PixelMask::test(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= mask_width || y >= mask_height)
+	{
+		return false;
+	}
+
+	return (bits[static_cast<size_t>(y) * words_per_row + (x >> 6)] >> (x & 63)) & 1;
+}
+
+/**
+*   @brief   Tests the mask against another.
+*   @details Finds the region both masks cover, then ANDs their rows
+             together 64 pixels at a time, stopping at the first hit.
+*   @return  True if any solid pixels overlap.
+*/
+bool PixelMask::overlaps(const PixelMask& other, int offset_x, int offset_y) const
+{
+	int left = offset_x > 0 ? offset_x : 0;
+	int top = offset_y > 0 ? offset_y : 0;
+	int right = offset_x + other.mask_width < mask_width ? offset_x + other.mask_width : mask_width;
+	int bottom = offset_y + other.mask_height < mask_height ? offset_y + other.mask_height : mask_height;
+
+	if (left >= right || top >= bottom)
+	{
+		return false;
+	}
+
+	for (int y = top; y < bottom; y++)
+	{
+		for (int x = left; x < right; x += 64)
+		{
+			int span = right - x;
+			uint64_t keep = span >= 64 ? ~0ull : (1ull << span) - 1;
+
+			if (rowBits(y, x) & other.rowBits(y - offset_y, x - offset_x) & keep)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+int PixelMask::width() const
+{
+	return mask_width;
+}
+
+int PixelMask::height() const
+{
+	return mask_height;
+}
+
+/**
+*   @brief   Reads 64 pixels of a row.
+*   @details Starts from any column, stitching together the two words
+             it spans. Columns outside the mask read as empty.
+*   @return  The pixels, the first being the lowest bit.
+*/
+uint64_t PixelMask::rowBits(int row, int start) const
+{
+	if (start >= mask_width || start <= -64)
+	{
+		return 0;
+	}
+
+	if (start < 0)
+	{
+		return rowBits(row, 0) << -start;
+	}
+
+	const uint64_t* words = &bits[static_cast<size_t>(row) * words_per_row];
+	int word = start >> 6;
+	int shift = start & 63;
+
+	uint64_t value = words[word] >> shift;
+	if (shift && word + 1 < words_per_row)
+	{
+		value |= words[word + 1] << (64 - shift);
+	}
+	return value;
+}
+
+/**
+*   @brief   Finds the mask for a sprite.
+*   @details Masks are keyed by texture, source rectangle and the size
+             the sprite is drawn at. The texture is only read back the
+			 first time a key is seen.
+*   @return  The mask, or null if there isn't one.
+*/
+const PixelMask* PixelMaskCache::find(const ASGE::Sprite& sprite)
+{
+	const ASGE::Texture2D* texture = sprite.getTexture();
+	if (!texture)
+	{
+		return nullptr;
+	}
+
+	const float* src = sprite.srcRect();
+	mask_key key;
+	key.texture = texture;
+	key.src[0] = static_cast<int>(src[0]);
+	key.src[1] = static_cast<int>(src[1]);
+	key.src[2] = static_cast<int>(src[2]);
+	key.src[3] = static_cast<int>(src[3]);
+	key.width = static_cast<int>(sprite.width());
+	key.height = static_cast<int>(sprite.height());
+
+	auto found = masks.find(key);
+	if (found == masks.end())
+	{
+		int tex_width = static_cast<int>(texture->getWidth());
+		int tex_height = static_cast<int>(texture->getHeight());
+
+		// an unset source rectangle draws the whole texture
+		int src_x = key.src[0], src_y = key.src[1];
+		int src_width = key.src[2], src_height = key.src[3];
+		if (src_width <= 0 || src_height <= 0)
+		{
+			src_x = src_y = 0;
+			src_width = tex_width;
+			src_height = tex_height;
+		}
+
+		PixelMask mask;
+		if (src_x >= 0 && src_y >= 0 &&
+			src_x + src_width <= tex_width && src_y + src_height <= tex_height)
+		{
+			// reading the pixels back doesn't change the texture
+			auto* readable = const_cast<ASGE::Texture2D*>(texture);
+			mask.build(static_cast<const uint8_t*>(readable->getData()),
+				tex_width, static_cast<int>(texture->getFormat()),
+				src_x, src_y, src_width, src_height, key.width, key.height);
+		}
+
+		found = masks.emplace(key, mask).first;
+	}
+
+	return found->second.width() > 0 ? &found->second : nullptr;
+}
+
+/**
+*   @brief   Tests two sprites for overlapping solid pixels.
+*   @details Rejects on the bounding boxes before looking up the masks.
+             Sprites without a readable mask fall back to their boxes.
+*   @return  True if they overlap.
+*/
+bool PixelMaskCache::overlaps(const ASGE::Sprite& sprite_a, const vector2& position_a,
+	const ASGE::Sprite& sprite_b, const vector2& position_b)
+{
+	if (position_a.x > position_b.x + sprite_b.width() ||
+		position_b.x > position_a.x + sprite_a.width() ||
+		position_a.y > position_b.y + sprite_b.height() ||
+		position_b.y > position_a.y + sprite_a.height())
+	{
+		return false;
+	}
+
+	const PixelMask* mask_a = find(sprite_a);
+	const PixelMask* mask_b = find(sprite_b);
+	if (!mask_a || !mask_b)
+	{
+		return true;
+	}
+
+	int offset_x = static_cast<int>(floorf(position_b.x - position_a.x + 0.5f));
+	int offset_y = static_cast<int>(floorf(position_b.y - position_a.y + 0.5f));
+	return mask_a->overlaps(*mask_b, offset_x, offset_y);
+}
+
+void PixelMaskCache::clear()
+{
+	masks.clear();
+}
+
+bool PixelMaskCache::mask_key::operator<(const mask_key& rhs) const
+{
+	if (texture != rhs.texture)
+	{
+		return texture < rhs.texture;
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		if (src[i] != rhs.src[i])
+		{
+			return src[i] < rhs.src[i];
+		}
+	}
+
+	if (width != rhs.width)
+	{
+		return width < rhs.width;
+	}
+
+	return height < rhs.height;
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <map>
+#include <stdint.h>
+#include <vector>
+#include "Vector2.h"
+
+namespace ASGE
+{
+	class Sprite;
+	class Texture2D;
+}
+
+/**
+*  A one bit per pixel collision mask.
+*  Each row is packed into 64 bit words, lowest bit first, so that two
+*  masks can be tested against each other a whole word at a time
+*  rather than pixel by pixel. A pixel is solid when its alpha is
+*  above the threshold used to build the mask.
+*/
+class PixelMask
+{
+public:
+
+	/**
+	*  Default constructor.
+	*/
+	PixelMask() = default;
+
+	/**
+	*  Builds the mask from a block of pixels.
+	*  The source region is resampled to the mask's size using the
+	*  nearest pixel, so a mask can match the size a sprite is drawn at.
+	*  @param [in] pixels The pixel data, rows running top to bottom
+	*  @param [in] pitch The number of pixels in a row of the data
+	*  @param [in] channels The bytes per pixel, alpha being the last
+	*  @param [in] src_x The left of the region to sample
+	*  @param [in] src_y The top of the region to sample
+	*  @param [in] src_width The width of the region to sample
+	*  @param [in] src_height The height of the region to sample
+	*  @param [in] width The width of the mask
+	*  @param [in] height The height of the mask
+	*  @param [in] threshold The alpha a pixel must exceed to be solid
+	*  @return true if the mask was built
+	*/
+	bool build(const uint8_t* pixels, int pitch, int channels,
+		int src_x, int src_y, int src_width, int src_height,
+		int width, int height, uint8_t threshold = 0);
+
+	/**
+	*  Checks a single pixel.
+	*  @param [in] x The column of the pixel
+	*  @param [in] y The row of the pixel
+	*  @return true if the pixel is solid, false if it is outside the mask
+	*/
+	bool test(int x, int y) const;
+
+	/**
+	*  Tests the mask against another.
+	*  Only the rows and columns both masks cover are visited, one word
+	*  of each row at a time.
+	*  @param [in] other The mask to test against
+	*  @param [in] offset_x The other mask's left edge, relative to this one
+	*  @param [in] offset_y The other mask's top edge, relative to this one
+	*  @return true if any solid pixels overlap
+	*/
+	bool overlaps(const PixelMask& other, int offset_x, int offset_y) const;
+
+	/**
+	*  Returns the width of the mask.
+	*  @return the width in pixels
+	*/
+	int  width() const;
+
+	/**
+	*  Returns the height of the mask.
+	*  @return the height in pixels
+	*/
+	int  height() const;
+
+private:
+	uint64_t rowBits(int row, int start) const;
+
+	std::vector<uint64_t> bits;
+	int mask_width = 0;
+	int mask_height = 0;
+	int words_per_row = 0;
+};
+
+/**
+*  Builds and keeps the pixel masks for sprites.
+*  Reading a texture back from the GPU is slow, so each mask is built
+*  the first time it is asked for and reused by every sprite drawing
+*  the same part of the same texture at the same size. The engine
+*  already shares textures between sprites loading the same file.
+*/
+class PixelMaskCache
+{
+public:
+
+	/**
+	*  Finds the mask for a sprite, building it if needed.
+	*  @param [in] sprite The sprite to find the mask for
+	*  @return the mask, or null if the texture couldn't be read
+	*/
+	const PixelMask* find(const ASGE::Sprite& sprite);
+
+	/**
+	*  Tests two sprites for overlapping solid pixels.
+	*  The sprites are tested at the positions given rather than where
+	*  they were last drawn. The bounding boxes are compared first.
+	*  Masks are axis aligned, so the sprites are assumed to be upright.
+	*  @param [in] sprite_a The first sprite
+	*  @param [in] position_a The top left of the first sprite
+	*  @param [in] sprite_b The second sprite
+	*  @param [in] position_b The top left of the second sprite
+	*  @return true if they overlap
+	*/
+	bool overlaps(const ASGE::Sprite& sprite_a, const vector2& position_a,
+		const ASGE::Sprite& sprite_b, const vector2& position_b);
+
+	/**
+	*  Removes every mask.
+	*/
+	void clear();
+
+private:
+	struct mask_key
+	{
+		const ASGE::Texture2D* texture;
+		int src[4];
+		int width;
+		int height;
+		bool operator<(const mask_key& rhs) const;
+	};
+
+	std::map<mask_key, PixelMask> masks;  // empty masks mark unreadable textures
+};
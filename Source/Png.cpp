@@ -0,0 +1,946 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MappedFile.h"
+#include "Png.h"
+
+namespace
+{
+	const uint8_t SIGNATURE[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+	const int MAX_DIMENSION = 16384;
+	const int MAX_BITS = 15;
+	const int WINDOW_SIZE = 32768;
+	const int HASH_BITS = 15;
+	const int MAX_CHAIN = 64;
+	const int MIN_MATCH = 3;
+	const int MAX_MATCH = 258;
+
+	const uint16_t LENGTH_BASE[29] = {
+		3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+		35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	const uint8_t LENGTH_EXTRA[29] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+		3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	const uint16_t DISTANCE_BASE[30] = {
+		1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+		257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+		8193, 12289, 16385, 24577 };
+	const uint8_t DISTANCE_EXTRA[30] = {
+		0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+		7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	const uint8_t CODE_LENGTH_ORDER[19] = {
+		16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	/**
+	*  Reads a deflate stream's bits, lowest first.
+	*/
+	struct bit_reader
+	{
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+		size_t position = 0;
+		uint32_t bits = 0;
+		int count = 0;
+		bool overrun = false;
+
+		int get(int needed)
+		{
+			uint32_t value = bits;
+			while (count < needed)
+			{
+				if (position >= size)
+				{
+					overrun = true;
+					return 0;
+				}
+				value |= static_cast<uint32_t>(data[position++]) << count;
+				count += 8;
+			}
+
+			bits = value >> needed;
+			count -= needed;
+			return static_cast<int>(value & ((1u << needed) - 1));
+		}
+	};
+
+	/**
+	*  Writes a deflate stream's bits, lowest first.
+	*/
+	struct bit_writer
+	{
+		std::vector<uint8_t>* out = nullptr;
+		uint32_t bits = 0;
+		int count = 0;
+
+		void put(uint32_t value, int length)
+		{
+			bits |= value << count;
+			count += length;
+			while (count >= 8)
+			{
+				out->push_back(static_cast<uint8_t>(bits));
+				bits >>= 8;
+				count -= 8;
+			}
+		}
+
+		void putCode(uint32_t code, int length)
+		{
+			// Huffman codes are packed starting from their top bit
+			uint32_t reversed = 0;
+			for (int i = 0; i < length; i++)
+			{
+				reversed = (reversed << 1) | ((code >> i) & 1);
+			}
+			put(reversed, length);
+		}
+
+		void flush()
+		{
+			if (count > 0)
+			{
+				out->push_back(static_cast<uint8_t>(bits));
+			}
+			bits = 0;
+			count = 0;
+		}
+	};
+
+	/**
+	*  A canonical Huffman code, stored as the number of codes of each
+	*  length and the symbols in code order.
+	*/
+	struct huffman
+	{
+		uint16_t counts[MAX_BITS + 1];
+		uint16_t symbols[288];
+	};
+
+	bool buildHuffman(huffman& code, const uint8_t* lengths, int symbol_count)
+	{
+		memset(code.counts, 0, sizeof(code.counts));
+		for (int symbol = 0; symbol < symbol_count; symbol++)
+		{
+			code.counts[lengths[symbol]]++;
+		}
+
+		// incomplete codes are allowed, over subscribed ones aren't
+		int left = 1;
+		for (int length = 1; length <= MAX_BITS; length++)
+		{
+			left <<= 1;
+			left -= code.counts[length];
+			if (left < 0)
+			{
+				return false;
+			}
+		}
+
+		uint16_t offsets[MAX_BITS + 1];
+		offsets[1] = 0;
+		for (int length = 1; length < MAX_BITS; length++)
+		{
+			offsets[length + 1] = offsets[length] + code.counts[length];
+		}
+
+		for (int symbol = 0; symbol < symbol_count; symbol++)
+		{
+			if (lengths[symbol] != 0)
+			{
+				code.symbols[offsets[lengths[symbol]]++] = static_cast<uint16_t>(symbol);
+			}
+		}
+		return true;
+	}
+
+	/**
+	*   @brief   Reads one symbol.
+	*   @details Canonical codes of each length are consecutive, so the
+	             code read so far is compared against the first code of
+				 its length until it falls inside that length's range.
+	*   @return  The symbol, or -1 if the code is invalid.
+	*/
+	int decodeSymbol(bit_reader& in, const huffman& code)
+	{
+		int value = 0;
+		int first = 0;
+		int index = 0;
+
+		for (int length = 1; length <= MAX_BITS; length++)
+		{
+			value |= in.get(1);
+			int count = code.counts[length];
+			if (value - first < count)
+			{
+				return code.symbols[index + value - first];
+			}
+
+			index += count;
+			first = (first + count) << 1;
+			value <<= 1;
+		}
+
+		return -1;
+	}
+
+	bool inflateCodes(bit_reader& in, const huffman& lengths, const huffman& distances,
+		std::vector<uint8_t>& out)
+	{
+		for (;;)
+		{
+			int symbol = decodeSymbol(in, lengths);
+			if (symbol < 0 || in.overrun)
+			{
+				return false;
+			}
+			if (symbol < 256)
+			{
+				out.push_back(static_cast<uint8_t>(symbol));
+				continue;
+			}
+			if (symbol == 256)
+			{
+				return true;
+			}
+
+			symbol -= 257;
+			if (symbol >= 29)
+			{
+				return false;
+			}
+			int length = LENGTH_BASE[symbol] + in.get(LENGTH_EXTRA[symbol]);
+
+			symbol = decodeSymbol(in, distances);
+			if (symbol < 0 || symbol >= 30)
+			{
+				return false;
+			}
+			size_t distance = DISTANCE_BASE[symbol] + in.get(DISTANCE_EXTRA[symbol]);
+			if (distance > out.size() || in.overrun)
+			{
+				return false;
+			}
+
+			size_t from = out.size() - distance;
+			for (int i = 0; i < length; i++)
+			{
+				out.push_back(out[from + i]);
+			}
+		}
+	}
+
+	bool inflateDynamic(bit_reader& in, std::vector<uint8_t>& out)
+	{
+		int length_count = in.get(5) + 257;
+		int distance_count = in.get(5) + 1;
+		int code_count = in.get(4) + 4;
+		if (length_count > 286 || distance_count > 30)
+		{
+			return false;
+		}
+
+		uint8_t lengths[320] = {};
+		for (int i = 0; i < code_count; i++)
+		{
+			lengths[CODE_LENGTH_ORDER[i]] = static_cast<uint8_t>(in.get(3));
+		}
+
+		huffman code_lengths;
+		if (!buildHuffman(code_lengths, lengths, 19))
+		{
+			return false;
+		}
+
+		memset(lengths, 0, sizeof(lengths));
+		int index = 0;
+		while (index < length_count + distance_count)
+		{
+			int symbol = decodeSymbol(in, code_lengths);
+			if (symbol < 0 || in.overrun)
+			{
+				return false;
+			}
+			if (symbol < 16)
+			{
+				lengths[index++] = static_cast<uint8_t>(symbol);
+				continue;
+			}
+
+			uint8_t repeated = 0;
+			int repeat = 0;
+			if (symbol == 16)
+			{
+				if (index == 0)
+				{
+					return false;
+				}
+				repeated = lengths[index - 1];
+				repeat = 3 + in.get(2);
+			}
+			else if (symbol == 17)
+			{
+				repeat = 3 + in.get(3);
+			}
+			else
+			{
+				repeat = 11 + in.get(7);
+			}
+
+			if (index + repeat > length_count + distance_count)
+			{
+				return false;
+			}
+			while (repeat--)
+			{
+				lengths[index++] = repeated;
+			}
+		}
+
+		huffman length_code;
+		huffman distance_code;
+		if (lengths[256] == 0 ||
+			!buildHuffman(length_code, lengths, length_count) ||
+			!buildHuffman(distance_code, lengths + length_count, distance_count))
+		{
+			return false;
+		}
+
+		return inflateCodes(in, length_code, distance_code, out);
+	}
+
+	struct fixed_codes
+	{
+		huffman length_code;
+		huffman distance_code;
+
+		fixed_codes()
+		{
+			uint8_t lengths[320];
+			int symbol = 0;
+			for (; symbol < 144; symbol++) lengths[symbol] = 8;
+			for (; symbol < 256; symbol++) lengths[symbol] = 9;
+			for (; symbol < 280; symbol++) lengths[symbol] = 7;
+			for (; symbol < 288; symbol++) lengths[symbol] = 8;
+			buildHuffman(length_code, lengths, 288);
+
+			for (symbol = 0; symbol < 30; symbol++) lengths[symbol] = 5;
+			buildHuffman(distance_code, lengths, 30);
+		}
+	};
+
+	bool inflateFixed(bit_reader& in, std::vector<uint8_t>& out)
+	{
+		// built by whichever thread gets here first, as images are decoded in parallel
+		static const fixed_codes fixed;
+		return inflateCodes(in, fixed.length_code, fixed.distance_code, out);
+	}
+
+	/**
+	*   @brief   Inflates a zlib stream.
+	*   @details Stored, fixed and dynamic blocks are all handled. The
+	             checksum at the end is not verified.
+	*   @return  True if the stream was complete and valid.
+	*/
+	bool inflateZlib(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+	{
+		if (size < 2 || (data[0] & 0x0f) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 0x20))
+		{
+			return false;
+		}
+
+		bit_reader in;
+		in.data = data + 2;
+		in.size = size - 2;
+
+		int last = 0;
+		do
+		{
+			last = in.get(1);
+			int type = in.get(2);
+			bool inflated = false;
+
+			if (type == 0)
+			{
+				in.bits = 0;
+				in.count = 0;
+				if (in.position + 4 > in.size)
+				{
+					return false;
+				}
+
+				const uint8_t* header = in.data + in.position;
+				size_t length = header[0] | (header[1] << 8);
+				size_t check = header[2] | (header[3] << 8);
+				in.position += 4;
+				if (length != (~check & 0xffff) || in.position + length > in.size)
+				{
+					return false;
+				}
+
+				out.insert(out.end(), in.data + in.position, in.data + in.position + length);
+				in.position += length;
+				inflated = true;
+			}
+			else if (type == 1)
+			{
+				inflated = inflateFixed(in, out);
+			}
+			else if (type == 2)
+			{
+				inflated = inflateDynamic(in, out);
+			}
+
+			if (!inflated || in.overrun)
+			{
+				return false;
+			}
+		} while (!last);
+
+		return true;
+	}
+
+	int lengthCode(int length)
+	{
+		int code = 28;
+		while (LENGTH_BASE[code] > length)
+		{
+			code--;
+		}
+		return code;
+	}
+
+	int distanceCode(int distance)
+	{
+		int code = 29;
+		while (DISTANCE_BASE[code] > distance)
+		{
+			code--;
+		}
+		return code;
+	}
+
+	void putLiteral(bit_writer& out, int symbol)
+	{
+		if (symbol < 144)
+		{
+			out.putCode(0x30 + symbol, 8);
+		}
+		else if (symbol < 256)
+		{
+			out.putCode(0x190 + symbol - 144, 9);
+		}
+		else if (symbol < 280)
+		{
+			out.putCode(symbol - 256, 7);
+		}
+		else
+		{
+			out.putCode(0xc0 + symbol - 280, 8);
+		}
+	}
+
+	uint32_t adler32(const uint8_t* data, size_t size)
+	{
+		uint32_t a = 1;
+		uint32_t b = 0;
+		while (size > 0)
+		{
+			size_t block = size < 5552 ? size : 5552;
+			size -= block;
+			while (block--)
+			{
+				a += *data++;
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+		}
+		return (b << 16) | a;
+	}
+
+	/**
+	*   @brief   Deflates data into a zlib stream.
+	*   @details Matches are found through hash chains over the last
+	             32KB and written as a single block of fixed codes.
+				 Good enough for atlases, which are mostly runs of
+				 transparent pixels.
+	*   @return  void
+	*/
+	void deflateZlib(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+	{
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		bit_writer writer;
+		writer.out = &out;
+		writer.put(1, 1);
+		writer.put(1, 2);
+
+		std::vector<int> head(1 << HASH_BITS, -1);
+		std::vector<int> previous(WINDOW_SIZE, -1);
+		auto hashAt = [data](size_t at)
+		{
+			uint32_t key = data[at] | (data[at + 1] << 8) | (data[at + 2] << 16);
+			return (key * 2654435761u) >> (32 - HASH_BITS);
+		};
+
+		size_t position = 0;
+		while (position < size)
+		{
+			int best_length = 0;
+			int best_distance = 0;
+
+			if (position + MIN_MATCH <= size)
+			{
+				uint32_t hash = hashAt(position);
+				int candidate = head[hash];
+				size_t limit = size - position < MAX_MATCH ? size - position : MAX_MATCH;
+
+				for (int chain = 0; candidate >= 0 && chain < MAX_CHAIN; chain++)
+				{
+					int distance = static_cast<int>(position) - candidate;
+					if (distance > WINDOW_SIZE - 1)
+					{
+						break;
+					}
+
+					int length = 0;
+					while (length < static_cast<int>(limit) && data[candidate + length] == data[position + length])
+					{
+						length++;
+					}
+					if (length > best_length)
+					{
+						best_length = length;
+						best_distance = distance;
+						if (length == static_cast<int>(limit))
+						{
+							break;
+						}
+					}
+					candidate = previous[candidate % WINDOW_SIZE];
+				}
+			}
+
+			size_t advance = 1;
+			if (best_length >= MIN_MATCH)
+			{
+				int code = lengthCode(best_length);
+				putLiteral(writer, 257 + code);
+				writer.put(best_length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+				code = distanceCode(best_distance);
+				writer.putCode(code, 5);
+				writer.put(best_distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+				advance = best_length;
+			}
+			else
+			{
+				putLiteral(writer, data[position]);
+			}
+
+			for (size_t i = 0; i < advance; i++, position++)
+			{
+				if (position + MIN_MATCH <= size)
+				{
+					uint32_t hash = hashAt(position);
+					previous[position % WINDOW_SIZE] = head[hash];
+					head[hash] = static_cast<int>(position);
+				}
+			}
+		}
+
+		putLiteral(writer, 256);
+		writer.flush();
+
+		uint32_t checksum = adler32(data, size);
+		for (int shift = 24; shift >= 0; shift -= 8)
+		{
+			out.push_back(static_cast<uint8_t>(checksum >> shift));
+		}
+	}
+
+	/**
+	*   @brief   Wraps data in a zlib stream without compressing it.
+	*   @details Stored blocks hold at most 64KB each. Inflating them is
+	             little more than a copy.
+	*   @return  void
+	*/
+	void storeZlib(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+	{
+		out.push_back(0x78);
+		out.push_back(0x01);
+
+		size_t position = 0;
+		do
+		{
+			size_t block = size - position < 65535 ? size - position : 65535;
+			out.push_back(position + block == size ? 1 : 0);
+			out.push_back(static_cast<uint8_t>(block));
+			out.push_back(static_cast<uint8_t>(block >> 8));
+			out.push_back(static_cast<uint8_t>(~block));
+			out.push_back(static_cast<uint8_t>(~block >> 8));
+			out.insert(out.end(), data + position, data + position + block);
+			position += block;
+		} while (position < size);
+
+		uint32_t checksum = adler32(data, size);
+		for (int shift = 24; shift >= 0; shift -= 8)
+		{
+			out.push_back(static_cast<uint8_t>(checksum >> shift));
+		}
+	}
+
+	struct crc_table
+	{
+		uint32_t entries[256];
+
+		crc_table()
+		{
+			for (uint32_t n = 0; n < 256; n++)
+			{
+				uint32_t c = n;
+				for (int k = 0; k < 8; k++)
+				{
+					c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+				}
+				entries[n] = c;
+			}
+		}
+	};
+
+	uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+	{
+		static const crc_table table;
+
+		crc = ~crc;
+		for (size_t i = 0; i < size; i++)
+		{
+			crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		}
+		return ~crc;
+	}
+
+	uint32_t readBig(const uint8_t* data)
+	{
+		return (static_cast<uint32_t>(data[0]) << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+	}
+
+	void writeBig(std::vector<uint8_t>& out, uint32_t value)
+	{
+		for (int shift = 24; shift >= 0; shift -= 8)
+		{
+			out.push_back(static_cast<uint8_t>(value >> shift));
+		}
+	}
+
+	void writeChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t size)
+	{
+		writeBig(out, static_cast<uint32_t>(size));
+		size_t start = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), data, data + size);
+		writeBig(out, crc32(out.data() + start, size + 4));
+	}
+
+	int paeth(int a, int b, int c)
+	{
+		int p = a + b - c;
+		int pa = abs(p - a);
+		int pb = abs(p - b);
+		int pc = abs(p - c);
+		return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+	}
+
+	/**
+	*   @brief   Reverses the filter on one row.
+	*   @return  False if the filter type is unknown.
+	*/
+	bool unfilterRow(int filter, uint8_t* row, const uint8_t* above, size_t length, int bpp)
+	{
+		for (size_t i = 0; i < length; i++)
+		{
+			int left = i >= static_cast<size_t>(bpp) ? row[i - bpp] : 0;
+			int up = above ? above[i] : 0;
+			int corner = above && i >= static_cast<size_t>(bpp) ? above[i - bpp] : 0;
+
+			switch (filter)
+			{
+			case 0: break;
+			case 1: row[i] = static_cast<uint8_t>(row[i] + left); break;
+			case 2: row[i] = static_cast<uint8_t>(row[i] + up); break;
+			case 3: row[i] = static_cast<uint8_t>(row[i] + ((left + up) >> 1)); break;
+			case 4: row[i] = static_cast<uint8_t>(row[i] + paeth(left, up, corner)); break;
+			default: return false;
+			}
+		}
+		return true;
+	}
+}
+
+/**
+*   @brief   Decodes a PNG held in memory.
+*   @details Walks the chunks, gathering the header, palette,
+             transparency and image data, then inflates and unfilters
+			 the rows before expanding them to RGBA. Chunk checksums
+			 are not verified.
+*   @return  True if the image was decoded.
+*/
+bool decodePng(const uint8_t* data, size_t size, image& decoded)
+{
+	if (size < 8 || memcmp(data, SIGNATURE, 8) != 0)
+	{
+		return false;
+	}
+
+	int width = 0, height = 0, depth = 0, colour = 0, interlace = 0;
+	uint8_t palette[256][4];
+	int palette_size = 0;
+	bool has_key = false;
+	uint8_t key[3] = {};
+	std::vector<uint8_t> compressed;
+
+	memset(palette, 255, sizeof(palette));
+	for (size_t position = 8; position + 12 <= size;)
+	{
+		uint32_t length = readBig(data + position);
+		const uint8_t* type = data + position + 4;
+		const uint8_t* body = data + position + 8;
+		if (length > size - position - 12)
+		{
+			return false;
+		}
+
+		if (memcmp(type, "IHDR", 4) == 0 && length >= 13)
+		{
+			width = static_cast<int>(readBig(body));
+			height = static_cast<int>(readBig(body + 4));
+			depth = body[8];
+			colour = body[9];
+			interlace = body[12];
+		}
+		else if (memcmp(type, "PLTE", 4) == 0)
+		{
+			palette_size = static_cast<int>(length / 3 < 256 ? length / 3 : 256);
+			for (int i = 0; i < palette_size; i++)
+			{
+				palette[i][0] = body[i * 3];
+				palette[i][1] = body[i * 3 + 1];
+				palette[i][2] = body[i * 3 + 2];
+			}
+		}
+		else if (memcmp(type, "tRNS", 4) == 0)
+		{
+			if (colour == 3)
+			{
+				for (uint32_t i = 0; i < length && i < 256; i++)
+				{
+					palette[i][3] = body[i];
+				}
+			}
+			else if ((colour == 0 && length >= 2) || (colour == 2 && length >= 6))
+			{
+				has_key = true;
+				for (uint32_t i = 0; i < length / 2 && i < 3; i++)
+				{
+					key[i] = body[i * 2 + 1];
+				}
+			}
+		}
+		else if (memcmp(type, "IDAT", 4) == 0)
+		{
+			compressed.insert(compressed.end(), body, body + length);
+		}
+		else if (memcmp(type, "IEND", 4) == 0)
+		{
+			break;
+		}
+
+		position += length + 12;
+	}
+
+	int channels = colour == 0 ? 1 : colour == 2 ? 3 : colour == 3 ? 1 : colour == 4 ? 2 : colour == 6 ? 4 : 0;
+	if (channels == 0 || depth != 8 || interlace != 0 || (colour == 3 && palette_size == 0) ||
+		width <= 0 || height <= 0 || width > MAX_DIMENSION || height > MAX_DIMENSION)
+	{
+		return false;
+	}
+
+	const size_t stride = static_cast<size_t>(width) * channels;
+	std::vector<uint8_t> raw;
+	raw.reserve((stride + 1) * height);
+	if (!inflateZlib(compressed.data(), compressed.size(), raw) || raw.size() < (stride + 1) * height)
+	{
+		return false;
+	}
+
+	decoded.width = width;
+	decoded.height = height;
+	decoded.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+	for (int y = 0; y < height; y++)
+	{
+		uint8_t* row = raw.data() + y * (stride + 1);
+		const uint8_t* above = y > 0 ? row - stride - 1 : nullptr;
+		if (!unfilterRow(row[0], row + 1, above, stride, channels))
+		{
+			return false;
+		}
+
+		// shift the row down over its filter byte, so the next row's
+		// "above" is the unfiltered one
+		memmove(row, row + 1, stride);
+
+		uint8_t* pixel = decoded.pixels.data() + static_cast<size_t>(y) * width * 4;
+		for (int x = 0; x < width; x++, pixel += 4)
+		{
+			const uint8_t* source = row + x * channels;
+			switch (colour)
+			{
+			case 0:
+				pixel[0] = pixel[1] = pixel[2] = source[0];
+				pixel[3] = has_key && source[0] == key[0] ? 0 : 255;
+				break;
+			case 2:
+				pixel[0] = source[0];
+				pixel[1] = source[1];
+				pixel[2] = source[2];
+				pixel[3] = has_key && memcmp(source, key, 3) == 0 ? 0 : 255;
+				break;
+			case 3:
+				memcpy(pixel, palette[source[0]], 4);
+				break;
+			case 4:
+				pixel[0] = pixel[1] = pixel[2] = source[0];
+				pixel[3] = source[1];
+				break;
+			default:
+				memcpy(pixel, source, 4);
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool readPngSize(const uint8_t* data, size_t size, int& width, int& height)
+{
+	// the header is always the first chunk
+	if (size < 24 || memcmp(data, SIGNATURE, 8) != 0 || memcmp(data + 12, "IHDR", 4) != 0)
+	{
+		return false;
+	}
+
+	width = static_cast<int>(readBig(data + 16));
+	height = static_cast<int>(readBig(data + 20));
+	return width > 0 && height > 0;
+}
+
+bool loadPng(const std::string& path, image& decoded)
+{
+	MappedFile file;
+	if (!file.open(path) || !file.data())
+	{
+		return false;
+	}
+
+	return decodePng(reinterpret_cast<const uint8_t*>(file.data()), file.size(), decoded);
+}
+
+/**
+*   @brief   Encodes an image as an RGBA PNG.
+*   @details Each row's filter is picked by the usual heuristic of the
+             smallest sum of the filtered bytes taken as signed values.
+			 Uncompressed images leave every row unfiltered.
+*   @return  True if the image was encoded.
+*/
+bool encodePng(const image& source, std::vector<uint8_t>& encoded, bool compress)
+{
+	if (source.width <= 0 || source.height <= 0 ||
+		source.pixels.size() < static_cast<size_t>(source.width) * source.height * 4)
+	{
+		return false;
+	}
+
+	const size_t stride = static_cast<size_t>(source.width) * 4;
+	std::vector<uint8_t> filtered((stride + 1) * source.height);
+	std::vector<uint8_t> trial(stride);
+
+	for (int y = 0; y < source.height; y++)
+	{
+		const uint8_t* row = source.pixels.data() + y * stride;
+		const uint8_t* above = y > 0 ? row - stride : nullptr;
+		uint8_t* out = filtered.data() + y * (stride + 1);
+		long best_score = -1;
+
+		for (int filter = 0; filter < (compress ? 5 : 1); filter++)
+		{
+			long score = 0;
+			for (size_t i = 0; i < stride; i++)
+			{
+				int left = i >= 4 ? row[i - 4] : 0;
+				int up = above ? above[i] : 0;
+				int corner = above && i >= 4 ? above[i - 4] : 0;
+				int predicted = filter == 1 ? left : filter == 2 ? up :
+					filter == 3 ? (left + up) >> 1 : filter == 4 ? paeth(left, up, corner) : 0;
+
+				trial[i] = static_cast<uint8_t>(row[i] - predicted);
+				score += abs(static_cast<int8_t>(trial[i]));
+			}
+
+			if (best_score < 0 || score < best_score)
+			{
+				best_score = score;
+				out[0] = static_cast<uint8_t>(filter);
+				memcpy(out + 1, trial.data(), stride);
+			}
+		}
+	}
+
+	std::vector<uint8_t> compressed;
+	if (compress)
+	{
+		deflateZlib(filtered.data(), filtered.size(), compressed);
+	}
+	else
+	{
+		storeZlib(filtered.data(), filtered.size(), compressed);
+	}
+
+	uint8_t header[13] = {};
+	header[0] = static_cast<uint8_t>(source.width >> 24);
+	header[1] = static_cast<uint8_t>(source.width >> 16);
+	header[2] = static_cast<uint8_t>(source.width >> 8);
+	header[3] = static_cast<uint8_t>(source.width);
+	header[4] = static_cast<uint8_t>(source.height >> 24);
+	header[5] = static_cast<uint8_t>(source.height >> 16);
+	header[6] = static_cast<uint8_t>(source.height >> 8);
+	header[7] = static_cast<uint8_t>(source.height);
+	header[8] = 8;
+	header[9] = 6;
+
+	encoded.assign(SIGNATURE, SIGNATURE + 8);
+	writeChunk(encoded, "IHDR", header, sizeof(header));
+	writeChunk(encoded, "IDAT", compressed.data(), compressed.size());
+	writeChunk(encoded, "IEND", nullptr, 0);
+	return true;
+}
+
+bool savePng(const std::string& path, const image& source, bool compress)
+{
+	std::vector<uint8_t> encoded;
+	if (!encodePng(source, encoded, compress))
+	{
+		return false;
+	}
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	bool written = fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+	return fclose(file) == 0 && written;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+*  An uncompressed image, four 8 bit channels per pixel in RGBA order,
+*  rows running top to bottom with no padding between them.
+*/
+struct image
+{
+	int width = 0;
+	int height = 0;
+	std::vector<uint8_t> pixels;
+};
+
+/**
+*  Decodes a PNG held in memory.
+*  Greyscale, RGB, palette and alpha images with 8 bit channels are
+*  supported, which covers every image the game ships. Interlaced and
+*  16 bit images are rejected.
+*  @param [in] data The contents of the PNG file
+*  @param [in] size The size of the data in bytes
+*  @param [out] decoded The image, converted to RGBA
+*  @return true if the image was decoded
+*/
+bool decodePng(const uint8_t* data, size_t size, image& decoded);
+
+/**
+*  Reads a PNG's size from its header without decoding it.
+*  @param [in] data The contents of the PNG file, or at least its first
+*  24 bytes
+*  @param [in] size The size of the data in bytes
+*  @param [out] width The image's width in pixels
+*  @param [out] height The image's height in pixels
+*  @return true if the data starts with a PNG header
+*/
+bool readPngSize(const uint8_t* data, size_t size, int& width, int& height);
+
+/**
+*  Decodes a PNG file.
+*  @param [in] path The path to the file
+*  @param [out] decoded The image, converted to RGBA
+*  @return true if the file was read and decoded
+*/
+bool loadPng(const std::string& path, image& decoded);
+
+/**
+*  Encodes an image as an RGBA PNG.
+*  Each row is filtered with whichever filter leaves the smallest
+*  values, then the image is deflated with fixed Huffman codes.
+*  Left uncompressed, the rows are stored as they are, making a larger
+*  file that decodes at close to the speed it can be read.
+*  @param [in] source The image to encode
+*  @param [out] encoded The contents of the PNG file
+*  @param [in] compress Whether to filter and deflate the image
+*  @return true if the image was encoded
+*/
+bool encodePng(const image& source, std::vector<uint8_t>& encoded, bool compress = true);
+
+/**
+*  Encodes an image and writes it to a PNG file.
+*  @param [in] path The path to write to
+*  @param [in] source The image to encode
+*  @param [in] compress Whether to filter and deflate the image
+*  @return true if the file was written
+*/
+bool savePng(const std::string& path, const image& source, bool compress = true);
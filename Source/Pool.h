@@ -0,0 +1,233 @@
+#pragma once
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+/**
+*  A 32 bit reference to an item in a Pool.
+*  The low bits index the item's slot and the high bits hold the slot's
+*  generation at the time the item was acquired. Releasing the item
+*  moves the slot on a generation, so a handle kept past that point no
+*  longer matches and is caught rather than reaching whatever reuses
+*  the slot. A default handle refers to nothing.
+*/
+struct handle
+{
+	static const int INDEX_BITS = 20;
+	static const uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+	uint32_t value = 0;
+
+	int  index() const { return static_cast<int>(value & INDEX_MASK); }
+	uint32_t generation() const { return value >> INDEX_BITS; }
+	bool operator==(const handle& rhs) const { return value == rhs.value; }
+	bool operator!=(const handle& rhs) const { return value != rhs.value; }
+};
+
+/**
+*  Hands out items from fixed size blocks and takes them back.
+*  Blocks are never moved or freed until the pool is destroyed, so
+*  items need not be copyable. A released item isn't destroyed either:
+*  the next acquire hands it back out as it was left, letting the
+*  caller reuse whatever it holds, and the caller is expected to reset
+*  anything it relies on. Once the pool has grown to fit a level,
+*  releasing everything and building the level again allocates nothing.
+*/
+template<typename T, int BLOCK_SIZE = 64>
+class Pool
+{
+public:
+
+	/**
+	*  Default constructor. No blocks are allocated until needed.
+	*/
+	Pool() = default;
+
+	/**
+	*  Takes an item from the pool, adding a block if none are free.
+	*  Slots are reused lowest first after releaseAll, so a level built
+	*  in the same order gets back the same items.
+	*  @return a handle to the item
+	*/
+	handle acquire();
+
+	/**
+	*  Returns an item to the pool.
+	*  @param [in] item The handle to the item
+	*  @return false if the handle was stale or empty
+	*/
+	bool release(handle item);
+
+	/**
+	*  Returns every item to the pool. All existing handles go stale.
+	*/
+	void releaseAll();
+
+	/**
+	*  Checks a handle still refers to an acquired item.
+	*  @param [in] item The handle to check
+	*  @return true if the item is still in use
+	*/
+	bool valid(handle item) const;
+
+	/**
+	*  Finds the item a handle refers to.
+	*  @param [in] item The handle to the item
+	*  @return the item, or null if the handle is stale or empty
+	*/
+	T*   get(handle item);
+
+	/**
+	*  Finds the item a handle refers to.
+	*  @param [in] item The handle to the item
+	*  @return the item, or null if the handle is stale or empty
+	*/
+	const T* get(handle item) const;
+
+	/**
+	*  Returns the number of items in use.
+	*  @return the acquired item count
+	*/
+	int  size() const;
+
+	/**
+	*  Returns the number of items the pool can hold without growing.
+	*  @return the item count of every block
+	*/
+	int  capacity() const;
+
+private:
+	void grow();
+
+	std::vector<std::unique_ptr<T[]>> blocks;
+	std::vector<uint32_t> generations;
+	std::vector<uint8_t>  used;
+	std::vector<int>      free_slots;   // popped from the back
+	int live = 0;
+};
+
+template<typename T, int BLOCK_SIZE>
+handle Pool<T, BLOCK_SIZE>::acquire()
+{
+	if (free_slots.empty())
+	{
+		grow();
+	}
+
+	int slot = free_slots.back();
+	free_slots.pop_back();
+	used[slot] = 1;
+	live++;
+
+	handle item;
+	item.value = (generations[slot] << handle::INDEX_BITS) | static_cast<uint32_t>(slot);
+	return item;
+}
+
+template<typename T, int BLOCK_SIZE>
+bool Pool<T, BLOCK_SIZE>::release(handle item)
+{
+	if (!valid(item))
+	{
+		return false;
+	}
+
+	int slot = item.index();
+	used[slot] = 0;
+	free_slots.push_back(slot);
+	live--;
+
+	// generation zero is skipped so a live handle is never zero
+	generations[slot] = (generations[slot] + 1) & (~0u >> handle::INDEX_BITS);
+	if (generations[slot] == 0)
+	{
+		generations[slot] = 1;
+	}
+	return true;
+}
+
+template<typename T, int BLOCK_SIZE>
+void Pool<T, BLOCK_SIZE>::releaseAll()
+{
+	for (int slot = capacity() - 1; slot >= 0; slot--)
+	{
+		if (used[slot])
+		{
+			handle item;
+			item.value = (generations[slot] << handle::INDEX_BITS) | static_cast<uint32_t>(slot);
+			release(item);
+		}
+	}
+
+	// rebuilt so the lowest slots are handed out first again
+	free_slots.clear();
+	for (int slot = capacity() - 1; slot >= 0; slot--)
+	{
+		free_slots.push_back(slot);
+	}
+}
+
+template<typename T, int BLOCK_SIZE>
+bool Pool<T, BLOCK_SIZE>::valid(handle item) const
+{
+	int slot = item.index();
+	return item.value != 0 && slot < static_cast<int>(used.size()) &&
+		used[slot] && generations[slot] == item.generation();
+}
+
+template<typename T, int BLOCK_SIZE>
+T* Pool<T, BLOCK_SIZE>::get(handle item)
+{
+	if (!valid(item))
+	{
+		return nullptr;
+	}
+
+	int slot = item.index();
+	return &blocks[slot / BLOCK_SIZE][slot % BLOCK_SIZE];
+}
+
+template<typename T, int BLOCK_SIZE>
+const T* Pool<T, BLOCK_SIZE>::get(handle item) const
+{
+	if (!valid(item))
+	{
+		return nullptr;
+	}
+
+	int slot = item.index();
+	return &blocks[slot / BLOCK_SIZE][slot % BLOCK_SIZE];
+}
+
+template<typename T, int BLOCK_SIZE>
+int Pool<T, BLOCK_SIZE>::size() const
+{
+	return live;
+}
+
+template<typename T, int BLOCK_SIZE>
+int Pool<T, BLOCK_SIZE>::capacity() const
+{
+	return static_cast<int>(blocks.size()) * BLOCK_SIZE;
+}
+
+/**
+*   @brief   Adds a block of items.
+*   @details The free list is reserved for every slot up front, so
+             releasing items never has to allocate.
+*   @return  void
+*/
+template<typename T, int BLOCK_SIZE>
+void Pool<T, BLOCK_SIZE>::grow()
+{
+	int first = capacity();
+	blocks.push_back(std::unique_ptr<T[]>(new T[BLOCK_SIZE]));
+	generations.resize(first + BLOCK_SIZE, 1);
+	used.resize(first + BLOCK_SIZE, 0);
+	free_slots.reserve(first + BLOCK_SIZE);
+
+	for (int slot = first + BLOCK_SIZE - 1; slot >= first; slot--)
+	{
+		free_slots.push_back(slot);
+	}
+}
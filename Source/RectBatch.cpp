@@ -0,0 +1,147 @@
+#include <float.h>
+#include <stddef.h>
+#include "RectBatch.h"
+#include "Sweep.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RECT_BATCH_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define RECT_BATCH_SSE
+#endif
+
+namespace
+{
+	int countBits(uint32_t bits)
+	{
+		bits = bits - ((bits >> 1) & 0x55555555u);
+		bits = (bits & 0x33333333u) + ((bits >> 2) & 0x33333333u);
+		return static_cast<int>((((bits + (bits >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24);
+	}
+}
+
+void RectBatch::clear()
+{
+	min_x.clear();
+	min_y.clear();
+	max_x.clear();
+	max_y.clear();
+	count = 0;
+}
+
+void RectBatch::reserve(int rects)
+{
+	size_t padded = static_cast<size_t>((rects + LANES - 1) / LANES * LANES);
+	min_x.reserve(padded);
+	min_y.reserve(padded);
+	max_x.reserve(padded);
+	max_y.reserve(padded);
+}
+
+/**
+*   @brief   Adds a rectangle to the set.
+*   @details The arrays grow a whole block of lanes at a time, with the
+             unused lanes being inside out so they never overlap.
+*   @return  The index of the rectangle.
+*/
+int RectBatch::add(const rect& box)
+{
+	if (count == static_cast<int>(min_x.size()))
+	{
+		min_x.insert(min_x.end(), LANES, FLT_MAX);
+		min_y.insert(min_y.end(), LANES, FLT_MAX);
+		max_x.insert(max_x.end(), LANES, -FLT_MAX);
+		max_y.insert(max_y.end(), LANES, -FLT_MAX);
+	}
+
+	min_x[count] = box.x;
+	min_y[count] = box.y;
+	max_x[count] = box.x + box.length;
+	max_y[count] = box.y + box.height;
+	return count++;
+}
+
+int RectBatch::size() const
+{
+	return count;
+}
+
+/**
+*   @brief   Tests a rectangle against the whole set.
+*   @details Two rectangles overlap when each one's minimum edge is not
+             past the other's maximum edge on both axes. Every lane
+			 performs all four comparisons and the results are packed
+			 into the mask, so there are no per rectangle branches.
+*   @return  The number of overlapping rectangles.
+*/
+int RectBatch::overlaps(const rect& box, std::vector<uint32_t>& mask) const
+{
+	const int padded = static_cast<int>(min_x.size());
+	mask.assign((padded + 31) / 32, 0u);
+
+	const float box_min_x = box.x;
+	const float box_min_y = box.y;
+	const float box_max_x = box.x + box.length;
+	const float box_max_y = box.y + box.height;
+
+	int hits = 0;
+	int i = 0;
+
+#if defined(RECT_BATCH_AVX)
+	const __m256 lhs_min_x = _mm256_set1_ps(box_min_x);
+	const __m256 lhs_min_y = _mm256_set1_ps(box_min_y);
+	const __m256 lhs_max_x = _mm256_set1_ps(box_max_x);
+	const __m256 lhs_max_y = _mm256_set1_ps(box_max_y);
+
+	for (; i + 8 <= padded; i += 8)
+	{
+		__m256 x1 = _mm256_cmp_ps(lhs_min_x, _mm256_loadu_ps(&max_x[i]), _CMP_LE_OQ);
+		__m256 x2 = _mm256_cmp_ps(_mm256_loadu_ps(&min_x[i]), lhs_max_x, _CMP_LE_OQ);
+		__m256 y1 = _mm256_cmp_ps(lhs_min_y, _mm256_loadu_ps(&max_y[i]), _CMP_LE_OQ);
+		__m256 y2 = _mm256_cmp_ps(_mm256_loadu_ps(&min_y[i]), lhs_max_y, _CMP_LE_OQ);
+		__m256 hit = _mm256_and_ps(_mm256_and_ps(x1, x2), _mm256_and_ps(y1, y2));
+
+		uint32_t bits = static_cast<uint32_t>(_mm256_movemask_ps(hit));
+		mask[i >> 5] |= bits << (i & 31);
+		hits += countBits(bits);
+	}
+#elif defined(RECT_BATCH_SSE)
+	const __m128 lhs_min_x = _mm_set1_ps(box_min_x);
+	const __m128 lhs_min_y = _mm_set1_ps(box_min_y);
+	const __m128 lhs_max_x = _mm_set1_ps(box_max_x);
+	const __m128 lhs_max_y = _mm_set1_ps(box_max_y);
+
+	for (; i + 4 <= padded; i += 4)
+	{
+		__m128 x1 = _mm_cmple_ps(lhs_min_x, _mm_loadu_ps(&max_x[i]));
+		__m128 x2 = _mm_cmple_ps(_mm_loadu_ps(&min_x[i]), lhs_max_x);
+		__m128 y1 = _mm_cmple_ps(lhs_min_y, _mm_loadu_ps(&max_y[i]));
+		__m128 y2 = _mm_cmple_ps(_mm_loadu_ps(&min_y[i]), lhs_max_y);
+		__m128 hit = _mm_and_ps(_mm_and_ps(x1, x2), _mm_and_ps(y1, y2));
+
+		uint32_t bits = static_cast<uint32_t>(_mm_movemask_ps(hit));
+		mask[i >> 5] |= bits << (i & 31);
+		hits += countBits(bits);
+	}
+#endif
+
+	for (; i < padded; i++)
+	{
+		uint32_t hit =
+			static_cast<uint32_t>(box_min_x <= max_x[i]) &
+			static_cast<uint32_t>(min_x[i] <= box_max_x) &
+			static_cast<uint32_t>(box_min_y <= max_y[i]) &
+			static_cast<uint32_t>(min_y[i] <= box_max_y);
+
+		mask[i >> 5] |= hit << (i & 31);
+		hits += static_cast<int>(hit);
+	}
+
+	return hits;
+}
+
+int RectBatch::overlaps(const rect& box, const vector2& motion, std::vector<uint32_t>& mask) const
+{
+	return overlaps(sweptBounds(box, motion), mask);
+}
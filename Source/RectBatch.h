@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+#include "Rect.h"
+#include "Vector2.h"
+
+/**
+*  A set of rectangles stored as a structure of arrays.
+*  Each edge of the rectangles lives in its own contiguous array, so
+*  several rectangles can be loaded into a SIMD register at once and
+*  tested against another rectangle without any branching. The arrays
+*  are padded to a multiple of the widest lane count using rectangles
+*  that can never overlap anything.
+*  @see rect
+*/
+class RectBatch
+{
+public:
+
+	/**
+	*  The number of rectangles the arrays are padded to a multiple of.
+	*/
+	static const int LANES = 8;
+
+	/**
+	*  Removes every rectangle, keeping the memory for reuse.
+	*/
+	void clear();
+
+	/**
+	*  Reserves space for a number of rectangles.
+	*  @param [in] count The number of rectangles
+	*/
+	void reserve(int count);
+
+	/**
+	*  Adds a rectangle to the end of the set.
+	*  @param [in] box The rectangle to add
+	*  @return the index of the rectangle within the set
+	*/
+	int  add(const rect& box);
+
+	/**
+	*  Returns the number of rectangles in the set.
+	*  @return the rectangle count, excluding any padding
+	*/
+	int  size() const;
+
+	/**
+	*  Tests a rectangle against every rectangle in the set.
+	*  Bit n of word n / 32 in the mask is set if rectangle n overlaps.
+	*  Uses AVX or SSE when available, otherwise plain scalar code.
+	*  Touching edges count as overlapping, matching rect::isInside.
+	*  @param [in] box The rectangle to test
+	*  @param [out] mask The hit mask, resized to fit the set
+	*  @return the number of rectangles overlapping
+	*/
+	int  overlaps(const rect& box, std::vector<uint32_t>& mask) const;
+
+	/**
+	*  Tests a moving rectangle against every rectangle in the set.
+	*  The area covered by the whole motion is used, so this acts as a
+	*  conservative filter before running an exact swept test.
+	*  @param [in] box The rectangle at the start of the motion
+	*  @param [in] motion The displacement over the step
+	*  @param [out] mask The hit mask, resized to fit the set
+	*  @return the number of rectangles possibly touched
+	*/
+	int  overlaps(const rect& box, const vector2& motion, std::vector<uint32_t>& mask) const;
+
+private:
+	std::vector<float> min_x;
+	std::vector<float> min_y;
+	std::vector<float> max_x;
+	std::vector<float> max_y;
+	int count = 0;
+};
@@ -0,0 +1,112 @@
+#include "Resample.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RESAMPLE_SSE2
+#endif
+
+namespace
+{
+	void premultiply(std::vector<uint8_t>& pixels)
+	{
+		for (size_t i = 0; i < pixels.size(); i += 4)
+		{
+			int alpha = pixels[i + 3];
+			for (int c = 0; c < 3; c++)
+			{
+				pixels[i + c] = static_cast<uint8_t>((pixels[i + c] * alpha + 127) / 255);
+			}
+		}
+	}
+
+	void unpremultiply(std::vector<uint8_t>& pixels)
+	{
+		for (size_t i = 0; i < pixels.size(); i += 4)
+		{
+			int alpha = pixels[i + 3];
+			for (int c = 0; c < 3; c++)
+			{
+				int value = alpha ? (pixels[i + c] * 255 + alpha / 2) / alpha : 0;
+				pixels[i + c] = static_cast<uint8_t>(value > 255 ? 255 : value);
+			}
+		}
+	}
+
+	void averageScalar(const uint8_t* top, const uint8_t* bottom, int left, int right, uint8_t* out)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			int sum = top[left * 4 + c] + top[right * 4 + c] + bottom[left * 4 + c] + bottom[right * 4 + c];
+			out[c] = static_cast<uint8_t>((sum + 2) >> 2);
+		}
+	}
+}
+
+/**
+*   @brief   Halves an image with a box filter.
+*   @details The colours are premultiplied so the average weights them
+             by alpha, then divided back out. Each output row averages
+			 two input rows. Pairs of output pixels away from an odd
+			 right edge are done with SSE2, sums held in 16 bits.
+*   @return  True if the image was halved.
+*/
+bool halveImage(const image& source, image& halved)
+{
+	if (source.width <= 0 || source.height <= 0 ||
+		source.pixels.size() < static_cast<size_t>(source.width) * source.height * 4)
+	{
+		return false;
+	}
+
+	std::vector<uint8_t> weighted(source.pixels.begin(),
+		source.pixels.begin() + static_cast<size_t>(source.width) * source.height * 4);
+	premultiply(weighted);
+
+	halved.width = (source.width + 1) / 2;
+	halved.height = (source.height + 1) / 2;
+	halved.pixels.resize(static_cast<size_t>(halved.width) * halved.height * 4);
+
+	// output pixels whose 2x2 block lies wholly inside the source
+	const int whole = source.width / 2;
+
+	for (int y = 0; y < halved.height; y++)
+	{
+		const uint8_t* top = weighted.data() + static_cast<size_t>(y * 2) * source.width * 4;
+		const int below = y * 2 + 1 < source.height ? y * 2 + 1 : y * 2;
+		const uint8_t* bottom = weighted.data() + static_cast<size_t>(below) * source.width * 4;
+		uint8_t* out = halved.pixels.data() + static_cast<size_t>(y) * halved.width * 4;
+		int x = 0;
+
+#if defined(RESAMPLE_SSE2)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i rounding = _mm_set1_epi16(2);
+		for (; x + 2 <= whole; x += 2)
+		{
+			__m128i upper = _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + x * 8));
+			__m128i lower = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + x * 8));
+
+			// columns summed down, pixels 0 and 1 in one register, 2 and 3 in the other
+			__m128i first = _mm_add_epi16(_mm_unpacklo_epi8(upper, zero), _mm_unpacklo_epi8(lower, zero));
+			__m128i second = _mm_add_epi16(_mm_unpackhi_epi8(upper, zero), _mm_unpackhi_epi8(lower, zero));
+
+			// then each pair summed across
+			first = _mm_add_epi16(first, _mm_srli_si128(first, 8));
+			second = _mm_add_epi16(second, _mm_srli_si128(second, 8));
+
+			__m128i sums = _mm_unpacklo_epi64(first, second);
+			__m128i averages = _mm_srli_epi16(_mm_add_epi16(sums, rounding), 2);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(averages, averages));
+		}
+#endif
+
+		for (; x < halved.width; x++)
+		{
+			const int left = x * 2;
+			const int right = left + 1 < source.width ? left + 1 : left;
+			averageScalar(top, bottom, left, right, out + x * 4);
+		}
+	}
+
+	unpremultiply(halved.pixels);
+	return true;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include "Png.h"
+
+/**
+*  Halves an image with a 2x2 box filter, making the next level of its
+*  mip chain.
+*  Colours are weighted by alpha, so transparent pixels don't darken
+*  the edges of what's left. An odd width or height rounds up, the last
+*  column or row being averaged with itself. The filter runs four
+*  channels of two pixels at a time with SSE2 where it's available.
+*  @param [in] source The image to halve
+*  @param [out] halved The image at half the size
+*  @return true if the image was halved, false if it was empty
+*/
+bool halveImage(const image& source, image& halved);
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <string.h>
+#include "Path.h"
+#include "ResourcePack.h"
+
+static_assert(sizeof(pack_header) == 32, "pack_header must match the file layout");
+static_assert(sizeof(pack_entry) == 48, "pack_entry must match the file layout");
+
+/**
+*   @brief   Maps a pack.
+*   @details Checks the header and that the index and names lie inside
+             the file. Each entry is checked as it's found, so opening
+			 doesn't touch any more of the file than the header.
+*   @return  True if the pack was opened.
+*/
+bool ResourcePack::open(const std::string& path)
+{
+	close();
+
+	if (!file.open(path) || file.size() < sizeof(pack_header))
+	{
+		close();
+		return false;
+	}
+
+	const pack_header* mapped = reinterpret_cast<const pack_header*>(file.data());
+	const uint64_t size = file.size();
+	if (memcmp(mapped->magic, "ABPK", 4) != 0 || mapped->version != VERSION ||
+		mapped->index_offset > size || mapped->names_offset > size ||
+		mapped->entry_count > (size - mapped->index_offset) / sizeof(pack_entry))
+	{
+		close();
+		return false;
+	}
+
+	header = mapped;
+	index = reinterpret_cast<const pack_entry*>(file.data() + header->index_offset);
+	names = file.data() + header->names_offset;
+
+	uint64_t file_size = 0;
+	fileStamp(path, file_size, modified_time);
+	return true;
+}
+
+void ResourcePack::close()
+{
+	file.close();
+	header = nullptr;
+	index = nullptr;
+	names = nullptr;
+	modified_time = 0;
+}
+
+/**
+*   @brief   Finds a file in the pack.
+*   @details Binary searches for the first entry with the path's hash,
+             then compares names until the hash changes.
+*   @return  The entry, or null.
+*/
+const pack_entry* ResourcePack::find(const std::string& path) const
+{
+	if (!header)
+	{
+		return nullptr;
+	}
+
+	const std::string key = normalisePath(path);
+	const uint64_t hash = hashPath(key.data(), key.size());
+	const pack_entry* end = index + header->entry_count;
+	const pack_entry* entry = std::lower_bound(index, end, hash,
+		[](const pack_entry& lhs, uint64_t rhs) { return lhs.hash < rhs; });
+
+	for (; entry != end && entry->hash == hash; entry++)
+	{
+		if (entry->name_length == key.size() &&
+			header->names_offset + entry->name_offset + entry->name_length <= file.size() &&
+			memcmp(names + entry->name_offset, key.data(), key.size()) == 0)
+		{
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
+
+file_view ResourcePack::stored(const pack_entry& entry) const
+{
+	file_view view;
+	if (header && entry.offset <= file.size() && entry.stored_size <= file.size() - entry.offset)
+	{
+		view.data = file.data() + entry.offset;
+		view.size = static_cast<size_t>(entry.stored_size);
+	}
+	return view;
+}
+
+int64_t ResourcePack::modified() const
+{
+	return modified_time;
+}
+
+int ResourcePack::size() const
+{
+	return header ? static_cast<int>(header->entry_count) : 0;
+}
+
+uint64_t ResourcePack::hashPath(const char* path, size_t length)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= static_cast<uint8_t>(path[i]);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include "MappedFile.h"
+
+/**
+*  The bytes of one file, pointing into memory owned elsewhere.
+*/
+struct file_view
+{
+	const char* data = nullptr;
+	size_t size = 0;
+};
+
+/**
+*  The start of a pack file.
+*  Every offset is from the start of the file and every value is
+*  little endian, as written by the machines building packs.
+*/
+struct pack_header
+{
+	char     magic[4];
+	uint32_t version = 0;
+	uint32_t entry_count = 0;
+	uint32_t alignment = 0;
+	uint64_t index_offset = 0;
+	uint64_t names_offset = 0;
+};
+
+/**
+*  How a file's bytes are stored in a pack.
+*/
+enum class PackCompression : uint32_t
+{
+	STORED = 0,   /**< As they are. Used for files that are already compressed. */
+	LZ4 = 1       /**< As an LZ4 block. */
+};
+
+/**
+*  One file in a pack's index.
+*  The index is sorted by hash, then by name for equal hashes.
+*/
+struct pack_entry
+{
+	uint64_t hash = 0;
+	uint64_t offset = 0;
+	uint64_t size = 0;          // once decompressed
+	uint64_t stored_size = 0;   // in the pack
+	uint32_t name_offset = 0;   // from the start of the names
+	uint32_t name_length = 0;
+	uint32_t compression = 0;   // a PackCompression
+	uint32_t reserved = 0;
+};
+
+/**
+*  A single file holding many others, read through a memory mapping.
+*  A pack is laid out as a header, an index of every file, the files'
+*  normalised paths and then the files themselves, each starting on an
+*  aligned boundary. Opening a pack maps it in one go, so loading any
+*  number of files from it costs one open rather than one each.
+*  Files are found by binary searching the index for the hash of their
+*  path. Stored files are handed out as views straight into the
+*  mapping, compressed ones are left for the caller to decompress.
+*/
+class ResourcePack
+{
+public:
+	static const uint32_t VERSION = 2;
+	static const uint32_t ALIGNMENT = 64;
+
+	/**
+	*  Default constructor.
+	*/
+	ResourcePack() = default;
+
+	/**
+	*  Maps a pack, closing any pack already open.
+	*  @param [in] path The path to the pack file
+	*  @return true if the file was mapped and is a pack of this version
+	*/
+	bool open(const std::string& path);
+
+	/**
+	*  Unmaps the pack. Views into it are no longer valid.
+	*/
+	void close();
+
+	/**
+	*  Finds a file in the pack.
+	*  @param [in] path The file's path, normalised before looking it up
+	*  @return the file's entry, or null if the pack doesn't hold it
+	*/
+	const pack_entry* find(const std::string& path) const;
+
+	/**
+	*  Returns a file's bytes as they are stored.
+	*  @param [in] entry An entry returned by find
+	*  @return the stored bytes, valid until the pack closes, or an empty
+	*  view if the entry points outside the file
+	*/
+	file_view stored(const pack_entry& entry) const;
+
+	/**
+	*  Returns when the pack was last written, so anything derived from
+	*  its files can tell when it's rebuilt.
+	*  @return seconds since 1970, or zero if no pack is open
+	*/
+	int64_t modified() const;
+
+	/**
+	*  Returns the number of files in the pack.
+	*  @return the file count, or zero if no pack is open
+	*/
+	int  size() const;
+
+	/**
+	*  Hashes a normalised path for the index.
+	*  @param [in] path The normalised path
+	*  @param [in] length The path's length
+	*  @return the 64 bit FNV-1a hash of the path
+	*/
+	static uint64_t hashPath(const char* path, size_t length);
+
+private:
+	MappedFile file;
+	const pack_header* header = nullptr;
+	const pack_entry* index = nullptr;
+	const char* names = nullptr;
+	int64_t modified_time = 0;
+};
@@ -0,0 +1,473 @@
+#if defined(ASGE_HEADLESS)
+
+#include <math.h>
+#include <chrono>
+#include <string.h>
+#include "SoftwareRenderer.h"
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_RENDERER_SSE2
+#endif
+
+namespace
+{
+	int clampInt(int value, int low, int high)
+	{
+		return value < low ? low : (value > high ? high : value);
+	}
+
+	int toFixed(float value)
+	{
+		return clampInt(static_cast<int>(value * 256.0f + 0.5f), 0, 256);
+	}
+
+	bool isWhole(float value)
+	{
+		return floorf(value) == value;
+	}
+
+	/**
+	*   @brief   Tints a texel and blends it over a pixel.
+	*   @details The same sums as sampling exactly on a texel centre.
+	*   @return  void
+	*/
+	inline void blendTexel(const uint8_t* texel, const int tint[4], uint8_t* pixel)
+	{
+		const int alpha_tinted = (texel[3] * tint[3]) >> 8;
+		const int alpha = alpha_tinted + (alpha_tinted >> 7);
+		if (alpha == 0)
+		{
+			return;
+		}
+
+		for (int c = 0; c < 3; c++)
+		{
+			const int colour = (texel[c] * tint[c]) >> 8;
+			pixel[c] = static_cast<uint8_t>((colour * alpha + pixel[c] * (256 - alpha)) >> 8);
+		}
+		pixel[3] = 255;
+	}
+
+	/**
+	*   @brief   Blends a run of texels over a run of pixels, one to one.
+	*   @details SSE2 blends four pixels at a time. Four untinted opaque
+	             texels are copied as they are, which is most of any
+				 background.
+	*   @return  void
+	*/
+	void blendRow(const uint8_t* texels, const int tint[4], uint8_t* pixels, int count)
+	{
+		int i = 0;
+#if defined(SOFTWARE_RENDERER_SSE2)
+		const bool untinted = tint[0] == 256 && tint[1] == 256 && tint[2] == 256 && tint[3] == 256;
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alpha_bits = _mm_set1_epi32(static_cast<int>(0xff000000u));
+		const __m128i full = _mm_set1_epi16(256);
+		const __m128i tints = _mm_set_epi16(
+			static_cast<short>(tint[3]), static_cast<short>(tint[2]), static_cast<short>(tint[1]), static_cast<short>(tint[0]),
+			static_cast<short>(tint[3]), static_cast<short>(tint[2]), static_cast<short>(tint[1]), static_cast<short>(tint[0]));
+
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i texel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texels + i * 4));
+			if (untinted && _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(texel, alpha_bits), alpha_bits)) == 0xffff)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i * 4), texel);
+				continue;
+			}
+
+			const __m128i under = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4));
+			__m128i halves[2] = { _mm_unpacklo_epi8(texel, zero), _mm_unpackhi_epi8(texel, zero) };
+			const __m128i behind[2] = { _mm_unpacklo_epi8(under, zero), _mm_unpackhi_epi8(under, zero) };
+			for (int half = 0; half < 2; half++)
+			{
+				__m128i colour = _mm_srli_epi16(_mm_mullo_epi16(halves[half], tints), 8);
+				__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(colour, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+				alpha = _mm_add_epi16(alpha, _mm_srli_epi16(alpha, 7));
+				halves[half] = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(colour, alpha),
+					_mm_mullo_epi16(behind[half], _mm_sub_epi16(full, alpha))), 8);
+			}
+
+			const __m128i blended = _mm_or_si128(_mm_packus_epi16(halves[0], halves[1]), alpha_bits);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i * 4), blended);
+		}
+#endif
+		for (; i < count; i++)
+		{
+			blendTexel(texels + i * 4, tint, pixels + i * 4);
+		}
+	}
+
+	/**
+	*   @brief   Samples a texel, tints it and blends it over a pixel.
+	*   @details The four texels around the sample are blended down the
+	             columns and then across, with weights out of 256, and
+				 the result multiplied by the tint. SSE2 does all four
+				 channels of a texel at once, rounding as the scalar
+				 code does.
+	*   @return  void
+	*/
+	inline void shade(const uint8_t* texels, int pitch, const int clamp[4], const int tint[4],
+		float u, float v, uint8_t* pixel)
+	{
+		// weights are rounded, so a sample a hair off a texel centre takes that texel alone
+		const int fixed_u = static_cast<int>(floorf(u * 256.0f + 0.5f));
+		const int fixed_v = static_cast<int>(floorf(v * 256.0f + 0.5f));
+		const int fx = fixed_u & 255;
+		const int fy = fixed_v & 255;
+		const int x0 = fixed_u >> 8;
+		const int y0 = fixed_v >> 8;
+		const int xa = clampInt(x0, clamp[0], clamp[1]);
+		const int xb = clampInt(x0 + 1, clamp[0], clamp[1]);
+		const int ya = clampInt(y0, clamp[2], clamp[3]);
+		const int yb = clampInt(y0 + 1, clamp[2], clamp[3]);
+
+		const uint8_t* row_a = texels + static_cast<size_t>(ya) * pitch * 4;
+		const uint8_t* row_b = texels + static_cast<size_t>(yb) * pitch * 4;
+
+#if defined(SOFTWARE_RENDERER_SSE2)
+		uint32_t t00, t10, t01, t11, under;
+		memcpy(&t00, row_a + xa * 4, 4);
+		memcpy(&t10, row_a + xb * 4, 4);
+		memcpy(&t01, row_b + xa * 4, 4);
+		memcpy(&t11, row_b + xb * 4, 4);
+		memcpy(&under, pixel, 4);
+
+		const __m128i zero = _mm_setzero_si128();
+		__m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi32(
+			_mm_cvtsi32_si128(static_cast<int>(t00)), _mm_cvtsi32_si128(static_cast<int>(t10))), zero);
+		__m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi32(
+			_mm_cvtsi32_si128(static_cast<int>(t01)), _mm_cvtsi32_si128(static_cast<int>(t11))), zero);
+
+		__m128i column = _mm_srli_epi16(_mm_add_epi16(
+			_mm_mullo_epi16(top, _mm_set1_epi16(static_cast<short>(256 - fy))),
+			_mm_mullo_epi16(bottom, _mm_set1_epi16(static_cast<short>(fy)))), 8);
+
+		const short left = static_cast<short>(256 - fx);
+		const short right = static_cast<short>(fx);
+		__m128i across = _mm_mullo_epi16(column, _mm_set_epi16(right, right, right, right, left, left, left, left));
+		__m128i colour = _mm_srli_epi16(_mm_add_epi16(across, _mm_srli_si128(across, 8)), 8);
+		colour = _mm_srli_epi16(_mm_mullo_epi16(colour, _mm_set_epi16(0, 0, 0, 0,
+			static_cast<short>(tint[3]), static_cast<short>(tint[2]),
+			static_cast<short>(tint[1]), static_cast<short>(tint[0]))), 8);
+
+		int alpha = _mm_extract_epi16(colour, 3);
+		alpha += alpha >> 7;
+		if (alpha == 0)
+		{
+			return;
+		}
+
+		__m128i destination = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(under)), zero);
+		__m128i blended = _mm_srli_epi16(_mm_add_epi16(
+			_mm_mullo_epi16(colour, _mm_set1_epi16(static_cast<short>(alpha))),
+			_mm_mullo_epi16(destination, _mm_set1_epi16(static_cast<short>(256 - alpha)))), 8);
+
+		uint32_t result = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(blended, blended)));
+		result |= 0xff000000u;
+		memcpy(pixel, &result, 4);
+#else
+		const uint8_t* t00 = row_a + xa * 4;
+		const uint8_t* t10 = row_a + xb * 4;
+		const uint8_t* t01 = row_b + xa * 4;
+		const uint8_t* t11 = row_b + xb * 4;
+
+		int colour[4];
+		for (int c = 0; c < 4; c++)
+		{
+			int left = (t00[c] * (256 - fy) + t01[c] * fy) >> 8;
+			int right = (t10[c] * (256 - fy) + t11[c] * fy) >> 8;
+			colour[c] = (((left * (256 - fx) + right * fx) >> 8) * tint[c]) >> 8;
+		}
+
+		int alpha = colour[3] + (colour[3] >> 7);
+		if (alpha == 0)
+		{
+			return;
+		}
+
+		for (int c = 0; c < 3; c++)
+		{
+			pixel[c] = static_cast<uint8_t>((colour[c] * alpha + pixel[c] * (256 - alpha)) >> 8);
+		}
+		pixel[3] = 255;
+#endif
+	}
+}
+
+SoftwareRenderer::SoftwareRenderer(ThreadPool* pool) :
+	thread_pool(pool)
+{
+}
+
+bool SoftwareRenderer::init(int w, int h, ASGE::Renderer::WindowMode mode)
+{
+	if (!NullRenderer::init(w, h, mode) || w <= 0 || h <= 0)
+	{
+		return false;
+	}
+
+	frame_buffer.width = w;
+	frame_buffer.height = h;
+	frame_buffer.pixels.assign(static_cast<size_t>(w) * h * 4, 0);
+
+	tiles_x = (w + TILE_SIZE - 1) / TILE_SIZE;
+	tiles_y = (h + TILE_SIZE - 1) / TILE_SIZE;
+	bins.assign(static_cast<size_t>(tiles_x) * tiles_y, std::vector<int>());
+	return true;
+}
+
+/**
+*   @brief   Ends the frame and draws it.
+*   @details The null renderer puts the sprites in drawing order and
+             counts them, then they are binned and the tiles drawn
+			 across the thread pool. On a render thread, this runs
+			 alongside the update's own batches on the same pool.
+*   @return  void
+*/
+void SoftwareRenderer::postRender()
+{
+	NullRenderer::postRender();
+	if (bins.empty())
+	{
+		return;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	bin();
+	const int tiles = static_cast<int>(bins.size());
+	if (thread_pool)
+	{
+		thread_pool->run(tiles, [this](int tile)
+		{
+			drawTile(tile);
+		});
+	}
+	else
+	{
+		for (int tile = 0; tile < tiles; tile++)
+		{
+			drawTile(tile);
+		}
+	}
+	draw_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+const image& SoftwareRenderer::framebuffer() const
+{
+	return frame_buffer;
+}
+
+double SoftwareRenderer::drawMilliseconds() const
+{
+	return draw_ms;
+}
+
+/**
+*   @brief   Works out how a sprite maps onto the screen.
+*   @details The quad is the sprite's size times its scale, placed at
+             its position and turned about its centre. Going back from
+			 a pixel's centre to the quad and on to the texture is
+			 affine, so each is kept as a pair of planes that a row of
+			 pixels steps along. Flips mirror the texture coordinates.
+			 An unset source rectangle samples the whole texture.
+*   @return  False if the sprite draws nothing.
+*/
+bool SoftwareRenderer::prepare(const sprite_draw& draw, prepared_sprite& sprite) const
+{
+	const NullTexture* texture = static_cast<const NullTexture*>(draw.texture);
+	if (!texture || texture->getFormat() != ASGE::Texture2D::RGBA || draw.alpha <= 0.0f)
+	{
+		return false;
+	}
+
+	const float width = draw.dims[0] * draw.scale;
+	const float height = draw.dims[1] * draw.scale;
+	const int texture_width = static_cast<int>(texture->getWidth());
+	const int texture_height = static_cast<int>(texture->getHeight());
+	if (width <= 0.0f || height <= 0.0f || texture_width <= 0 || texture_height <= 0)
+	{
+		return false;
+	}
+
+	float src[4] = { draw.src_rect[0], draw.src_rect[1], draw.src_rect[2], draw.src_rect[3] };
+	if (src[2] <= 0.0f || src[3] <= 0.0f)
+	{
+		src[0] = src[1] = 0.0f;
+		src[2] = static_cast<float>(texture_width);
+		src[3] = static_cast<float>(texture_height);
+	}
+
+	const float cosine = cosf(draw.angle);
+	const float sine = sinf(draw.angle);
+	const float centre_x = draw.position[0] + width * 0.5f;
+	const float centre_y = draw.position[1] + height * 0.5f;
+
+	// screen corners, to bound the pixels touched
+	const float half_x[2] = { cosine * width * 0.5f, -sine * height * 0.5f };
+	const float half_y[2] = { sine * width * 0.5f, cosine * height * 0.5f };
+	const float reach_x = fabsf(half_x[0]) + fabsf(half_x[1]);
+	const float reach_y = fabsf(half_y[0]) + fabsf(half_y[1]);
+	sprite.min_x = clampInt(static_cast<int>(floorf(centre_x - reach_x)), 0, frame_buffer.width);
+	sprite.max_x = clampInt(static_cast<int>(ceilf(centre_x + reach_x)) - 1, -1, frame_buffer.width - 1);
+	sprite.min_y = clampInt(static_cast<int>(floorf(centre_y - reach_y)), 0, frame_buffer.height);
+	sprite.max_y = clampInt(static_cast<int>(ceilf(centre_y + reach_y)) - 1, -1, frame_buffer.height - 1);
+	if (sprite.min_x > sprite.max_x || sprite.min_y > sprite.max_y)
+	{
+		return false;
+	}
+
+	// pixel (x, y) has its centre at (x + 0.5, y + 0.5)
+	const float offset_x = 0.5f - centre_x;
+	const float offset_y = 0.5f - centre_y;
+	sprite.edge[0][0] = cosine / width;
+	sprite.edge[0][1] = sine / width;
+	sprite.edge[0][2] = (cosine * offset_x + sine * offset_y) / width + 0.5f;
+	sprite.edge[1][0] = -sine / height;
+	sprite.edge[1][1] = cosine / height;
+	sprite.edge[1][2] = (cosine * offset_y - sine * offset_x) / height + 0.5f;
+
+	// texel centres sit half a texel in, so sampling starts half a texel back
+	const bool flips[2] = { draw.flip_x, draw.flip_y };
+	for (int axis = 0; axis < 2; axis++)
+	{
+		const float span = flips[axis] ? -src[2 + axis] : src[2 + axis];
+		const float origin = flips[axis] ? src[axis] + src[2 + axis] : src[axis];
+		sprite.texel[axis][0] = sprite.edge[axis][0] * span;
+		sprite.texel[axis][1] = sprite.edge[axis][1] * span;
+		sprite.texel[axis][2] = sprite.edge[axis][2] * span + origin - 0.5f;
+	}
+
+	sprite.clamp[0] = clampInt(static_cast<int>(floorf(src[0])), 0, texture_width - 1);
+	sprite.clamp[1] = clampInt(static_cast<int>(ceilf(src[0] + src[2])) - 1, sprite.clamp[0], texture_width - 1);
+	sprite.clamp[2] = clampInt(static_cast<int>(floorf(src[1])), 0, texture_height - 1);
+	sprite.clamp[3] = clampInt(static_cast<int>(ceilf(src[1] + src[3])) - 1, sprite.clamp[2], texture_height - 1);
+
+	// drawn texel for pixel, as most sprites are, every sample lands on a texel centre
+	sprite.exact = draw.angle == 0.0f && !draw.flip_x && !draw.flip_y &&
+		width == src[2] && height == src[3] &&
+		isWhole(draw.position[0]) && isWhole(draw.position[1]) &&
+		isWhole(src[0]) && isWhole(src[1]) && isWhole(src[2]) && isWhole(src[3]);
+	sprite.texel_offset[0] = static_cast<int>(src[0] - draw.position[0]);
+	sprite.texel_offset[1] = static_cast<int>(src[1] - draw.position[1]);
+
+	sprite.texels = texture->texels();
+	sprite.pitch = texture_width;
+	sprite.tint[0] = toFixed(draw.tint.r);
+	sprite.tint[1] = toFixed(draw.tint.g);
+	sprite.tint[2] = toFixed(draw.tint.b);
+	sprite.tint[3] = toFixed(draw.alpha);
+	return true;
+}
+
+/**
+*   @brief   Sorts the frame's sprites into the tiles they touch.
+*   @details Each tile lists its sprites in drawing order, so drawing
+             a tile's list in turn layers them as the whole frame
+			 would be.
+*   @return  void
+*/
+void SoftwareRenderer::bin()
+{
+	for (std::vector<int>& tile : bins)
+	{
+		tile.clear();
+	}
+
+	const std::vector<sprite_draw>& sprites = frameSprites();
+	prepared.resize(sprites.size());
+	for (int i = 0; i < static_cast<int>(sprites.size()); i++)
+	{
+		prepared_sprite& sprite = prepared[i];
+		if (!prepare(sprites[i], sprite))
+		{
+			continue;
+		}
+
+		for (int ty = sprite.min_y / TILE_SIZE; ty <= sprite.max_y / TILE_SIZE; ty++)
+		{
+			for (int tx = sprite.min_x / TILE_SIZE; tx <= sprite.max_x / TILE_SIZE; tx++)
+			{
+				bins[ty * tiles_x + tx].push_back(i);
+			}
+		}
+	}
+}
+
+/**
+*   @brief   Draws one tile.
+*   @details The tile is cleared to the clear colour, then each of its
+             sprites is drawn over the pixels it may touch. A pixel
+			 is drawn if its centre falls inside the quad.
+*   @return  void
+*/
+void SoftwareRenderer::drawTile(int tile)
+{
+	const int left = tile % tiles_x * TILE_SIZE;
+	const int top = tile / tiles_x * TILE_SIZE;
+	const int right = (left + TILE_SIZE < frame_buffer.width ? left + TILE_SIZE : frame_buffer.width) - 1;
+	const int bottom = (top + TILE_SIZE < frame_buffer.height ? top + TILE_SIZE : frame_buffer.height) - 1;
+	const size_t stride = static_cast<size_t>(frame_buffer.width) * 4;
+
+	const uint8_t clear[4] = {
+		static_cast<uint8_t>(clampInt(static_cast<int>(cls.r * 255.0f + 0.5f), 0, 255)),
+		static_cast<uint8_t>(clampInt(static_cast<int>(cls.g * 255.0f + 0.5f), 0, 255)),
+		static_cast<uint8_t>(clampInt(static_cast<int>(cls.b * 255.0f + 0.5f), 0, 255)),
+		255 };
+	for (int y = top; y <= bottom; y++)
+	{
+		uint8_t* pixel = frame_buffer.pixels.data() + y * stride + left * 4;
+		for (int x = left; x <= right; x++, pixel += 4)
+		{
+			memcpy(pixel, clear, 4);
+		}
+	}
+
+	for (int index : bins[tile])
+	{
+		const prepared_sprite& sprite = prepared[index];
+		const int x_start = sprite.min_x > left ? sprite.min_x : left;
+		const int x_end = sprite.max_x < right ? sprite.max_x : right;
+		const int y_start = sprite.min_y > top ? sprite.min_y : top;
+		const int y_end = sprite.max_y < bottom ? sprite.max_y : bottom;
+
+		if (sprite.exact)
+		{
+			for (int y = y_start; y <= y_end; y++)
+			{
+				const uint8_t* texels = sprite.texels +
+					(static_cast<size_t>(y + sprite.texel_offset[1]) * sprite.pitch + x_start + sprite.texel_offset[0]) * 4;
+				blendRow(texels, sprite.tint, frame_buffer.pixels.data() + y * stride + x_start * 4, x_end - x_start + 1);
+			}
+			continue;
+		}
+
+		for (int y = y_start; y <= y_end; y++)
+		{
+			const float fx = static_cast<float>(x_start);
+			const float fy = static_cast<float>(y);
+			const float across = sprite.edge[0][0] * fx + sprite.edge[0][1] * fy + sprite.edge[0][2];
+			const float down = sprite.edge[1][0] * fx + sprite.edge[1][1] * fy + sprite.edge[1][2];
+			const float u = sprite.texel[0][0] * fx + sprite.texel[0][1] * fy + sprite.texel[0][2];
+			const float v = sprite.texel[1][0] * fx + sprite.texel[1][1] * fy + sprite.texel[1][2];
+
+			// stepping from the row's start rather than adding up keeps texel centres exact
+			uint8_t* pixel = frame_buffer.pixels.data() + y * stride + x_start * 4;
+			for (int x = x_start; x <= x_end; x++, pixel += 4)
+			{
+				const float step = static_cast<float>(x - x_start);
+				const float quad_x = across + sprite.edge[0][0] * step;
+				const float quad_y = down + sprite.edge[1][0] * step;
+				if (quad_x >= 0.0f && quad_x < 1.0f && quad_y >= 0.0f && quad_y < 1.0f)
+				{
+					shade(sprite.texels, sprite.pitch, sprite.clamp, sprite.tint,
+						u + sprite.texel[0][0] * step, v + sprite.texel[1][0] * step, pixel);
+				}
+			}
+		}
+	}
+}
+
+#endif
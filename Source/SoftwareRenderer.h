@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include "NullRenderer.h"
+#include "Png.h"
+
+class ThreadPool;
+
+/**
+*  A renderer that draws on the CPU into an RGBA framebuffer.
+*  Builds on the null renderer, which keeps each frame's sprites in
+*  the order the sprite mode draws them. When the frame ends, every
+*  sprite is binned into the square tiles of the screen it touches,
+*  then the tiles are drawn in parallel on the game's thread pool, each
+*  thread owning whole tiles so no two write the same pixel. Sprites are sampled
+*  bilinearly within their source rectangle, tinted, faded by their
+*  opacity, flipped and rotated about their centre, then blended over
+*  what is already drawn. Text isn't drawn, as the engine's fonts
+*  aren't available outside it, though it is still counted.
+*/
+class SoftwareRenderer :
+	public NullRenderer
+{
+public:
+
+	static const int TILE_SIZE = 64;
+
+	/**
+	*  Constructor.
+	*  @param [in] pool The pool tiles are drawn across, or null to
+	*  draw them on the thread ending the frame. Must outlive the
+	*  renderer's last frame.
+	*/
+	explicit SoftwareRenderer(ThreadPool* pool = nullptr);
+
+	/**
+	*  Opens the framebuffer at the window's size.
+	*  @param [in] w The width in pixels
+	*  @param [in] h The height in pixels
+	*  @param [in] mode The window mode, which is only recorded
+	*  @return True if successful.
+	*/
+	virtual bool init(int w, int h, ASGE::Renderer::WindowMode mode) override;
+
+	/**
+	*  Ends the frame and draws it.
+	*/
+	virtual void postRender() override;
+
+	/**
+	*  Returns the last frame drawn.
+	*  @return the framebuffer, rows top to bottom, fully opaque
+	*/
+	const image& framebuffer() const;
+
+	/**
+	*  Returns the time spent drawing frames, binning included.
+	*  @return the total in milliseconds
+	*/
+	double drawMilliseconds() const;
+
+private:
+	struct prepared_sprite
+	{
+		const uint8_t* texels = nullptr;
+		int pitch = 0;                      // texels in a row of the texture
+		int min_x = 0, min_y = 0;           // screen pixels touched, inclusive
+		int max_x = 0, max_y = 0;
+		float edge[2][3];                   // screen to 0..1 across the quad
+		float texel[2][3];                  // screen to texture coordinates
+		int clamp[4];                       // first and last texel sampled, x then y
+		int tint[4];                        // RGBA multipliers out of 256
+		bool exact = false;                 // drawn texel for pixel, unrotated
+		int texel_offset[2];                // from pixel to texel when exact
+	};
+
+	bool prepare(const sprite_draw& draw, prepared_sprite& prepared) const;
+	void bin();
+	void drawTile(int tile);
+
+	ThreadPool* thread_pool = nullptr;
+	image frame_buffer;
+	std::vector<prepared_sprite> prepared;
+	std::vector<std::vector<int>> bins;
+	int tiles_x = 0;
+	int tiles_y = 0;
+	double draw_ms = 0.0;
+};
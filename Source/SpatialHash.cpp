@@ -0,0 +1,232 @@
+#include <math.h>
+#include "SpatialHash.h"
+
+/**
+*   @brief   Constructor.
+*   @details Requires the size of a cell in pixels.
+*   @return  void
+*/
+SpatialHash::SpatialHash(float cell_size_) :
+	cell_size(cell_size_ > 0 ? cell_size_ : 128.0f)
+{
+	inv_cell_size = 1.0f / cell_size;
+}
+
+/**
+*   @brief   Registers an object with the grid.
+*   @details Reuses a previously freed proxy when one is available.
+*   @return  The id of the new proxy.
+*/
+int SpatialHash::insert(const rect& bounds)
+{
+	int proxy_id = 0;
+	if (!free_proxies.empty())
+	{
+		proxy_id = free_proxies.back();
+		free_proxies.pop_back();
+	}
+	else
+	{
+		proxy_id = static_cast<int>(proxies.size());
+		proxies.emplace_back();
+	}
+
+	Proxy& proxy = proxies[proxy_id];
+	proxy.in_use = true;
+	proxy.bounds = bounds;
+	proxy.cells = cellRange(bounds);
+	addToCells(proxy_id, proxy.cells);
+
+	return proxy_id;
+}
+
+/**
+*   @brief   Moves an object within the grid.
+*   @details The cells are left untouched unless the range of cells
+             the object covers has changed.
+*   @return  void
+*/
+void SpatialHash::update(int proxy_id, const rect& bounds)
+{
+	Proxy& proxy = proxies[proxy_id];
+	proxy.bounds = bounds;
+
+	CellRange range = cellRange(bounds);
+	if (range.min_x == proxy.cells.min_x && range.min_y == proxy.cells.min_y &&
+		range.max_x == proxy.cells.max_x && range.max_y == proxy.cells.max_y)
+	{
+		return;
+	}
+
+	removeFromCells(proxy_id, proxy.cells);
+	addToCells(proxy_id, range);
+	proxy.cells = range;
+}
+
+/**
+*   @brief   Removes an object from the grid.
+*   @details The proxy id is placed on the free list.
+*   @return  void
+*/
+void SpatialHash::remove(int proxy_id)
+{
+	Proxy& proxy = proxies[proxy_id];
+	if (!proxy.in_use)
+	{
+		return;
+	}
+
+	removeFromCells(proxy_id, proxy.cells);
+	proxy = Proxy();
+	free_proxies.push_back(proxy_id);
+}
+
+void SpatialHash::clear()
+{
+	cells.clear();
+	proxies.clear();
+	free_proxies.clear();
+}
+
+/**
+*   @brief   Finds the objects overlapping an area.
+*   @details Visits each cell the area covers. A query stamp is used
+             so proxies spanning several cells are only tested once.
+*   @return  void
+*/
+void SpatialHash::query(const rect& area, std::vector<int>& results) const
+{
+	CellRange range = cellRange(area);
+	query_stamp++;
+
+	for (int cell_y = range.min_y; cell_y <= range.max_y; cell_y++)
+	{
+		for (int cell_x = range.min_x; cell_x <= range.max_x; cell_x++)
+		{
+			auto cell = cells.find(cellKey(cell_x, cell_y));
+			if (cell == cells.end())
+			{
+				continue;
+			}
+
+			for (int proxy_id : cell->second)
+			{
+				const Proxy& proxy = proxies[proxy_id];
+				if (proxy.stamp == query_stamp)
+				{
+					continue;
+				}
+
+				proxy.stamp = query_stamp;
+				if (area.isInside(proxy.bounds))
+				{
+					results.push_back(proxy_id);
+				}
+			}
+		}
+	}
+}
+
+/**
+*   @brief   Finds all the overlapping pairs.
+*   @details Pairs are tested per cell. A pair sharing several cells
+             is only reported by the first cell they have in common,
+			 which avoids the need to track the pairs already found.
+*   @return  void
+*/
+void SpatialHash::queryPairs(std::vector<ProxyPair>& pairs) const
+{
+	for (const auto& cell : cells)
+	{
+		int cell_x = static_cast<int32_t>(cell.first >> 32);
+		int cell_y = static_cast<int32_t>(cell.first & 0xffffffff);
+		const std::vector<int>& occupants = cell.second;
+
+		for (size_t i = 0; i < occupants.size(); i++)
+		{
+			const Proxy& a = proxies[occupants[i]];
+			for (size_t j = i + 1; j < occupants.size(); j++)
+			{
+				const Proxy& b = proxies[occupants[j]];
+
+				int first_x = a.cells.min_x > b.cells.min_x ? a.cells.min_x : b.cells.min_x;
+				int first_y = a.cells.min_y > b.cells.min_y ? a.cells.min_y : b.cells.min_y;
+				if (first_x != cell_x || first_y != cell_y)
+				{
+					continue;
+				}
+
+				if (a.bounds.isInside(b.bounds))
+				{
+					int lhs = occupants[i];
+					int rhs = occupants[j];
+					pairs.emplace_back(lhs < rhs ? lhs : rhs, lhs < rhs ? rhs : lhs);
+				}
+			}
+		}
+	}
+}
+
+const rect& SpatialHash::bounds(int proxy_id) const
+{
+	return proxies[proxy_id].bounds;
+}
+
+SpatialHash::CellRange SpatialHash::cellRange(const rect& bounds) const
+{
+	CellRange range;
+	range.min_x = static_cast<int>(floorf(bounds.x * inv_cell_size));
+	range.min_y = static_cast<int>(floorf(bounds.y * inv_cell_size));
+	range.max_x = static_cast<int>(floorf((bounds.x + bounds.length) * inv_cell_size));
+	range.max_y = static_cast<int>(floorf((bounds.y + bounds.height) * inv_cell_size));
+	return range;
+}
+
+SpatialHash::CellKey SpatialHash::cellKey(int cell_x, int cell_y) const
+{
+	return (static_cast<CellKey>(static_cast<uint32_t>(cell_x)) << 32) |
+		static_cast<uint32_t>(cell_y);
+}
+
+void SpatialHash::addToCells(int proxy_id, const CellRange& range)
+{
+	for (int cell_y = range.min_y; cell_y <= range.max_y; cell_y++)
+	{
+		for (int cell_x = range.min_x; cell_x <= range.max_x; cell_x++)
+		{
+			cells[cellKey(cell_x, cell_y)].push_back(proxy_id);
+		}
+	}
+}
+
+/**
+*   @brief   Removes a proxy from a range of cells.
+*   @details Emptied cells are kept, so objects moving back and forth
+             across cells don't cause the cell storage to reallocate.
+*   @return  void
+*/
+void SpatialHash::removeFromCells(int proxy_id, const CellRange& range)
+{
+	for (int cell_y = range.min_y; cell_y <= range.max_y; cell_y++)
+	{
+		for (int cell_x = range.min_x; cell_x <= range.max_x; cell_x++)
+		{
+			auto cell = cells.find(cellKey(cell_x, cell_y));
+			if (cell == cells.end())
+			{
+				continue;
+			}
+
+			std::vector<int>& occupants = cell->second;
+			for (size_t i = 0; i < occupants.size(); i++)
+			{
+				if (occupants[i] == proxy_id)
+				{
+					occupants[i] = occupants.back();
+					occupants.pop_back();
+					break;
+				}
+			}
+		}
+	}
+}
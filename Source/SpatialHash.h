@@ -0,0 +1,118 @@
+#pragma once
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Rect.h"
+
+/**
+*  A uniform grid used as a collision broadphase.
+*  The world is split into square cells and every object registered
+*  with the grid is stored in each of the cells its bounds touch. The
+*  cells are hashed, so only the occupied ones use any memory. Moving
+*  an object only touches the grid when the range of cells it covers
+*  changes, meaning most updates are just a bounds copy. Queries then
+*  only need to look at the objects sharing a cell with the area being
+*  tested, rather than at every object in the level.
+*  @see rect
+*/
+class SpatialHash
+{
+public:
+
+	/**
+	*  A pair of proxies whose bounds overlap.
+	*/
+	using ProxyPair = std::pair<int, int>;
+
+	/**
+	*  Constructor.
+	*  The cell size should be roughly that of the typical object. Too
+	*  small and objects span many cells, too large and each cell will
+	*  hold many objects that do not actually touch.
+	*  @param [in] cell_size The width and height of a cell in pixels
+	*/
+	explicit SpatialHash(float cell_size = 128.0f);
+
+	/**
+	*  Registers an object with the grid.
+	*  @param [in] bounds The area the object currently covers
+	*  @return the proxy id used to update or remove the object
+	*/
+	int  insert(const rect& bounds);
+
+	/**
+	*  Moves an object within the grid.
+	*  Cells are only touched when the object has entered or left one.
+	*  @param [in] proxy The proxy id returned when inserting
+	*  @param [in] bounds The area the object now covers
+	*/
+	void update(int proxy, const rect& bounds);
+
+	/**
+	*  Removes an object from the grid.
+	*  The proxy id is freed and may be handed out again.
+	*  @param [in] proxy The proxy id returned when inserting
+	*/
+	void remove(int proxy);
+
+	/**
+	*  Removes every object from the grid.
+	*/
+	void clear();
+
+	/**
+	*  Finds the objects whose bounds overlap an area.
+	*  Each overlapping proxy is reported once, even when it shares
+	*  several cells with the area.
+	*  @param [in] area The area to test
+	*  @param [out] results The overlapping proxy ids are appended here
+	*/
+	void query(const rect& area, std::vector<int>& results) const;
+
+	/**
+	*  Finds every pair of objects whose bounds overlap.
+	*  Each pair is reported once with the lower proxy id first.
+	*  @param [out] pairs The overlapping pairs are appended here
+	*/
+	void queryPairs(std::vector<ProxyPair>& pairs) const;
+
+	/**
+	*  Returns the bounds last given for a proxy.
+	*  @param [in] proxy The proxy id
+	*  @return the area the proxy covers
+	*/
+	const rect& bounds(int proxy) const;
+
+private:
+	struct CellRange
+	{
+		int min_x = 0;
+		int min_y = 0;
+		int max_x = -1;
+		int max_y = -1;
+	};
+
+	struct Proxy
+	{
+		rect bounds;
+		CellRange cells;
+		bool in_use = false;
+		mutable unsigned int stamp = 0;
+	};
+
+	using CellKey = uint64_t;
+
+	CellRange cellRange(const rect& bounds) const;
+	CellKey   cellKey(int cell_x, int cell_y) const;
+	void      addToCells(int proxy, const CellRange& range);
+	void      removeFromCells(int proxy, const CellRange& range);
+
+	float cell_size = 128.0f;
+	float inv_cell_size = 1.0f / 128.0f;
+	std::unordered_map<CellKey, std::vector<int>> cells;
+	std::vector<Proxy> proxies;
+	std::vector<int>   free_proxies;
+	mutable unsigned int query_stamp = 0;
+};
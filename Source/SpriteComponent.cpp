@@ -1,4 +1,5 @@
-#include <Engine\Renderer.h>
+#include <math.h>
+#include <Engine/Renderer.h>
 #include "SpriteComponent.h"
 
 SpriteComponent::~SpriteComponent()
@@ -6,18 +7,34 @@ SpriteComponent::~SpriteComponent()
 	freeSprite();
 }
 
+/**
+*   @brief   Loads the sprite.
+*   @details A sprite already showing the same texture is left as it
+             is, so a level can be rebuilt without going back to the
+			 renderer. Otherwise the texture is loaded into a new
+			 sprite, which only replaces the current one once it has
+			 loaded, so a failed load keeps what was there.
+*   @return  True if the sprite was loaded.
+*/
 bool SpriteComponent::loadSprite(
 	ASGE::Renderer* renderer, const std::string& texture_file_name)
 {
-	freeSprite();
-	sprite = renderer->createRawSprite();
-	if (sprite->loadTexture(texture_file_name))
+	if (sprite && texture_file_name == loaded_file_name)
 	{
 		return true;
 	}
 
+	ASGE::Sprite* loaded = renderer->createRawSprite();
+	if (!loaded->loadTexture(texture_file_name))
+	{
+		delete loaded;
+		return false;
+	}
+
 	freeSprite();
-	return false;
+	sprite = loaded;
+	loaded_file_name = texture_file_name;
+	return true;
 }
 
 void SpriteComponent::freeSprite()
@@ -27,6 +44,7 @@ void SpriteComponent::freeSprite()
 		delete sprite;
 		sprite = nullptr;
 	}
+	loaded_file_name.clear();
 }
 
 
@@ -38,11 +56,16 @@ ASGE::Sprite* SpriteComponent::getSprite()
 
 rect SpriteComponent::getBoundingBox() const
 {
+	float c = fabsf(cosf(sprite->rotationInRadians()));
+	float s = fabsf(sinf(sprite->rotationInRadians()));
+	float width = c * sprite->width() + s * sprite->height();
+	float height = s * sprite->width() + c * sprite->height();
+
 	rect bounding_box;
-	bounding_box.x = sprite->xPos();
-	bounding_box.y = sprite->yPos();
-	bounding_box.length = sprite->width();
-	bounding_box.height = sprite->height();
+	bounding_box.x = sprite->xPos() + (sprite->width() - width) * 0.5f;
+	bounding_box.y = sprite->yPos() + (sprite->height() - height) * 0.5f;
+	bounding_box.length = width;
+	bounding_box.height = height;
 
 	return bounding_box;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
-#include <Engine\Sprite.h>
+#include <string>
+#include <Engine/Sprite.h>
 #include "Rect.h"
 /**
 *  Sprite Components are used by GameObjects
@@ -27,7 +28,7 @@ public:
 	*  Allocates and loads the sprite.
 	*  Part of this process will attempt to load a texture file.
 	*  If this fails this function will return false and the memory
-	*  allocated, freed.
+	*  allocated, freed, leaving any sprite already loaded in place.
 	*  @param [in] renderer The renderer used to perform the allocations
 	*  @param [in] texture_file_name The file path to the the texture to load
 	*  @return true if the sprite was successfully loaded
@@ -45,7 +46,8 @@ public:
 	/**
 	*  Grabs a bounding box for the sprite.
 	*  Will create a bounding box as a rectangle. This can be used to check
-	*  for collisions with other rects.
+	*  for collisions with other rects. Rotated sprites are bounded around
+	*  their centre, which they rotate about.
 	*  @return a rectangle represent the sprite's position and bounds.
 	*/
 	rect  getBoundingBox() const;
@@ -54,4 +56,5 @@ public:
 private:
 	void freeSprite();
 	ASGE::Sprite* sprite = nullptr;
+	std::string loaded_file_name;
 };
\ No newline at end of file
@@ -0,0 +1,406 @@
+#include <float.h>
+#include <math.h>
+#include "Sweep.h"
+
+namespace
+{
+	const float EPSILON = 1e-6f;
+
+	/**
+	*   @brief   Casts a ray against a circle.
+	*   @details Solves the quadratic for the ray's parametric distance.
+	*   @return  True if the ray enters the circle between 0 and 1.
+	*/
+	bool rayCircle(const vector2& origin, const vector2& dir,
+		const vector2& centre, float radius, float& time)
+	{
+		float mx = origin.x - centre.x;
+		float my = origin.y - centre.y;
+
+		float a = dir.x * dir.x + dir.y * dir.y;
+		float b = mx * dir.x + my * dir.y;
+		float c = mx * mx + my * my - radius * radius;
+
+		if (a < EPSILON)
+		{
+			return false;
+		}
+
+		float discriminant = b * b - a * c;
+		if (discriminant < 0.0f)
+		{
+			return false;
+		}
+
+		float t = (-b - sqrtf(discriminant)) / a;
+		if (t < 0.0f || t > 1.0f)
+		{
+			return false;
+		}
+
+		time = t;
+		return true;
+	}
+}
+
+/**
+*   @brief   Area covered along a motion.
+*   @details Grows the rectangle in the direction of travel.
+*   @return  The combined start and end area.
+*/
+rect sweptBounds(const rect& box, const vector2& motion)
+{
+	rect swept = box;
+	if (motion.x < 0)
+	{
+		swept.x += motion.x;
+	}
+	if (motion.y < 0)
+	{
+		swept.y += motion.y;
+	}
+
+	swept.length += fabsf(motion.x);
+	swept.height += fabsf(motion.y);
+	return swept;
+}
+
+/**
+*   @brief   Swept rectangle against rectangle.
+*   @details The target is grown by the moving rectangle's size, which
+             reduces the problem to casting the moving rectangle's top
+			 left corner through the grown area using the slab method.
+*   @return  True if they touch during the motion.
+*/
+bool sweepRect(const rect& moving, const vector2& motion,
+	const rect& target, sweep_hit& result)
+{
+	const float min[2] = { target.x - moving.length, target.y - moving.height };
+	const float max[2] = { target.x + target.length, target.y + target.height };
+	const float origin[2] = { moving.x, moving.y };
+	const float dir[2] = { motion.x, motion.y };
+
+	// already overlapping, push out along the shallowest axis
+	if (origin[0] > min[0] && origin[0] < max[0] &&
+		origin[1] > min[1] && origin[1] < max[1])
+	{
+		float depth[4] = {
+			origin[0] - min[0], max[0] - origin[0],
+			origin[1] - min[1], max[1] - origin[1] };
+
+		int shallowest = 0;
+		for (int i = 1; i < 4; i++)
+		{
+			if (depth[i] < depth[shallowest])
+			{
+				shallowest = i;
+			}
+		}
+
+		result.time = 0.0f;
+		result.normal.x = shallowest == 0 ? -1.0f : shallowest == 1 ? 1.0f : 0.0f;
+		result.normal.y = shallowest == 2 ? -1.0f : shallowest == 3 ? 1.0f : 0.0f;
+		return true;
+	}
+
+	float t_entry = -FLT_MAX;
+	float t_exit = FLT_MAX;
+	int entry_axis = -1;
+	float entry_sign = 0.0f;
+
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (fabsf(dir[axis]) < EPSILON)
+		{
+			if (origin[axis] <= min[axis] || origin[axis] >= max[axis])
+			{
+				return false;
+			}
+			continue;
+		}
+
+		// moving forwards enters through the min face, backwards the max
+		float inv_dir = 1.0f / dir[axis];
+		float t1 = (min[axis] - origin[axis]) * inv_dir;
+		float t2 = (max[axis] - origin[axis]) * inv_dir;
+		float sign = -1.0f;
+		if (t1 > t2)
+		{
+			float swap = t1;
+			t1 = t2;
+			t2 = swap;
+			sign = 1.0f;
+		}
+
+		if (t1 > t_entry)
+		{
+			t_entry = t1;
+			entry_axis = axis;
+			entry_sign = sign;
+		}
+
+		t_exit = t2 < t_exit ? t2 : t_exit;
+	}
+
+	if (entry_axis == -1 || t_entry > t_exit ||
+		t_entry < 0.0f || t_entry > 1.0f)
+	{
+		return false;
+	}
+
+	result.time = t_entry;
+	result.normal.x = entry_axis == 0 ? entry_sign : 0.0f;
+	result.normal.y = entry_axis == 1 ? entry_sign : 0.0f;
+	return true;
+}
+
+/**
+*   @brief   Swept circle against rectangle.
+*   @details The centre is cast against the rectangle grown by the
+             radius. Entering through one of the grown rectangle's
+			 corners only counts if the centre also passes within a
+			 radius of the original corner.
+*   @return  True if they touch during the motion.
+*/
+bool sweepCircleRect(const vector2& centre, float radius, const vector2& motion,
+	const rect& target, sweep_hit& result)
+{
+	float right = target.x + target.length;
+	float bottom = target.y + target.height;
+
+	// already overlapping, push out from the closest point
+	float closest_x = centre.x < target.x ? target.x : centre.x > right ? right : centre.x;
+	float closest_y = centre.y < target.y ? target.y : centre.y > bottom ? bottom : centre.y;
+	float dx = centre.x - closest_x;
+	float dy = centre.y - closest_y;
+	float distance_sq = dx * dx + dy * dy;
+
+	if (distance_sq < radius * radius)
+	{
+		result.time = 0.0f;
+		if (distance_sq > EPSILON)
+		{
+			float distance = sqrtf(distance_sq);
+			result.normal.x = dx / distance;
+			result.normal.y = dy / distance;
+		}
+		else
+		{
+			rect point;
+			point.x = centre.x;
+			point.y = centre.y;
+			sweep_hit inside;
+			sweepRect(point, vector2(0, 0), target, inside);
+			result.normal = inside.normal;
+		}
+		return true;
+	}
+
+	rect grown;
+	grown.x = target.x - radius;
+	grown.y = target.y - radius;
+	grown.length = target.length + 2.0f * radius;
+	grown.height = target.height + 2.0f * radius;
+
+	rect point;
+	point.x = centre.x;
+	point.y = centre.y;
+
+	sweep_hit face;
+	if (!sweepRect(point, motion, grown, face))
+	{
+		return false;
+	}
+
+	float hit_x = centre.x + motion.x * face.time;
+	float hit_y = centre.y + motion.y * face.time;
+
+	bool outside_x = hit_x < target.x || hit_x > right;
+	bool outside_y = hit_y < target.y || hit_y > bottom;
+	if (!outside_x || !outside_y)
+	{
+		result = face;
+		return true;
+	}
+
+	vector2 corner(hit_x < target.x ? target.x : right,
+		hit_y < target.y ? target.y : bottom);
+
+	float time = 0.0f;
+	if (!rayCircle(centre, motion, corner, radius, time))
+	{
+		return false;
+	}
+
+	result.time = time;
+	result.normal.x = (centre.x + motion.x * time - corner.x) / radius;
+	result.normal.y = (centre.y + motion.y * time - corner.y) / radius;
+	return true;
+}
+
+/**
+*   @brief   Swept circle against circle.
+*   @details Equivalent to casting the moving centre against a circle
+             with the combined radius.
+*   @return  True if they touch during the motion.
+*/
+bool sweepCircleCircle(const vector2& centre, float radius, const vector2& motion,
+	const vector2& target_centre, float target_radius, sweep_hit& result)
+{
+	float combined = radius + target_radius;
+	float dx = centre.x - target_centre.x;
+	float dy = centre.y - target_centre.y;
+	float distance_sq = dx * dx + dy * dy;
+
+	if (distance_sq < combined * combined)
+	{
+		float distance = sqrtf(distance_sq);
+		result.time = 0.0f;
+		result.normal.x = distance > EPSILON ? dx / distance : 0.0f;
+		result.normal.y = distance > EPSILON ? dy / distance : -1.0f;
+		return true;
+	}
+
+	float time = 0.0f;
+	if (!rayCircle(centre, motion, target_centre, combined, time))
+	{
+		return false;
+	}
+
+	result.time = time;
+	result.normal.x = (centre.x + motion.x * time - target_centre.x) / combined;
+	result.normal.y = (centre.y + motion.y * time - target_centre.y) / combined;
+	return true;
+}
+
+/**
+*   @brief   Swept circle against convex polygon.
+*   @details The centre is cast against the polygon grown by the
+             radius, whose edge is each face pushed out along its
+			 normal with a circle round each vertex. A face only
+			 counts if the centre meets it facing the face, and the
+			 first crossing of any of these is the first contact.
+*   @return  True if they touch during the motion.
+*/
+bool sweepCirclePolygon(const vector2& centre, float radius, const vector2& motion,
+	const polygon& target, sweep_hit& result)
+{
+	const int count = target.count;
+	if (count < 1)
+	{
+		return false;
+	}
+
+	// already overlapping, push out from the closest point
+	bool inside = true;
+	int shallowest = 0;
+	float shallowest_separation = -FLT_MAX;
+	float closest_sq = FLT_MAX;
+	vector2 closest;
+	for (int i = 0; i < count; i++)
+	{
+		const vector2& from = target.vertices[i];
+		const vector2& to = target.vertices[(i + 1) % count];
+		const vector2& normal = target.normals[i];
+
+		float separation = normal.x * (centre.x - from.x) + normal.y * (centre.y - from.y);
+		if (separation > 0.0f)
+		{
+			inside = false;
+		}
+		if (separation > shallowest_separation)
+		{
+			shallowest_separation = separation;
+			shallowest = i;
+		}
+
+		float edge_x = to.x - from.x;
+		float edge_y = to.y - from.y;
+		float length_sq = edge_x * edge_x + edge_y * edge_y;
+		float along = length_sq > EPSILON ?
+			((centre.x - from.x) * edge_x + (centre.y - from.y) * edge_y) / length_sq : 0.0f;
+		along = along < 0.0f ? 0.0f : along > 1.0f ? 1.0f : along;
+
+		float dx = centre.x - (from.x + edge_x * along);
+		float dy = centre.y - (from.y + edge_y * along);
+		if (dx * dx + dy * dy < closest_sq)
+		{
+			closest_sq = dx * dx + dy * dy;
+			closest = vector2(from.x + edge_x * along, from.y + edge_y * along);
+		}
+	}
+
+	if (inside || closest_sq < radius * radius)
+	{
+		result.time = 0.0f;
+		if (!inside && closest_sq > EPSILON)
+		{
+			float distance = sqrtf(closest_sq);
+			result.normal.x = (centre.x - closest.x) / distance;
+			result.normal.y = (centre.y - closest.y) / distance;
+		}
+		else
+		{
+			result.normal = target.normals[shallowest];
+		}
+		return true;
+	}
+
+	float earliest = FLT_MAX;
+	vector2 earliest_normal;
+	for (int i = 0; i < count; i++)
+	{
+		const vector2& from = target.vertices[i];
+		const vector2& to = target.vertices[(i + 1) % count];
+		const vector2& normal = target.normals[i];
+
+		// faces moved away from or along can't be entered through
+		float approach = normal.x * motion.x + normal.y * motion.y;
+		if (approach > -EPSILON)
+		{
+			continue;
+		}
+
+		float separation = normal.x * (centre.x - from.x) + normal.y * (centre.y - from.y);
+		float time = (radius - separation) / approach;
+		if (time < 0.0f || time > 1.0f || time >= earliest)
+		{
+			continue;
+		}
+
+		// where the circle touches the face's line, which must be on the face
+		float touch_x = centre.x + motion.x * time - normal.x * radius - from.x;
+		float touch_y = centre.y + motion.y * time - normal.y * radius - from.y;
+		float edge_x = to.x - from.x;
+		float edge_y = to.y - from.y;
+		float along = touch_x * edge_x + touch_y * edge_y;
+		if (along < 0.0f || along > edge_x * edge_x + edge_y * edge_y)
+		{
+			continue;
+		}
+
+		earliest = time;
+		earliest_normal = normal;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		const vector2& vertex = target.vertices[i];
+		float time = 0.0f;
+		if (rayCircle(centre, motion, vertex, radius, time) && time < earliest)
+		{
+			earliest = time;
+			earliest_normal.x = (centre.x + motion.x * time - vertex.x) / radius;
+			earliest_normal.y = (centre.y + motion.y * time - vertex.y) / radius;
+		}
+	}
+
+	if (earliest > 1.0f)
+	{
+		return false;
+	}
+
+	result.time = earliest;
+	result.normal = earliest_normal;
+	return true;
+}
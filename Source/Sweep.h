@@ -0,0 +1,78 @@
+#pragma once
+#include "Narrowphase.h"
+#include "Rect.h"
+#include "Vector2.h"
+
+/**
+*  The result of a swept collision test.
+*  Describes the first point of contact along a motion segment.
+*/
+struct sweep_hit
+{
+	float   time = 1.0f;        /**< Fraction of the motion travelled before contact. */
+	vector2 normal = { 0, 0 };  /**< Surface normal of the target at the contact. */
+};
+
+/**
+*  Grabs the area covered by a rectangle along its motion.
+*  Useful for querying a broadphase before running swept tests.
+*  @param [in] box The rectangle at the start of the motion
+*  @param [in] motion The displacement over the step
+*  @return a rectangle containing both the start and end positions
+*/
+rect sweptBounds(const rect& box, const vector2& motion);
+
+/**
+*  Finds when a moving rectangle first touches a static one.
+*  Rectangles that already overlap report a time of zero, with the
+*  normal pointing along the axis of least penetration.
+*  @param [in] moving The moving rectangle at the start of the motion
+*  @param [in] motion The displacement over the step
+*  @param [in] target The rectangle being tested against
+*  @param [out] result The time of impact and contact normal
+*  @return true if contact happens during the motion
+*/
+bool sweepRect(const rect& moving, const vector2& motion,
+	const rect& target, sweep_hit& result);
+
+/**
+*  Finds when a moving circle first touches a static rectangle.
+*  The test is performed by casting the circle's centre against the
+*  rectangle grown by the radius, with rounded corners.
+*  @param [in] centre The circle's centre at the start of the motion
+*  @param [in] radius The circle's radius
+*  @param [in] motion The displacement over the step
+*  @param [in] target The rectangle being tested against
+*  @param [out] result The time of impact and contact normal
+*  @return true if contact happens during the motion
+*/
+bool sweepCircleRect(const vector2& centre, float radius, const vector2& motion,
+	const rect& target, sweep_hit& result);
+
+/**
+*  Finds when a moving circle first touches a static circle.
+*  @param [in] centre The moving circle's centre at the start of the motion
+*  @param [in] radius The moving circle's radius
+*  @param [in] motion The displacement over the step
+*  @param [in] target_centre The static circle's centre
+*  @param [in] target_radius The static circle's radius
+*  @param [out] result The time of impact and contact normal
+*  @return true if contact happens during the motion
+*/
+bool sweepCircleCircle(const vector2& centre, float radius, const vector2& motion,
+	const vector2& target_centre, float target_radius, sweep_hit& result);
+
+/**
+*  Finds when a moving circle first touches a static convex polygon.
+*  Unlike sweepCircleRect, the polygon can be rotated, so the circle
+*  only stops where the shape really is rather than at its bounds.
+*  Circles that already overlap report a time of zero.
+*  @param [in] centre The circle's centre at the start of the motion
+*  @param [in] radius The circle's radius
+*  @param [in] motion The displacement over the step
+*  @param [in] target The polygon being tested against, in world space
+*  @param [out] result The time of impact and contact normal
+*  @return true if contact happens during the motion
+*/
+bool sweepCirclePolygon(const vector2& centre, float radius, const vector2& motion,
+	const polygon& target, sweep_hit& result);
@@ -0,0 +1,382 @@
+#include <string.h>
+#include <Engine/Sprite.h>
+#include "FileSystem.h"
+#include "TextureAtlas.h"
+
+namespace
+{
+	const int MAX_ATTRIBUTES = 16;
+
+	/**
+	*  A run of characters inside the mapped file.
+	*/
+	struct text_span
+	{
+		const char* data = nullptr;
+		int length = 0;
+
+		bool equals(const char* text) const
+		{
+			return static_cast<int>(strlen(text)) == length && memcmp(data, text, length) == 0;
+		}
+	};
+
+	struct xml_attribute
+	{
+		text_span name;
+		text_span value;
+	};
+
+	bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	}
+
+	/**
+	*   @brief   Skips past the next occurrence of some text.
+	*   @return  The character after it, or the end if it isn't found.
+	*/
+	const char* skipPast(const char* cursor, const char* end, const char* text)
+	{
+		const int length = static_cast<int>(strlen(text));
+		for (; cursor + length <= end; cursor++)
+		{
+			if (memcmp(cursor, text, length) == 0)
+			{
+				return cursor + length;
+			}
+		}
+		return end;
+	}
+
+	/**
+	*   @brief   Calls a function for each opening tag in a document.
+	*   @details Declarations, comments and closing tags are skipped.
+	             Attribute values are handed over as they appear in the
+				 file, so character references are not decoded. Only the
+				 first few attributes of an element are kept.
+	*   @return  False if the document ends part way through a tag.
+	*/
+	template<typename ElementFnc>
+	bool scanElements(const char* cursor, const char* end, ElementFnc element)
+	{
+		xml_attribute attributes[MAX_ATTRIBUTES];
+
+		while (cursor < end)
+		{
+			cursor = static_cast<const char*>(memchr(cursor, '<', end - cursor));
+			if (!cursor)
+			{
+				return true;
+			}
+
+			cursor++;
+			if (cursor < end && (*cursor == '?' || *cursor == '/'))
+			{
+				cursor = skipPast(cursor, end, ">");
+				continue;
+			}
+			if (end - cursor >= 3 && memcmp(cursor, "!--", 3) == 0)
+			{
+				cursor = skipPast(cursor, end, "-->");
+				continue;
+			}
+
+			text_span tag;
+			tag.data = cursor;
+			while (cursor < end && !isSpace(*cursor) && *cursor != '/' && *cursor != '>')
+			{
+				cursor++;
+			}
+			tag.length = static_cast<int>(cursor - tag.data);
+
+			int count = 0;
+			for (;;)
+			{
+				while (cursor < end && isSpace(*cursor))
+				{
+					cursor++;
+				}
+				if (cursor >= end)
+				{
+					return false;
+				}
+				if (*cursor == '/' || *cursor == '>')
+				{
+					cursor = skipPast(cursor, end, ">");
+					break;
+				}
+
+				xml_attribute attribute;
+				attribute.name.data = cursor;
+				while (cursor < end && *cursor != '=' && !isSpace(*cursor))
+				{
+					cursor++;
+				}
+				attribute.name.length = static_cast<int>(cursor - attribute.name.data);
+
+				cursor = static_cast<const char*>(memchr(cursor, '=', end - cursor));
+				if (!cursor)
+				{
+					return false;
+				}
+				cursor++;
+				while (cursor < end && isSpace(*cursor))
+				{
+					cursor++;
+				}
+				if (cursor >= end || (*cursor != '"' && *cursor != '\''))
+				{
+					return false;
+				}
+
+				const char quote = *cursor++;
+				attribute.value.data = cursor;
+				cursor = static_cast<const char*>(memchr(cursor, quote, end - cursor));
+				if (!cursor)
+				{
+					return false;
+				}
+				attribute.value.length = static_cast<int>(cursor - attribute.value.data);
+				cursor++;
+
+				if (count < MAX_ATTRIBUTES)
+				{
+					attributes[count++] = attribute;
+				}
+			}
+
+			element(tag, attributes, count);
+		}
+
+		return true;
+	}
+
+	float toNumber(const text_span& text)
+	{
+		float value = 0.0f;
+		bool negative = false;
+		int i = 0;
+
+		if (i < text.length && text.data[i] == '-')
+		{
+			negative = true;
+			i++;
+		}
+		for (; i < text.length && text.data[i] >= '0' && text.data[i] <= '9'; i++)
+		{
+			value = value * 10.0f + (text.data[i] - '0');
+		}
+
+		return negative ? -value : value;
+	}
+}
+
+/**
+*   @brief   Loads an atlas description.
+*   @details Maps the file, or finds it in a pack, and scans it once,
+             keeping a region for every SubTexture and the image named
+			 by the TextureAtlas element. The region names stay in the
+			 mapped file.
+*   @return  True if any regions were found.
+*/
+bool TextureAtlas::load(const std::string& xml_path, const FileSystem& files)
+{
+	regions.clear();
+	table.clear();
+	image_path.clear();
+
+	file.loose.close();
+	file.unpacked.clear();
+
+	file_view view;
+	if (!files.read(xml_path, file, view) || !view.data)
+	{
+		return false;
+	}
+
+	std::string image_name;
+	bool complete = scanElements(view.data, view.data + view.size,
+		[this, &image_name](const text_span& tag, const xml_attribute* attributes, int count)
+	{
+		if (tag.equals("TextureAtlas"))
+		{
+			for (int i = 0; i < count; i++)
+			{
+				if (attributes[i].name.equals("imagePath"))
+				{
+					image_name.assign(attributes[i].value.data, attributes[i].value.length);
+				}
+			}
+			return;
+		}
+
+		if (!tag.equals("SubTexture"))
+		{
+			return;
+		}
+
+		sub_texture region;
+		for (int i = 0; i < count; i++)
+		{
+			const text_span& name = attributes[i].name;
+			const text_span& value = attributes[i].value;
+			if (name.equals("name"))
+			{
+				region.name = value.data;
+				region.name_length = value.length;
+			}
+			else if (name.equals("x"))
+			{
+				region.x = toNumber(value);
+			}
+			else if (name.equals("y"))
+			{
+				region.y = toNumber(value);
+			}
+			else if (name.equals("width"))
+			{
+				region.width = toNumber(value);
+			}
+			else if (name.equals("height"))
+			{
+				region.height = toNumber(value);
+			}
+		}
+
+		if (region.name)
+		{
+			regions.push_back(region);
+		}
+	});
+
+	if (!complete || regions.empty())
+	{
+		regions.clear();
+		file.loose.close();
+		file.unpacked.clear();
+		return false;
+	}
+
+	size_t folder_end = xml_path.find_last_of("/\\");
+	std::string folder = folder_end == std::string::npos ? "" : xml_path.substr(0, folder_end + 1);
+	image_path = folder + image_name;
+	if (image_name.empty() || !files.exists(image_path))
+	{
+		image_path = xml_path.substr(0, xml_path.find_last_of('.')) + ".png";
+	}
+
+	buildTable();
+	return true;
+}
+
+/**
+*   @brief   Finds a region by name.
+*   @details Probes linearly from the name's hash until the region or
+             an empty slot is found.
+*   @return  The region, or null.
+*/
+const sub_texture* TextureAtlas::find(const std::string& name) const
+{
+	if (table.empty())
+	{
+		return nullptr;
+	}
+
+	const int length = static_cast<int>(name.size());
+	const uint32_t mask = static_cast<uint32_t>(table.size()) - 1;
+	for (uint32_t slot = hashName(name.data(), length) & mask; table[slot] != 0; slot = (slot + 1) & mask)
+	{
+		const sub_texture& region = regions[table[slot] - 1];
+		if (region.name_length == length && memcmp(region.name, name.data(), length) == 0)
+		{
+			return &region;
+		}
+	}
+
+	return nullptr;
+}
+
+bool TextureAtlas::apply(const std::string& name, ASGE::Sprite& sprite, int level) const
+{
+	const sub_texture* region = find(name);
+	if (!region)
+	{
+		return false;
+	}
+
+	const float scale = 1.0f / static_cast<float>(1 << level);
+	float* src = sprite.srcRect();
+	src[0] = region->x * scale;
+	src[1] = region->y * scale;
+	src[2] = region->width * scale;
+	src[3] = region->height * scale;
+	return true;
+}
+
+const std::string& TextureAtlas::imagePath() const
+{
+	return image_path;
+}
+
+int TextureAtlas::size() const
+{
+	return static_cast<int>(regions.size());
+}
+
+/**
+*   @brief   Hashes a region name.
+*   @details FNV-1a, which is quick for short strings and spreads the
+             numbered names Kenney uses well enough.
+*   @return  The hash.
+*/
+uint32_t TextureAtlas::hashName(const char* name, int length)
+{
+	uint32_t hash = 2166136261u;
+	for (int i = 0; i < length; i++)
+	{
+		hash ^= static_cast<uint8_t>(name[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+*   @brief   Builds the name lookup table.
+*   @details The table is a power of two at least twice the number of
+             regions, so probes stay short. A repeated name keeps the
+			 first region given for it.
+*   @return  void
+*/
+void TextureAtlas::buildTable()
+{
+	size_t slots = 16;
+	while (slots < regions.size() * 2)
+	{
+		slots *= 2;
+	}
+	table.assign(slots, 0);
+
+	const uint32_t mask = static_cast<uint32_t>(slots) - 1;
+	for (int i = 0; i < static_cast<int>(regions.size()); i++)
+	{
+		const sub_texture& region = regions[i];
+		uint32_t slot = hashName(region.name, region.name_length) & mask;
+		bool repeated = false;
+		for (; table[slot] != 0; slot = (slot + 1) & mask)
+		{
+			const sub_texture& other = regions[table[slot] - 1];
+			if (other.name_length == region.name_length &&
+				memcmp(other.name, region.name, region.name_length) == 0)
+			{
+				repeated = true;
+				break;
+			}
+		}
+
+		if (!repeated)
+		{
+			table[slot] = i + 1;
+		}
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "FileSystem.h"
+
+namespace ASGE
+{
+	class Sprite;
+}
+
+/**
+*  A named region of an atlas texture.
+*  The name points into the atlas's mapped file and is not terminated.
+*/
+struct sub_texture
+{
+	const char* name = nullptr;
+	int   name_length = 0;
+	float x = 0.0f;
+	float y = 0.0f;
+	float width = 0.0f;
+	float height = 0.0f;
+};
+
+/**
+*  A sprite sheet described by a TextureAtlas XML file.
+*  This is the format the Kenney packs ship their sheets in, one
+*  SubTexture element per image. The file is mapped rather than read
+*  and scanned once, element by element, without building a document
+*  or copying any names. Regions are then found through a hash table.
+*  Sprites showing regions of the same atlas share its texture, so
+*  drawing a level built from one sheet only ever binds one texture.
+*/
+class TextureAtlas
+{
+public:
+
+	/**
+	*  Default constructor.
+	*/
+	TextureAtlas() = default;
+
+	/**
+	*  Loads an atlas description.
+	*  The image is looked for beside the XML under the name it gives.
+	*  Some sheets give a name that was never shipped, in which case the
+	*  image with the same name as the XML file is used instead.
+	*  @param [in] xml_path The path to the XML file
+	*  @param [in] files Where to read the file from. The atlas points
+	*  into packed files, so their pack must stay mounted.
+	*  @return true if the file was read and described at least one region
+	*/
+	bool load(const std::string& xml_path, const FileSystem& files);
+
+	/**
+	*  Finds a region by name.
+	*  @param [in] name The region's name, as given in the XML
+	*  @return the region, or null if there is none by that name
+	*/
+	const sub_texture* find(const std::string& name) const;
+
+	/**
+	*  Points a sprite at a region.
+	*  The sprite must already show the atlas's image, or the variant of
+	*  it at the given mip level, which scales the region to match.
+	*  @param [in] name The region's name
+	*  @param [in] sprite The sprite to update
+	*  @param [in] level The mip level of the image the sprite shows
+	*  @return true if the region was found
+	*/
+	bool apply(const std::string& name, ASGE::Sprite& sprite, int level = 0) const;
+
+	/**
+	*  Returns the path to the atlas's image.
+	*  @return the path, relative to the same folder as the XML's
+	*/
+	const std::string& imagePath() const;
+
+	/**
+	*  Returns the number of regions.
+	*  @return the region count
+	*/
+	int  size() const;
+
+private:
+	static uint32_t hashName(const char* name, int length);
+
+	void buildTable();
+
+	file_buffer file;   // the XML, if it isn't viewed in a pack
+	std::string image_path;
+	std::vector<sub_texture> regions;
+	std::vector<int> table;   // region index + 1, zero for empty slots
+};
@@ -0,0 +1,87 @@
+#include <Engine/Renderer.h>
+#include <Engine/Sprite.h>
+#include "Path.h"
+#include "TextureCache.h"
+
+TextureCache::~TextureCache() = default;
+
+std::string TextureCache::normalise(const std::string& path)
+{
+	return normalisePath(path);
+}
+
+/**
+*   @brief   Takes a reference to a texture.
+*   @details A texture not yet cached is loaded into a holder sprite,
+             which keeps it alive. The holder of a forgotten texture is
+			 reused for the next one.
+*   @return  A handle to the texture, empty on failure.
+*/
+handle TextureCache::acquire(ASGE::Renderer* renderer, const std::string& path)
+{
+	std::string key = normalise(path);
+	auto found = lookup.find(key);
+	if (found != lookup.end())
+	{
+		texture_entry& entry = *entries.get(found->second);
+		entry.references++;
+		return found->second;
+	}
+
+	handle texture = entries.acquire();
+	texture_entry& entry = *entries.get(texture);
+	if (!entry.holder)
+	{
+		entry.holder.reset(renderer->createRawSprite());
+	}
+
+	if (!entry.holder->loadTexture(key) || !entry.holder->getTexture())
+	{
+		entries.release(texture);
+		return handle();
+	}
+
+	entry.path = key;
+	entry.texture = entry.holder->getTexture();
+	entry.references = 1;
+
+	lookup[key] = texture;
+	return texture;
+}
+
+void TextureCache::release(handle texture)
+{
+	texture_entry* entry = entries.get(texture);
+	if (!entry || entry->references == 0)
+	{
+		return;
+	}
+
+	entry->references--;
+}
+
+const std::string& TextureCache::path(handle texture) const
+{
+	static const std::string none;
+	const texture_entry* entry = entries.get(texture);
+	return entry ? entry->path : none;
+}
+
+int TextureCache::references(handle texture) const
+{
+	const texture_entry* entry = entries.get(texture);
+	return entry ? entry->references : 0;
+}
+
+void TextureCache::clear()
+{
+	for (const auto& cached : lookup)
+	{
+		texture_entry& entry = *entries.get(cached.second);
+		entry.path.clear();
+		entry.texture = nullptr;
+		entry.references = 0;
+		entries.release(cached.second);
+	}
+	lookup.clear();
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include "Pool.h"
+
+namespace ASGE
+{
+	class Renderer;
+	class Sprite;
+	class Texture2D;
+}
+
+/**
+*  Shares textures between every sprite drawing the same file.
+*  The engine only recognises a texture it has already loaded when the
+*  path is spelt exactly the same, so paths are normalised before
+*  anything is loaded. Each texture is counted in and out by the
+*  sprites using it. Textures nothing uses are kept for the next level:
+*  the engine has no way to unload a texture, so dropping one from the
+*  cache would free nothing and only cost a lookup when it's next used.
+*/
+class TextureCache
+{
+public:
+
+	/**
+	*  Default constructor.
+	*/
+	TextureCache() = default;
+
+	/**
+	*  Destructor. Frees the sprites holding the textures.
+	*/
+	~TextureCache();
+
+	/**
+	*  Turns a path into the form used as the cache's key.
+	*  Separators become forward slashes, "." and empty parts are
+	*  removed, ".." steps back a folder and the path is lowercased,
+	*  as the game's files are on a case insensitive file system.
+	*  A path starting with a separator keeps one.
+	*  @param [in] path The path to normalise
+	*  @return the normalised path
+	*/
+	static std::string normalise(const std::string& path);
+
+	/**
+	*  Takes a reference to a texture, loading it if needed.
+	*  @param [in] renderer The renderer used to load the texture
+	*  @param [in] path The path to the texture file
+	*  @return a handle to the texture, or an empty handle if it couldn't
+	*  be loaded
+	*/
+	handle acquire(ASGE::Renderer* renderer, const std::string& path);
+
+	/**
+	*  Gives up a reference to a texture.
+	*  @param [in] texture The handle returned by acquire
+	*/
+	void release(handle texture);
+
+	/**
+	*  Returns the normalised path of a texture.
+	*  Sprites loading this path share the cached texture rather than
+	*  decoding the file again.
+	*  @param [in] texture The handle returned by acquire
+	*  @return the path, or an empty string for stale handles
+	*/
+	const std::string& path(handle texture) const;
+
+	/**
+	*  Returns the number of references held to a texture.
+	*  @param [in] texture The handle returned by acquire
+	*  @return the reference count, or zero for stale handles
+	*/
+	int  references(handle texture) const;
+
+	/**
+	*  Forgets every texture, whether in use or not. The engine keeps
+	*  them loaded, so a path acquired again shares its texture still.
+	*/
+	void clear();
+
+private:
+	struct texture_entry
+	{
+		std::string path;
+		std::unique_ptr<ASGE::Sprite> holder;   // keeps the texture loaded
+		const ASGE::Texture2D* texture = nullptr;
+		int references = 0;
+	};
+
+	Pool<texture_entry, 32> entries;
+	std::map<std::string, handle> lookup;
+};
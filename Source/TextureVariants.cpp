@@ -0,0 +1,82 @@
+#include <math.h>
+#include "FileSystem.h"
+#include "Png.h"
+#include "TextureAtlas.h"
+#include "TextureVariants.h"
+
+std::string TextureVariants::path(const std::string& texture_path, int level)
+{
+	if (level <= 0)
+	{
+		return texture_path;
+	}
+
+	size_t dot = texture_path.find_last_of('.');
+	size_t separator = texture_path.find_last_of("/\\");
+	if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+	{
+		dot = texture_path.size();
+	}
+
+	return texture_path.substr(0, dot) + ".mip" + std::to_string(level) + texture_path.substr(dot);
+}
+
+/**
+*   @brief   Picks the variant for a sprite showing a whole texture.
+*   @details Levels are tried from the largest down, stopping at the
+             first missing or too small for the sprite.
+*   @return  The level to load.
+*/
+int TextureVariants::level(const FileSystem& files, const std::string& texture_path,
+	float draw_width, float draw_height)
+{
+	int picked = 0;
+	for (int level = 1; level <= MAX_LEVEL; level++)
+	{
+		const texture_size& variant = size(files, path(texture_path, level));
+		if (variant.width < draw_width || variant.height < draw_height || variant.width == 0)
+		{
+			break;
+		}
+		picked = level;
+	}
+	return picked;
+}
+
+int TextureVariants::level(const FileSystem& files, const std::string& texture_path, const sub_texture& region,
+	float draw_width, float draw_height)
+{
+	int picked = 0;
+	for (int level = 1; level <= MAX_LEVEL; level++)
+	{
+		const float scale = static_cast<float>(1 << level);
+		const bool aligned = fmodf(region.x, scale) == 0.0f && fmodf(region.y, scale) == 0.0f &&
+			fmodf(region.width, scale) == 0.0f && fmodf(region.height, scale) == 0.0f;
+		if (!aligned || region.width / scale < draw_width || region.height / scale < draw_height ||
+			size(files, path(texture_path, level)).width == 0)
+		{
+			break;
+		}
+		picked = level;
+	}
+	return picked;
+}
+
+const TextureVariants::texture_size& TextureVariants::size(const FileSystem& files, const std::string& texture_path)
+{
+	auto found = sizes.find(texture_path);
+	if (found != sizes.end())
+	{
+		return found->second;
+	}
+
+	texture_size read;
+	file_buffer buffer;
+	file_view view;
+	if (!files.read(texture_path, buffer, view) || !view.data ||
+		!readPngSize(reinterpret_cast<const uint8_t*>(view.data), view.size, read.width, read.height))
+	{
+		read = texture_size();
+	}
+	return sizes.emplace(texture_path, read).first->second;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <map>
+#include <string>
+
+class FileSystem;
+struct sub_texture;
+
+/**
+*  Picks the smallest pre-scaled copy of a texture that still covers the
+*  size it's drawn at.
+*  The MipBuilder tool writes each PNG's mip chain beside it, each level
+*  half the size of the last: "rock.mip1.png" at half size,
+*  "rock.mip2.png" at a quarter and so on. A sprite drawn well below
+*  its texture's size loads one of these instead, taking a fraction of
+*  the memory and upload time and sampling with less aliasing. Textures
+*  without variants use their own file. Sizes are read from the PNG
+*  headers and remembered, so call from one thread.
+*/
+class TextureVariants
+{
+public:
+
+	static const int MAX_LEVEL = 12;
+
+	/**
+	*  Returns the path of a texture's variant.
+	*  @param [in] texture_path The full size texture's path
+	*  @param [in] level The mip level, zero for the texture itself
+	*  @return the variant's path
+	*/
+	static std::string path(const std::string& texture_path, int level);
+
+	/**
+	*  Picks the variant for a sprite showing a whole texture.
+	*  @param [in] files Where the textures are read from
+	*  @param [in] texture_path The full size texture's path
+	*  @param [in] draw_width The width the sprite is drawn at
+	*  @param [in] draw_height The height the sprite is drawn at
+	*  @return the smallest level at least the drawn size
+	*/
+	int  level(const FileSystem& files, const std::string& texture_path, float draw_width, float draw_height);
+
+	/**
+	*  Picks the variant for a sprite showing one region of an atlas.
+	*  A level is only used if the region lies on its pixel grid, so no
+	*  neighbouring region was averaged into its edges.
+	*  @param [in] files Where the textures are read from
+	*  @param [in] texture_path The full size atlas image's path
+	*  @param [in] region The region the sprite shows, in full size pixels
+	*  @param [in] draw_width The width the sprite is drawn at
+	*  @param [in] draw_height The height the sprite is drawn at
+	*  @return the smallest level at least the drawn size
+	*/
+	int  level(const FileSystem& files, const std::string& texture_path, const sub_texture& region,
+		float draw_width, float draw_height);
+
+private:
+	struct texture_size
+	{
+		int width = 0;
+		int height = 0;
+	};
+
+	const texture_size& size(const FileSystem& files, const std::string& texture_path);
+
+	std::map<std::string, texture_size> sizes;   /**< Zero for files that couldn't be read. */
+};
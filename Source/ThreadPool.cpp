@@ -0,0 +1,207 @@
+#include "ThreadPool.h"
+
+/**
+*   @brief   Constructor.
+*   @details Creates the workers, each with a queue, waiting for a
+             batch.
+*   @return  void
+*/
+ThreadPool::ThreadPool(int workers)
+{
+	if (workers <= 0)
+	{
+		int hardware = static_cast<int>(std::thread::hardware_concurrency());
+		workers = hardware > 1 ? hardware - 1 : 0;
+	}
+
+	for (int i = 0; i < workers; i++)
+	{
+		queues.push_back(std::unique_ptr<task_queue>(new task_queue));
+	}
+
+	for (int i = 0; i < workers; i++)
+	{
+		threads.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+/**
+*   @brief   Destructor.
+*   @details Wakes the workers so they can see the pool is stopping.
+*   @return  void
+*/
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(state_lock);
+		stopping = true;
+	}
+	work_ready.notify_all();
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+/**
+*   @brief   Runs a batch of tasks.
+*   @details The batch lives on the caller's stack, and each task
+             queued points back at it. The tasks are dealt out across
+			 the workers' queues in turn, then the workers are woken.
+			 The calling thread takes what it can of its own batch,
+			 leaving any other batch's tasks to the threads that queued
+			 them, before waiting for the stragglers.
+*   @return  void
+*/
+void ThreadPool::run(int tasks, const std::function<void(int)>& job)
+{
+	if (tasks <= 0)
+	{
+		return;
+	}
+
+	if (threads.empty() || tasks == 1)
+	{
+		for (int i = 0; i < tasks; i++)
+		{
+			job(i);
+		}
+		return;
+	}
+
+	batch work;
+	work.job = &job;
+	work.remaining = tasks;
+
+	const int queue_count = static_cast<int>(queues.size());
+	for (int i = 0; i < tasks; i++)
+	{
+		task_queue& queue = *queues[i % queue_count];
+		std::lock_guard<std::mutex> guard(queue.lock);
+		queue.tasks.push_back({ &work, i });
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(state_lock);
+		generation++;
+	}
+	work_ready.notify_all();
+
+	task next = {};
+	while (findTask(&work, next))
+	{
+		runTask(next);
+	}
+
+	std::unique_lock<std::mutex> guard(state_lock);
+	work_done.wait(guard, [&work]() { return work.remaining == 0; });
+}
+
+int ThreadPool::workers() const
+{
+	return static_cast<int>(threads.size());
+}
+
+void ThreadPool::workerLoop(int queue)
+{
+	unsigned int seen = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> guard(state_lock);
+			work_ready.wait(guard, [this, seen]() { return stopping || generation != seen; });
+			if (stopping)
+			{
+				return;
+			}
+			seen = generation;
+		}
+
+		execute(queue);
+	}
+}
+
+void ThreadPool::execute(int queue)
+{
+	task next = {};
+	while (popTask(queue, next) || stealTask(queue, next))
+	{
+		runTask(next);
+	}
+}
+
+/**
+*   @brief   Runs a task and counts it off its batch.
+*   @details Nothing of the batch is touched once the last task is
+             counted off, as the thread that queued it may return and
+			 free it straight away.
+*   @return  void
+*/
+void ThreadPool::runTask(const task& next)
+{
+	(*next.owner->job)(next.index);
+
+	if (--next.owner->remaining == 0)
+	{
+		std::lock_guard<std::mutex> guard(state_lock);
+		work_done.notify_all();
+	}
+}
+
+bool ThreadPool::popTask(int queue, task& next)
+{
+	task_queue& own = *queues[queue];
+	std::lock_guard<std::mutex> guard(own.lock);
+	if (own.tasks.empty())
+	{
+		return false;
+	}
+
+	next = own.tasks.back();
+	own.tasks.pop_back();
+	return true;
+}
+
+bool ThreadPool::stealTask(int queue, task& next)
+{
+	const int queue_count = static_cast<int>(queues.size());
+	for (int i = 1; i < queue_count; i++)
+	{
+		task_queue& victim = *queues[(queue + i) % queue_count];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (!victim.tasks.empty())
+		{
+			next = victim.tasks.front();
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+*   @brief   Takes a task of the given batch from any queue.
+*   @details Looks from the front, where thieves take from, leaving the
+             back to the queue's own worker.
+*   @return  True if a task was found.
+*/
+bool ThreadPool::findTask(const batch* work, task& next)
+{
+	for (auto& queue : queues)
+	{
+		std::lock_guard<std::mutex> guard(queue->lock);
+		for (auto it = queue->tasks.begin(); it != queue->tasks.end(); ++it)
+		{
+			if (it->owner == work)
+			{
+				next = *it;
+				queue->tasks.erase(it);
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+*  A fixed set of worker threads that run batches of tasks.
+*  Each worker owns a queue of tasks. A worker works from the back of
+*  its own queue and, once that is empty, steals from the front of the
+*  others. This keeps every thread busy when tasks vary in size, such
+*  as islands of bodies with very different numbers of contacts.
+*  Tasks within a batch must not touch the same data, as they may run
+*  in any order and on any thread.
+*
+*  Any number of threads may run batches at once, and a task may run a
+*  batch of its own. Each batch keeps its own count of tasks left, and
+*  the thread waiting on a batch only ever helps with that batch, so
+*  batches never wait on each other.
+*/
+class ThreadPool
+{
+public:
+
+	/**
+	*  Constructor.
+	*  @param [in] workers The number of threads to create. Zero uses
+	*  one less than the number of hardware threads, leaving a core
+	*  for the thread submitting work.
+	*/
+	explicit ThreadPool(int workers = 0);
+
+	/**
+	*  Destructor. Stops and joins the workers.
+	*/
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	*  Runs a batch of tasks and waits for them to finish.
+	*  The calling thread works on the batch too. Safe to call from
+	*  several threads at once, and from within a task.
+	*  @param [in] tasks The number of tasks in the batch
+	*  @param [in] job Called once with the index of each task
+	*/
+	void run(int tasks, const std::function<void(int)>& job);
+
+	/**
+	*  Returns the number of worker threads.
+	*  @return the worker count, not including the calling thread
+	*/
+	int  workers() const;
+
+private:
+	struct batch
+	{
+		const std::function<void(int)>* job;
+		std::atomic<int> remaining;
+	};
+
+	struct task
+	{
+		batch* owner;
+		int    index;
+	};
+
+	struct task_queue
+	{
+		std::mutex       lock;
+		std::deque<task> tasks;
+	};
+
+	void workerLoop(int queue);
+	void execute(int queue);
+	void runTask(const task& next);
+	bool popTask(int queue, task& next);
+	bool stealTask(int queue, task& next);
+	bool findTask(const batch* work, task& next);
+
+	std::vector<std::thread> threads;
+	std::vector<std::unique_ptr<task_queue>> queues;
+
+	std::mutex state_lock;
+	std::condition_variable work_ready;
+	std::condition_variable work_done;
+	unsigned int generation = 0;
+	bool stopping = false;
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+
+/**
+*  Hands values from one thread to another without locking.
+*  Of the three buffers, the producer owns one to write, the consumer
+*  owns one to read, and the third sits between them holding the
+*  latest value published. Publishing and acquiring each swap a buffer
+*  with the middle one in a single atomic exchange, so neither side
+*  ever waits for the other. The consumer always gets the latest value
+*  published and skips any it was too slow to see, while the producer
+*  never has to wait for a slow consumer.
+*
+*  Only one thread may produce and one consume. Buffers are reused,
+*  so the producer starts from whatever a buffer last held.
+*/
+template<typename T>
+class TripleBuffer
+{
+public:
+
+	/**
+	*  Returns the buffer to write the next value into.
+	*  Producer only.
+	*  @return the producer's buffer
+	*/
+	T&   back();
+
+	/**
+	*  Makes the value written into the back buffer the latest, and
+	*  gives the producer the buffer it replaces.
+	*  Producer only.
+	*/
+	void publish();
+
+	/**
+	*  Checks whether a value has been published since the last acquire.
+	*  @return true if acquire would get a new value
+	*/
+	bool fresh() const;
+
+	/**
+	*  Takes the latest value published, if it hasn't been taken.
+	*  Consumer only.
+	*  @return true if front now holds a new value, false if it still
+	*  holds the last one
+	*/
+	bool acquire();
+
+	/**
+	*  Returns the value last acquired.
+	*  Consumer only.
+	*  @return the consumer's buffer, default constructed until a value
+	*  is acquired
+	*/
+	const T& front() const;
+
+private:
+	static const int INDEX_MASK = 3;
+	static const int FRESH = 4;   // set in middle when it holds an unread value
+
+	T buffers[3];
+	int back_index = 0;
+	int front_index = 1;
+	std::atomic<int> middle { 2 };
+};
+
+template<typename T>
+T& TripleBuffer<T>::back()
+{
+	return buffers[back_index];
+}
+
+template<typename T>
+void TripleBuffer<T>::publish()
+{
+	// release makes the writes visible to the consumer that takes it
+	back_index = middle.exchange(back_index | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+}
+
+template<typename T>
+bool TripleBuffer<T>::fresh() const
+{
+	return (middle.load(std::memory_order_acquire) & FRESH) != 0;
+}
+
+template<typename T>
+bool TripleBuffer<T>::acquire()
+{
+	if (!fresh())
+	{
+		return false;
+	}
+
+	// acquire makes the producer's writes visible, and release hands
+	// back a buffer the consumer has finished reading
+	front_index = middle.exchange(front_index, std::memory_order_acq_rel) & INDEX_MASK;
+	return true;
+}
+
+template<typename T>
+const T& TripleBuffer<T>::front() const
+{
+	return buffers[front_index];
+}
@@ -2,6 +2,7 @@
 struct vector2
 {
 	// construction
+	vector2() = default;
 	vector2(float x_, float y_);
 	vector2(const vector2& rhs);
 	
@@ -1,3 +1,329 @@
+#if defined(ASGE_HEADLESS)
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Engine/Keys.h>
+#include "FrameScript.h"
+#include "Game.h"
+#include "ImageDiff.h"
+#include "NullRenderer.h"
+#include "Path.h"
+#include "SoftwareRenderer.h"
+
+namespace
+{
+	const int SCRIPT_PERIOD = 120;
+
+	/**
+	*   @brief   Plays a round of input, as a player might.
+	*   @details Space moves past the menus and restarts a lost level,
+	             then the rock is dragged back from the slingshot and
+				 let go. Anything the game isn't ready for is ignored
+				 by it, so the same round works in every state.
+	*   @return  void
+	*/
+	void queueRound(NullInput& input, int round)
+	{
+		input.key(ASGE::KEYS::KEY_SPACE, ASGE::KEYS::KEY_PRESSED);
+		input.key(ASGE::KEYS::KEY_SPACE, ASGE::KEYS::KEY_RELEASED);
+		input.moveCursor(370, 710);
+		input.click(0, ASGE::KEYS::KEY_PRESSED);
+		input.moveCursor(250 - round % 5 * 10, 760 + round % 3 * 20);
+	}
+
+	void printCount(const char* name, uint64_t count, double per_frame)
+	{
+		printf("%-16s %llu (%.1f a frame)\n", name,
+			static_cast<unsigned long long>(count), count * per_frame);
+	}
+
+	/**
+	*   @brief   Runs frames until the level has loaded.
+	*   @details The level streams in on other threads, so frames run
+	             in real time until it has.
+	*   @return  void
+	*/
+	void waitForLevel(AngryBirdsGame& game)
+	{
+		const auto loading = std::chrono::steady_clock::now();
+		while (!game.levelLoaded() && !game.exiting())
+		{
+			game.runFrames(1);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		printf("Loaded in %.0f ms\n",
+			std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loading).count());
+	}
+
+	struct capture_options
+	{
+		std::string script;
+		std::string out = "Captures";
+		std::string golden;             // empty to only save the frames
+		float threshold = 0.1f;         // see diffImages
+		int tolerated = 0;              // pixels a frame may differ by and still pass
+		unsigned int seed = 1;
+		bool threaded = false;          // draw on a render thread
+	};
+
+	void queueStep(NullInput& input, const script_step& step)
+	{
+		switch (step.action)
+		{
+		case ScriptAction::KEY:
+			input.key(step.code, step.state);
+			break;
+
+		case ScriptAction::CLICK:
+			input.click(step.code, step.state);
+			break;
+
+		case ScriptAction::MOVE:
+			input.moveCursor(step.position[0], step.position[1]);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	/**
+	*   @brief   Saves a captured frame and checks it against its golden.
+	*   @details The frame is saved as <name>.png. With golden frames to
+	             check against, a frame that differs also saves its
+				 heatmap as <name>.diff.png.
+	*   @return  True if the frame was saved and, if checked, passed.
+	*/
+	bool checkCapture(const capture_options& options, const std::string& name, const image& frame)
+	{
+		const std::string path = options.out + "/" + name;
+		if (!savePng(path + ".png", frame))
+		{
+			printf("%-16s couldn't be saved to %s.png\n", name.c_str(), path.c_str());
+			return false;
+		}
+		if (options.golden.empty())
+		{
+			printf("%-16s saved\n", name.c_str());
+			return true;
+		}
+
+		image golden;
+		image heatmap;
+		image_difference difference;
+		if (!loadPng(nativePath(options.golden + "/" + name + ".png"), golden))
+		{
+			printf("%-16s has no golden frame\n", name.c_str());
+			return false;
+		}
+		if (!diffImages(golden, frame, options.threshold, difference, &heatmap))
+		{
+			printf("%-16s is %dx%d, its golden frame %dx%d\n", name.c_str(),
+				frame.width, frame.height, golden.width, golden.height);
+			return false;
+		}
+
+		const bool passed = difference.differing <= options.tolerated;
+		printf("%-16s %s, %d pixels differ (largest %.3f, mean %.5f)\n", name.c_str(),
+			passed ? "passed" : "FAILED", difference.differing, difference.largest, difference.mean);
+		if (difference.differing > 0 && !savePng(path + ".diff.png", heatmap))
+		{
+			printf("%-16s heatmap couldn't be saved\n", name.c_str());
+		}
+		return passed;
+	}
+
+	/**
+	*   @brief   Plays a frame script and captures the frames it names.
+	*   @details Frames are drawn on the CPU at a fixed step, with the
+	             random seed set and streaming settled before every
+				 frame, so the same script draws the same frames on any
+				 machine. Frame 0 is the first after the level loads.
+	*   @return  The exit code, 0 if every capture passed.
+	*/
+	int runScript(const capture_options& options)
+	{
+		std::vector<script_step> steps;
+		int error_line = 0;
+		if (!loadFrameScript(nativePath(options.script), steps, error_line))
+		{
+			if (error_line > 0)
+			{
+				printf("%s: line %d couldn't be read\n", options.script.c_str(), error_line);
+			}
+			else
+			{
+				printf("%s couldn't be opened\n", options.script.c_str());
+			}
+			return 2;
+		}
+
+		AngryBirdsGame* game = new AngryBirdsGame;
+		std::srand(options.seed);
+		game->drawFrames(true);
+		game->renderOnThread(options.threaded);
+		if (!game->init())
+		{
+			printf("The game couldn't start\n");
+			delete game;
+			return 1;
+		}
+		waitForLevel(*game);
+		makeFolder(nativePath(options.out));
+
+		int failed = 0;
+		size_t next = 0;
+		for (int frame = 0; next < steps.size() && !game->exiting(); frame++)
+		{
+			game->settleAssets();
+
+			size_t captures = next;
+			for (; next < steps.size() && steps[next].frame == frame; next++)
+			{
+				queueStep(*game->nullInput(), steps[next]);
+			}
+			game->runFrames(1);
+
+			for (; captures < next; captures++)
+			{
+				if (steps[captures].action == ScriptAction::CAPTURE &&
+					!checkCapture(options, steps[captures].name, game->softwareRenderer()->framebuffer()))
+				{
+					failed++;
+				}
+			}
+		}
+
+		if (!options.golden.empty())
+		{
+			printf("%d of the captured frames failed\n", failed);
+		}
+		delete game;
+		return failed > 0 ? 1 : 0;
+	}
+}
+
+/**
+*  Runs the game without a window for a number of frames, with a
+*  scripted player, and prints what the renderer counted. With
+*  --draw, frames are drawn on the CPU as well, and with --thread they
+*  are drawn on a render thread while the next frame is updated.
+*
+*  Given a frame script instead, plays it and saves the frames it
+*  captures as PNGs, checking each against the golden frame of the
+*  same name if there are any, to show a change to how the game draws
+*  hasn't changed what it draws. Returns 1 if any frame failed.
+*
+*  Usage: AngryBirds [frames] [--draw] [--thread]
+*         AngryBirds --script <file> [--out <folder>] [--golden <folder>]
+*                    [--threshold <0 to 1>] [--tolerate <pixels>] [--seed <n>]
+*                    [--thread]
+*/
+int main(int argc, char* argv[])
+{
+	int frames = 6000;
+	bool draw = false;
+	bool threaded = false;
+	capture_options capture;
+	for (int i = 1; i < argc; i++)
+	{
+		const bool has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--draw") == 0)
+		{
+			draw = true;
+		}
+		else if (strcmp(argv[i], "--thread") == 0)
+		{
+			threaded = true;
+		}
+		else if (strcmp(argv[i], "--script") == 0 && has_value)
+		{
+			capture.script = argv[++i];
+		}
+		else if (strcmp(argv[i], "--out") == 0 && has_value)
+		{
+			capture.out = argv[++i];
+		}
+		else if (strcmp(argv[i], "--golden") == 0 && has_value)
+		{
+			capture.golden = argv[++i];
+		}
+		else if (strcmp(argv[i], "--threshold") == 0 && has_value)
+		{
+			capture.threshold = static_cast<float>(atof(argv[++i]));
+		}
+		else if (strcmp(argv[i], "--tolerate") == 0 && has_value)
+		{
+			capture.tolerated = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && has_value)
+		{
+			capture.seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+		}
+		else
+		{
+			frames = atoi(argv[i]);
+		}
+	}
+
+	if (!capture.script.empty())
+	{
+		capture.threaded = threaded;
+		return runScript(capture);
+	}
+
+	AngryBirdsGame* game = new AngryBirdsGame;
+	game->drawFrames(draw);
+	game->renderOnThread(threaded);
+	if (!game->init())
+	{
+		printf("The game couldn't start\n");
+		delete game;
+		return 1;
+	}
+
+	waitForLevel(*game);
+
+	const render_stats before = game->nullRenderer()->totalStats();
+	const double drawn_before = draw ? game->softwareRenderer()->drawMilliseconds() : 0.0;
+	const auto start = std::chrono::steady_clock::now();
+	int run = 0;
+	for (int round = 0; run < frames && !game->exiting(); round++)
+	{
+		queueRound(*game->nullInput(), round);
+		run += game->runFrames(1);
+		game->nullInput()->click(0, ASGE::KEYS::KEY_RELEASED);
+		run += game->runFrames(std::min(SCRIPT_PERIOD, frames - run) - 1);
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const render_stats& after = game->nullRenderer()->totalStats();
+	const double per_frame = run > 0 ? 1.0 / run : 0.0;
+	printf("Ran %d frames in %.3f s, %.0f fps\n", run, seconds, seconds > 0 ? run / seconds : 0.0);
+	printCount("Frames drawn", after.frames - before.frames, per_frame);
+	printCount("Sprites", after.sprites - before.sprites, per_frame);
+	printCount("Draw calls", after.draw_calls - before.draw_calls, per_frame);
+	printCount("Texture switches", after.texture_switches - before.texture_switches, per_frame);
+	printCount("Text glyphs", after.text_glyphs - before.text_glyphs, per_frame);
+	printf("Textures loaded  %d\n", game->nullRenderer()->textures());
+	if (draw)
+	{
+		printf("Drawing          %.3f ms a frame\n",
+			(game->softwareRenderer()->drawMilliseconds() - drawn_before) * per_frame);
+	}
+
+	delete game;
+	return 0;
+}
+
+#else
+
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #include <Engine/Platform.h>
@@ -16,4 +342,6 @@ int WINAPI WinMain(
 
 	delete game;
 	game = nullptr;
-}
\ No newline at end of file
+}
+
+#endif
@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+#include "MaxRects.h"
+#include "Png.h"
+#include "ThreadPool.h"
+
+/**
+*  Packs a folder of PNGs into one atlas.
+*  Writes the atlas image and a TextureAtlas XML describing it, in the
+*  same form as the Kenney sheets, so TextureAtlas loads either.
+*
+*  Usage: AtlasPacker <input folder> <output.png> [options]
+*    --padding N   empty pixels between images (default 2)
+*    --extrude N   pixels each image's edges are repeated outwards, so
+*                  filtering at a region's border doesn't pick up its
+*                  neighbours (default 1)
+*    --max-size N  the largest atlas side to try (default 4096)
+*/
+
+namespace
+{
+	struct packer_input
+	{
+		std::string name;
+		image pixels;
+		pixel_rect placed;
+		bool loaded = false;
+	};
+
+	struct packer_options
+	{
+		std::string input_folder;
+		std::string output_path;
+		int padding = 2;
+		int extrude = 1;
+		int max_size = 4096;
+	};
+
+	bool endsWithPng(const std::string& name)
+	{
+		if (name.size() < 4)
+		{
+			return false;
+		}
+
+		std::string extension = name.substr(name.size() - 4);
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		return extension == ".png";
+	}
+
+	/**
+	*   @brief   Lists the PNGs directly inside a folder.
+	*   @return  The file names, sorted so atlases come out the same
+	             every run.
+	*/
+	std::vector<std::string> listPngs(const std::string& folder)
+	{
+		std::vector<std::string> names;
+
+#ifdef _WIN32
+		WIN32_FIND_DATAA found;
+		HANDLE search = FindFirstFileA((folder + "\\*").c_str(), &found);
+		if (search != INVALID_HANDLE_VALUE)
+		{
+			do
+			{
+				if (!(found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && endsWithPng(found.cFileName))
+				{
+					names.push_back(found.cFileName);
+				}
+			} while (FindNextFileA(search, &found));
+			FindClose(search);
+		}
+#else
+		DIR* directory = opendir(folder.c_str());
+		if (directory)
+		{
+			while (dirent* entry = readdir(directory))
+			{
+				if (entry->d_name[0] != '.' && endsWithPng(entry->d_name))
+				{
+					names.push_back(entry->d_name);
+				}
+			}
+			closedir(directory);
+		}
+#endif
+
+		std::sort(names.begin(), names.end());
+		return names;
+	}
+
+	bool parseArguments(int argc, char* argv[], packer_options& options)
+	{
+		int positional = 0;
+		for (int i = 1; i < argc; i++)
+		{
+			std::string argument = argv[i];
+			int* value = argument == "--padding" ? &options.padding :
+				argument == "--extrude" ? &options.extrude :
+				argument == "--max-size" ? &options.max_size : nullptr;
+
+			if (value)
+			{
+				if (++i >= argc)
+				{
+					return false;
+				}
+				*value = atoi(argv[i]);
+			}
+			else if (positional == 0)
+			{
+				options.input_folder = argument;
+				positional++;
+			}
+			else if (positional == 1)
+			{
+				options.output_path = argument;
+				positional++;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return positional == 2 && options.padding >= 0 && options.extrude >= 0 && options.max_size > 0;
+	}
+
+	/**
+	*   @brief   Packs every image into the smallest atlas that fits.
+	*   @details Sizes are tried in order of area, growing one side at
+	             a time from the smallest power of two square holding
+				 all the pixels. Each image takes its extruded size plus
+				 the padding. The bin is one padding wider and taller
+				 than the atlas, so the padding after images on the
+				 right and bottom edges falls outside it.
+	*   @return  True if everything fit within the largest size.
+	*/
+	bool pack(std::vector<packer_input*>& inputs, const packer_options& options, int& width, int& height)
+	{
+		const int border = options.extrude * 2 + options.padding;
+		long long area = 0;
+		for (const packer_input* input : inputs)
+		{
+			area += static_cast<long long>(input->pixels.width + border) * (input->pixels.height + border);
+		}
+
+		// the largest first, which leaves the small ones to fill the gaps
+		std::sort(inputs.begin(), inputs.end(), [](const packer_input* lhs, const packer_input* rhs)
+		{
+			int lhs_side = std::max(lhs->pixels.width, lhs->pixels.height);
+			int rhs_side = std::max(rhs->pixels.width, rhs->pixels.height);
+			if (lhs_side != rhs_side)
+			{
+				return lhs_side > rhs_side;
+			}
+			return lhs->name < rhs->name;
+		});
+
+		width = 1;
+		height = 1;
+		while (static_cast<long long>(width) * height < area)
+		{
+			width < height ? width *= 2 : height *= 2;
+		}
+
+		MaxRects bin(0, 0);
+		while (width <= options.max_size && height <= options.max_size)
+		{
+			bin.reset(width + options.padding, height + options.padding);
+
+			bool fits = true;
+			for (packer_input* input : inputs)
+			{
+				if (!bin.insert(input->pixels.width + border, input->pixels.height + border, input->placed))
+				{
+					fits = false;
+					break;
+				}
+			}
+
+			if (fits)
+			{
+				return true;
+			}
+			width <= height ? width *= 2 : height *= 2;
+		}
+
+		return false;
+	}
+
+	/**
+	*   @brief   Copies an image into its place in the atlas.
+	*   @details The extruded border repeats the nearest edge pixel, the
+	             corners repeating the corner pixels.
+	*   @return  void
+	*/
+	void blit(const packer_input& input, int extrude, image& atlas)
+	{
+		const image& source = input.pixels;
+		for (int y = -extrude; y < source.height + extrude; y++)
+		{
+			int source_y = std::min(std::max(y, 0), source.height - 1);
+			uint8_t* row = atlas.pixels.data() +
+				(static_cast<size_t>(input.placed.y + extrude + y) * atlas.width + input.placed.x + extrude) * 4;
+
+			for (int x = -extrude; x < source.width + extrude; x++)
+			{
+				int source_x = std::min(std::max(x, 0), source.width - 1);
+				memcpy(row + x * 4,
+					source.pixels.data() + (static_cast<size_t>(source_y) * source.width + source_x) * 4, 4);
+			}
+		}
+	}
+
+	std::string fileName(const std::string& path)
+	{
+		size_t folder_end = path.find_last_of("/\\");
+		return folder_end == std::string::npos ? path : path.substr(folder_end + 1);
+	}
+
+	bool writeIndex(const std::string& path, const std::string& image_name,
+		const std::vector<packer_input>& inputs, int extrude)
+	{
+		FILE* file = fopen(path.c_str(), "wb");
+		if (!file)
+		{
+			return false;
+		}
+
+		fprintf(file, "<TextureAtlas imagePath=\"%s\">\n", image_name.c_str());
+		for (const packer_input& input : inputs)
+		{
+			if (input.loaded)
+			{
+				fprintf(file, "\t<SubTexture name=\"%s\" x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\"/>\n",
+					input.name.c_str(), input.placed.x + extrude, input.placed.y + extrude,
+					input.pixels.width, input.pixels.height);
+			}
+		}
+		fprintf(file, "</TextureAtlas>\n");
+
+		return fclose(file) == 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	packer_options options;
+	if (!parseArguments(argc, argv, options))
+	{
+		printf("Usage: AtlasPacker <input folder> <output.png> "
+			"[--padding N] [--extrude N] [--max-size N]\n");
+		return 1;
+	}
+
+	std::vector<std::string> names = listPngs(options.input_folder);
+	std::vector<packer_input> inputs(names.size());
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		inputs[i].name = names[i];
+	}
+
+	ThreadPool thread_pool;
+	thread_pool.run(static_cast<int>(inputs.size()), [&inputs, &options](int i)
+	{
+		inputs[i].loaded = loadPng(options.input_folder + "/" + inputs[i].name, inputs[i].pixels);
+	});
+
+	std::vector<packer_input*> packed;
+	for (packer_input& input : inputs)
+	{
+		if (input.loaded)
+		{
+			packed.push_back(&input);
+		}
+		else
+		{
+			printf("Skipping %s, it couldn't be decoded\n", input.name.c_str());
+		}
+	}
+
+	if (packed.empty())
+	{
+		printf("No images found in %s\n", options.input_folder.c_str());
+		return 1;
+	}
+
+	image atlas;
+	if (!pack(packed, options, atlas.width, atlas.height))
+	{
+		printf("The images don't fit in a %d pixel atlas\n", options.max_size);
+		return 1;
+	}
+
+	// placements never overlap, so each image can be copied in parallel
+	atlas.pixels.assign(static_cast<size_t>(atlas.width) * atlas.height * 4, 0);
+	thread_pool.run(static_cast<int>(packed.size()), [&packed, &options, &atlas](int i)
+	{
+		blit(*packed[i], options.extrude, atlas);
+	});
+
+	std::string index_path = options.output_path.substr(0, options.output_path.find_last_of('.')) + ".xml";
+	if (!savePng(options.output_path, atlas) ||
+		!writeIndex(index_path, fileName(options.output_path), inputs, options.extrude))
+	{
+		printf("Couldn't write %s\n", options.output_path.c_str());
+		return 1;
+	}
+
+	printf("Packed %d images into %dx%d\n", static_cast<int>(packed.size()), atlas.width, atlas.height);
+	return 0;
+}
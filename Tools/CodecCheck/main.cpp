@@ -0,0 +1,583 @@
+#include <algorithm>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "Jpeg.h"
+#include "Lz4.h"
+#include "MappedFile.h"
+#include "Path.h"
+#include "Png.h"
+
+/**
+*  Checks the codecs the game loads its files with.
+*  PNG images are encoded and decoded again, both deflated and stored,
+*  and LZ4 blocks compressed and decompressed again, each of which must
+*  give back exactly what went in. Then streams that are cut short,
+*  damaged or point back before the start of their output are fed to
+*  every decoder, including the JPEG decoder with the file it's given,
+*  and must be rejected rather than read or write out of bounds.
+*  Build it with AddressSanitizer where it's available, so an overrun
+*  stops the check even when the decoder gets the answer right.
+*
+*  Usage: CodecCheck <jpeg file>
+*    e.g. CodecCheck Resources\Textures\MyAssets\menu.jpg
+*
+*  Returns 1 if any check failed. Outside Visual Studio, from the
+*  repository's root:
+*    g++ -std=c++17 -g -fsanitize=address,undefined -ISource
+*        Tools/CodecCheck/main.cpp Source/Jpeg.cpp Source/Lz4.cpp
+*        Source/MappedFile.cpp Source/Path.cpp Source/Png.cpp
+*        -o CodecCheck
+*    ./CodecCheck Resources/Textures/MyAssets/menu.jpg
+*/
+
+namespace
+{
+	const uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+	struct check_count
+	{
+		int passed = 0;
+		int failed = 0;
+	};
+
+	check_count counts;
+
+	void check(bool passed, const char* what, int detail = 0)
+	{
+		if (passed)
+		{
+			counts.passed++;
+			return;
+		}
+
+		counts.failed++;
+		printf("  FAILED %s (%d)\n", what, detail);
+	}
+
+	uint32_t nextRandom(uint32_t& state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+
+	/**
+	*   @brief   Makes an image to encode.
+	*   @details Noise barely compresses, flat colour compresses to
+	             almost nothing, and stripes sit between the two with
+				 long repeats a row apart.
+	*   @return  The image.
+	*/
+	image makeImage(int width, int height, int pattern, uint32_t& state)
+	{
+		image made;
+		made.width = width;
+		made.height = height;
+		made.pixels.resize(static_cast<size_t>(width) * height * 4);
+		for (size_t i = 0; i < made.pixels.size(); i++)
+		{
+			const size_t x = i / 4 % width;
+			made.pixels[i] =
+				pattern == 0 ? static_cast<uint8_t>(nextRandom(state)) :
+				pattern == 1 ? static_cast<uint8_t>(i % 4 * 60 + 15) :
+				static_cast<uint8_t>(x / 3 % 2 ? 255 - i % 4 : i % 4 * 40);
+		}
+		return made;
+	}
+
+	uint32_t crc32(const uint8_t* data, size_t size)
+	{
+		uint32_t crc = 0xffffffffu;
+		for (size_t i = 0; i < size; i++)
+		{
+			crc ^= data[i];
+			for (int bit = 0; bit < 8; bit++)
+			{
+				crc = crc & 1 ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+			}
+		}
+		return ~crc;
+	}
+
+	uint32_t adler32(const uint8_t* data, size_t size)
+	{
+		uint32_t a = 1, b = 0;
+		for (size_t i = 0; i < size; i++)
+		{
+			a = (a + data[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		return b << 16 | a;
+	}
+
+	void writeBig(std::vector<uint8_t>& out, uint32_t value)
+	{
+		out.push_back(static_cast<uint8_t>(value >> 24));
+		out.push_back(static_cast<uint8_t>(value >> 16));
+		out.push_back(static_cast<uint8_t>(value >> 8));
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	void writeChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& body)
+	{
+		writeBig(out, static_cast<uint32_t>(body.size()));
+		const size_t start = out.size();
+		out.insert(out.end(), type, type + 4);
+		out.insert(out.end(), body.begin(), body.end());
+		writeBig(out, crc32(out.data() + start, out.size() - start));
+	}
+
+	/**
+	*   @brief   Wraps a zlib stream in an RGBA PNG.
+	*   @return  The PNG file.
+	*/
+	std::vector<uint8_t> makePng(int width, int height, const std::vector<uint8_t>& zlib)
+	{
+		std::vector<uint8_t> header;
+		writeBig(header, static_cast<uint32_t>(width));
+		writeBig(header, static_cast<uint32_t>(height));
+		const uint8_t format[5] = { 8, 6, 0, 0, 0 };   // 8 bit RGBA, not interlaced
+		header.insert(header.end(), format, format + 5);
+
+		std::vector<uint8_t> png(PNG_SIGNATURE, PNG_SIGNATURE + 8);
+		writeChunk(png, "IHDR", header);
+		writeChunk(png, "IDAT", zlib);
+		writeChunk(png, "IEND", std::vector<uint8_t>());
+		return png;
+	}
+
+	/**
+	*   @brief   Finds the zlib stream in a PNG written by encodePng.
+	*   @return  False if it has no image data.
+	*/
+	bool findImageData(const std::vector<uint8_t>& png, std::vector<uint8_t>& zlib)
+	{
+		for (size_t position = 8; position + 12 <= png.size();)
+		{
+			const uint32_t length = static_cast<uint32_t>(png[position]) << 24 | png[position + 1] << 16 |
+				png[position + 2] << 8 | png[position + 3];
+			if (memcmp(png.data() + position + 4, "IDAT", 4) == 0)
+			{
+				zlib.assign(png.begin() + position + 8, png.begin() + position + 8 + length);
+				return true;
+			}
+			position += length + 12;
+		}
+		return false;
+	}
+
+	/**
+	*  Writes a deflate stream a bit at a time, lowest first, with
+	*  Huffman codes sent highest bit first as deflate wants them.
+	*/
+	struct bit_writer
+	{
+		std::vector<uint8_t> bytes;
+		uint32_t bits = 0;
+		int count = 0;
+
+		void put(uint32_t value, int length)
+		{
+			for (int i = 0; i < length; i++)
+			{
+				bits |= (value >> i & 1) << count;
+				if (++count == 8)
+				{
+					bytes.push_back(static_cast<uint8_t>(bits));
+					bits = 0;
+					count = 0;
+				}
+			}
+		}
+
+		void putCode(uint32_t code, int length)
+		{
+			for (int i = length - 1; i >= 0; i--)
+			{
+				put(code >> i & 1, 1);
+			}
+		}
+
+		/**
+		*  Writes a symbol with the fixed literal and length code.
+		*/
+		void putFixed(int symbol)
+		{
+			if (symbol < 144)
+			{
+				putCode(0x30 + symbol, 8);
+			}
+			else if (symbol < 256)
+			{
+				putCode(0x190 + symbol - 144, 9);
+			}
+			else if (symbol < 280)
+			{
+				putCode(symbol - 256, 7);
+			}
+			else
+			{
+				putCode(0xc0 + symbol - 280, 8);
+			}
+		}
+
+		void flush()
+		{
+			if (count > 0)
+			{
+				bytes.push_back(static_cast<uint8_t>(bits));
+				bits = 0;
+				count = 0;
+			}
+		}
+	};
+
+	enum class FixedStream
+	{
+		VALID,            /**< Five literals, a whole 1x1 image. */
+		BEFORE_START,     /**< A match five back, with one byte written. */
+		BAD_DISTANCE,     /**< Distance code 30, which deflate never uses. */
+		NO_END            /**< Stops before the end of block code. */
+	};
+
+	/**
+	*   @brief   Hand codes a zlib stream with one fixed Huffman block.
+	*   @details Written a bit at a time rather than by the encoder, as
+	             the encoder never writes a bad stream.
+	*   @return  The zlib stream.
+	*/
+	std::vector<uint8_t> makeFixedStream(FixedStream kind)
+	{
+		bit_writer out;
+		out.put(1, 1);   // last block
+		out.put(1, 2);   // fixed codes
+		out.putFixed(0); // no filter
+
+		if (kind == FixedStream::BEFORE_START)
+		{
+			out.putFixed(258);   // a length of 4
+			out.putCode(4, 5);   // distances 5 and 6
+			out.put(0, 1);
+		}
+		else if (kind == FixedStream::BAD_DISTANCE)
+		{
+			out.putFixed(1);
+			out.putFixed(258);
+			out.putCode(30, 5);
+		}
+		else
+		{
+			for (int symbol = 1; symbol <= 4; symbol++)
+			{
+				out.putFixed(symbol * 50);
+			}
+		}
+
+		if (kind != FixedStream::NO_END)
+		{
+			out.putFixed(256);
+		}
+		out.flush();
+
+		std::vector<uint8_t> zlib(out.bytes.size() + 2);
+		zlib[0] = 0x78;
+		zlib[1] = 0x01;
+		std::copy(out.bytes.begin(), out.bytes.end(), zlib.begin() + 2);
+		if (kind != FixedStream::NO_END)
+		{
+			const uint8_t raw[5] = { 0, 50, 100, 150, 200 };
+			writeBig(zlib, adler32(raw, sizeof(raw)));
+		}
+		return zlib;
+	}
+
+	/**
+	*   @brief   Checks PNG images survive encoding and decoding.
+	*   @details Odd sizes leave rows that don't fill a word, and each
+	             pattern exercises a different mix of filters and
+				 matches.
+	*   @return  void
+	*/
+	void checkPngRoundTrips()
+	{
+		const int sizes[][2] = { { 1, 1 }, { 3, 2 }, { 17, 5 }, { 64, 64 }, { 255, 3 }, { 300, 200 } };
+		uint32_t state = 0x9e3779b9u;
+		for (const auto& size : sizes)
+		{
+			for (int pattern = 0; pattern < 3; pattern++)
+			{
+				for (int compress = 0; compress < 2; compress++)
+				{
+					const image source = makeImage(size[0], size[1], pattern, state);
+					std::vector<uint8_t> encoded;
+					image decoded;
+					const bool round_trip = encodePng(source, encoded, compress != 0) &&
+						decodePng(encoded.data(), encoded.size(), decoded) &&
+						decoded.width == source.width && decoded.height == source.height &&
+						decoded.pixels == source.pixels;
+					check(round_trip, compress ? "PNG deflated round trip" : "PNG stored round trip", size[0]);
+				}
+			}
+		}
+	}
+
+	/**
+	*   @brief   Checks cut short and damaged PNGs are rejected.
+	*   @details The zlib stream is cut at every byte before its
+	             checksum, which the decoder doesn't read, and wrapped
+				 in a new PNG so only the stream is short. Damaged files
+				 only have to be survived, as a flipped bit in a pixel
+				 still decodes.
+	*   @return  void
+	*/
+	void checkPngDamage()
+	{
+		uint32_t state = 12345;
+		for (int compress = 0; compress < 2; compress++)
+		{
+			const image source = makeImage(40, 30, 2, state);
+			std::vector<uint8_t> encoded;
+			std::vector<uint8_t> zlib;
+			if (!encodePng(source, encoded, compress != 0) || !findImageData(encoded, zlib) || zlib.size() < 6)
+			{
+				check(false, "PNG to cut short");
+				continue;
+			}
+
+			for (size_t cut = 0; cut < zlib.size() - 4; cut++)
+			{
+				const std::vector<uint8_t> shortened(zlib.begin(), zlib.begin() + cut);
+				const std::vector<uint8_t> png = makePng(source.width, source.height, shortened);
+				image decoded;
+				check(!decodePng(png.data(), png.size(), decoded),
+					compress ? "cut short deflate stream rejected" : "cut short stored stream rejected",
+					static_cast<int>(cut));
+			}
+
+			for (size_t cut = 0; cut < encoded.size(); cut += 7)
+			{
+				image decoded;
+				decodePng(encoded.data(), cut, decoded);
+			}
+
+			for (int damage = 0; damage < 500; damage++)
+			{
+				std::vector<uint8_t> damaged = encoded;
+				damaged[8 + nextRandom(state) % (damaged.size() - 8)] ^= static_cast<uint8_t>(1 << nextRandom(state) % 8);
+				image decoded;
+				if (decodePng(damaged.data(), damaged.size(), decoded))
+				{
+					check(decoded.pixels.size() == static_cast<size_t>(decoded.width) * decoded.height * 4,
+						"damaged PNG decodes to a whole image", damage);
+				}
+			}
+		}
+	}
+
+	/**
+	*   @brief   Checks inflate rejects streams the encoder never writes.
+	*   @details A valid hand coded stream is checked first, so the bad
+	             ones are known to fail for the reason given.
+	*   @return  void
+	*/
+	void checkInflate()
+	{
+		image decoded;
+		std::vector<uint8_t> png = makePng(1, 1, makeFixedStream(FixedStream::VALID));
+		const uint8_t expected[4] = { 50, 100, 150, 200 };
+		check(decodePng(png.data(), png.size(), decoded) && decoded.pixels.size() == 4 &&
+			memcmp(decoded.pixels.data(), expected, 4) == 0, "hand coded stream decodes");
+
+		png = makePng(1, 1, makeFixedStream(FixedStream::BEFORE_START));
+		check(!decodePng(png.data(), png.size(), decoded), "match before the start rejected");
+
+		png = makePng(1, 1, makeFixedStream(FixedStream::BAD_DISTANCE));
+		check(!decodePng(png.data(), png.size(), decoded), "unused distance code rejected");
+
+		png = makePng(1, 1, makeFixedStream(FixedStream::NO_END));
+		check(!decodePng(png.data(), png.size(), decoded), "block with no end rejected");
+
+		// a stored block whose length and its complement disagree
+		const std::vector<uint8_t> stored = { 0x78, 0x01, 0x01, 0x05, 0x00, 0xfb, 0xff, 0, 1, 2, 3, 4 };
+		png = makePng(1, 1, stored);
+		check(!decodePng(png.data(), png.size(), decoded), "stored block with a bad length rejected");
+	}
+
+	/**
+	*   @brief   Checks LZ4 blocks survive compressing and decompressing.
+	*   @details Repeats from one to twenty bytes apart give matches
+	             that overlap what they write as well as ones that
+				 don't, and the sizes cross the limits on where
+				 matches may start.
+	*   @return  void
+	*/
+	void checkLz4RoundTrips()
+	{
+		uint32_t state = 777;
+		for (int round = 0; round < 500; round++)
+		{
+			const size_t size = round < 20 ? round : nextRandom(state) % 20000;
+			const size_t period = 1 + nextRandom(state) % 20;
+			std::vector<char> data(size);
+			for (size_t i = 0; i < size; i++)
+			{
+				data[i] = nextRandom(state) % 4 == 0 || i < period ?
+					static_cast<char>(nextRandom(state)) : data[i - period];
+			}
+
+			std::vector<char> compressed;
+			compressLz4(data.data(), data.size(), compressed);
+			std::vector<char> out(size + 1, 0);
+			check(decompressLz4(compressed.data(), compressed.size(), out.data(), size) &&
+				std::equal(data.begin(), data.end(), out.begin()), "LZ4 round trip", round);
+		}
+	}
+
+	/**
+	*   @brief   Checks cut short and damaged LZ4 blocks are rejected.
+	*   @details Output is decompressed into a buffer exactly the size
+	             given, so any write past it is caught by the sanitizer.
+	*   @return  void
+	*/
+	void checkLz4Damage()
+	{
+		uint32_t state = 4242;
+		std::vector<char> data(3000);
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			data[i] = i < 9 || nextRandom(state) % 3 == 0 ? static_cast<char>(nextRandom(state)) : data[i - 9];
+		}
+
+		std::vector<char> compressed;
+		compressLz4(data.data(), data.size(), compressed);
+		for (size_t cut = 0; cut < compressed.size(); cut++)
+		{
+			std::vector<char> out(data.size());
+			check(!decompressLz4(compressed.data(), cut, out.data(), out.size()),
+				"cut short LZ4 block rejected", static_cast<int>(cut));
+		}
+
+		std::vector<char> out(data.size());
+		check(!decompressLz4(compressed.data(), compressed.size(), out.data(), out.size() - 1),
+			"LZ4 block longer than its output rejected");
+
+		for (int damage = 0; damage < 2000; damage++)
+		{
+			std::vector<char> damaged = compressed;
+			damaged[nextRandom(state) % damaged.size()] ^= static_cast<char>(1 << nextRandom(state) % 8);
+			decompressLz4(damaged.data(), damaged.size(), out.data(), out.size());
+		}
+
+		// one literal, then a four byte match two bytes back
+		const char before_start[] = { 0x10, 'a', 0x02, 0x00, 0x00 };
+		char small[8];
+		check(!decompressLz4(before_start, sizeof(before_start), small, 5), "LZ4 match before the start rejected");
+
+		const char no_distance[] = { 0x10, 'a', 0x00, 0x00, 0x00 };
+		check(!decompressLz4(no_distance, sizeof(no_distance), small, 5), "LZ4 match with no distance rejected");
+	}
+
+	/**
+	*   @brief   Checks the JPEG decoder with a file and damaged copies.
+	*   @details There's no encoder, so the file must decode, and every
+	             cut before its first scan must fail. Cuts within the
+				 scan, and damage anywhere, only have to be survived.
+	*   @return  void
+	*/
+	void checkJpeg(const std::string& path)
+	{
+		MappedFile file;
+		if (!file.open(nativePath(path)))
+		{
+			check(false, "JPEG file opened");
+			return;
+		}
+
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(file.data());
+		const std::vector<uint8_t> source(data, data + file.size());
+		image decoded;
+		check(decodeJpeg(source.data(), source.size(), decoded) && decoded.width > 0 && decoded.height > 0 &&
+			decoded.pixels.size() == static_cast<size_t>(decoded.width) * decoded.height * 4, "JPEG decodes");
+		const int width = decoded.width;
+		const int height = decoded.height;
+
+		size_t scan = 0;
+		for (size_t i = 0; i + 1 < source.size(); i++)
+		{
+			if (source[i] == 0xff && source[i + 1] == 0xda)
+			{
+				scan = i;
+				break;
+			}
+		}
+		check(scan > 0, "JPEG has a scan");
+
+		for (size_t cut = 0; cut < scan; cut++)
+		{
+			std::vector<uint8_t> shortened(source.begin(), source.begin() + cut);
+			image partial;
+			check(!decodeJpeg(shortened.data(), shortened.size(), partial), "cut short JPEG header rejected",
+				static_cast<int>(cut));
+		}
+
+		const size_t step = source.size() / 500 + 1;
+		for (size_t cut = scan; cut < source.size(); cut += step)
+		{
+			std::vector<uint8_t> shortened(source.begin(), source.begin() + cut);
+			image partial;
+			if (decodeJpeg(shortened.data(), shortened.size(), partial))
+			{
+				check(partial.width == width && partial.height == height, "cut short JPEG keeps its size",
+					static_cast<int>(cut));
+			}
+		}
+
+		uint32_t state = 31337;
+		for (int damage = 0; damage < 300; damage++)
+		{
+			std::vector<uint8_t> damaged = source;
+			damaged[nextRandom(state) % damaged.size()] ^= static_cast<uint8_t>(1 << nextRandom(state) % 8);
+			image result;
+			if (decodeJpeg(damaged.data(), damaged.size(), result))
+			{
+				check(result.pixels.size() == static_cast<size_t>(result.width) * result.height * 4,
+					"damaged JPEG decodes to a whole image", damage);
+			}
+		}
+	}
+
+	void runSection(const char* name, void (*section)())
+	{
+		const check_count before = counts;
+		section();
+		printf("%-22s %5d passed, %d failed\n", name,
+			counts.passed - before.passed, counts.failed - before.failed);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+	{
+		printf("Usage: CodecCheck <jpeg file>\n");
+		return 1;
+	}
+
+	runSection("PNG round trips", checkPngRoundTrips);
+	runSection("PNG damage", checkPngDamage);
+	runSection("Inflate", checkInflate);
+	runSection("LZ4 round trips", checkLz4RoundTrips);
+	runSection("LZ4 damage", checkLz4Damage);
+
+	static std::string jpeg_path;
+	jpeg_path = argv[1];
+	runSection("JPEG", []() { checkJpeg(jpeg_path); });
+
+	printf("%d checks failed\n", counts.failed);
+	return counts.failed > 0 ? 1 : 0;
+}
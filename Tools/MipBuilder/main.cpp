@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "Png.h"
+#include "Resample.h"
+#include "TextureVariants.h"
+#include "ThreadPool.h"
+
+/**
+*  Writes a mip chain beside every PNG under a folder.
+*  Each level halves the last with a box filter, until the longer side
+*  would drop below the minimum size. The game loads the smallest level
+*  that covers the size a sprite is drawn at, so textures drawn far
+*  below their size no longer fill texture memory at full resolution.
+*  Levels left over from a larger version of an image are removed.
+*  Images are processed in parallel. Run it before PackBuilder so the
+*  variants are packed too.
+*
+*  Usage: MipBuilder <folder> [--min-size 16]
+*    e.g. MipBuilder Resources\Textures
+*/
+
+namespace
+{
+	struct mip_result
+	{
+		int levels = 0;
+		bool failed = false;
+	};
+
+	/**
+	*   @brief   Lists every file under a folder.
+	*   @return  void
+	*/
+	void listFiles(const std::string& folder, std::vector<std::string>& paths)
+	{
+#ifdef _WIN32
+		WIN32_FIND_DATAA found;
+		HANDLE search = FindFirstFileA((folder + "\\*").c_str(), &found);
+		if (search == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		do
+		{
+			std::string name = found.cFileName;
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+
+			if (found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			{
+				listFiles(folder + "\\" + name, paths);
+			}
+			else
+			{
+				paths.push_back(folder + "\\" + name);
+			}
+		} while (FindNextFileA(search, &found));
+		FindClose(search);
+#else
+		DIR* directory = opendir(folder.c_str());
+		if (!directory)
+		{
+			return;
+		}
+
+		while (dirent* entry = readdir(directory))
+		{
+			std::string name = entry->d_name;
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+
+			std::string path = folder + "/" + name;
+			struct stat info;
+			if (stat(path.c_str(), &info) != 0)
+			{
+				continue;
+			}
+
+			if (S_ISDIR(info.st_mode))
+			{
+				listFiles(path, paths);
+			}
+			else if (S_ISREG(info.st_mode))
+			{
+				paths.push_back(path);
+			}
+		}
+		closedir(directory);
+#endif
+	}
+
+	/**
+	*   @brief   Checks a path is a source PNG rather than a level.
+	*   @return  True for PNGs not named like a mip level.
+	*/
+	bool isSource(const std::string& path)
+	{
+		std::string lower = path;
+		std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+		if (lower.size() < 4 || lower.compare(lower.size() - 4, 4, ".png") != 0)
+		{
+			return false;
+		}
+
+		size_t mip = lower.rfind(".mip");
+		if (mip == std::string::npos)
+		{
+			return true;
+		}
+
+		size_t digits = mip + 4;
+		size_t end = lower.size() - 4;
+		return digits == end || lower.find_first_not_of("0123456789", digits) != end;
+	}
+
+	/**
+	*   @brief   Writes one image's mip chain.
+	*   @return  void
+	*/
+	void buildChain(const std::string& path, int min_size, mip_result& result)
+	{
+		image level;
+		if (!loadPng(path, level))
+		{
+			result.failed = true;
+			return;
+		}
+
+		int written = 0;
+		while ((level.width > level.height ? level.width : level.height) / 2 >= min_size &&
+			written < TextureVariants::MAX_LEVEL)
+		{
+			image halved;
+			if (!halveImage(level, halved) || !savePng(TextureVariants::path(path, written + 1), halved))
+			{
+				result.failed = true;
+				return;
+			}
+			level.width = halved.width;
+			level.height = halved.height;
+			level.pixels.swap(halved.pixels);
+			written++;
+		}
+
+		// a smaller source than last time leaves levels the game would pick
+		for (int stale = written + 1; stale <= TextureVariants::MAX_LEVEL; stale++)
+		{
+			remove(TextureVariants::path(path, stale).c_str());
+		}
+
+		result.levels = written;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int min_size = 16;
+	std::string folder;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--min-size") == 0 && i + 1 < argc)
+		{
+			min_size = atoi(argv[++i]);
+		}
+		else if (folder.empty())
+		{
+			folder = argv[i];
+		}
+		else
+		{
+			folder.clear();
+			break;
+		}
+	}
+
+	if (folder.empty() || min_size < 1)
+	{
+		printf("Usage: MipBuilder <folder> [--min-size 16]\n");
+		return 1;
+	}
+
+	std::vector<std::string> paths;
+	listFiles(folder, paths);
+	paths.erase(std::remove_if(paths.begin(), paths.end(), [](const std::string& path)
+	{
+		return !isSource(path);
+	}), paths.end());
+	std::sort(paths.begin(), paths.end());
+
+	std::vector<mip_result> results(paths.size());
+	ThreadPool thread_pool;
+	thread_pool.run(static_cast<int>(paths.size()), [&paths, &results, min_size](int i)
+	{
+		buildChain(paths[i], min_size, results[i]);
+	});
+
+	int levels = 0;
+	int failed = 0;
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		if (results[i].failed)
+		{
+			printf("Couldn't build the levels of %s\n", paths[i].c_str());
+			failed++;
+		}
+		levels += results[i].levels;
+	}
+
+	printf("Wrote %d levels for %d images\n", levels, static_cast<int>(paths.size()) - failed);
+	return failed ? 1 : 0;
+}
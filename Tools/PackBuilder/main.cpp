@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "Lz4.h"
+#include "MappedFile.h"
+#include "Path.h"
+#include "ResourcePack.h"
+#include "ThreadPool.h"
+
+/**
+*  Builds a resource pack from a folder.
+*  Every file under the folder is stored under its normalised path,
+*  folder name included, so the game finds it by the same path it
+*  would open from disk. Run it from the folder the game runs in.
+*  Files in formats that are already compressed are stored as they
+*  are. Everything else is compressed with LZ4, unless that saves too
+*  little to be worth decompressing. Files are compressed in parallel.
+*
+*  Usage: PackBuilder <input folder> <output.pak>
+*    e.g. PackBuilder Resources Resources.pak
+*/
+
+namespace
+{
+	struct packed_file
+	{
+		std::string path;   // as found on disk
+		std::string key;    // normalised
+		uint64_t hash = 0;
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		PackCompression compression = PackCompression::STORED;
+		std::vector<char> contents;   // as stored
+		bool loaded = false;
+	};
+
+	const char* COMPRESSED_TYPES[] = { ".png", ".jpg", ".jpeg", ".ogg", ".mp3", ".zip", ".pak" };
+
+	/**
+	*   @brief   Lists every file under a folder.
+	*   @return  void
+	*/
+	void listFiles(const std::string& folder, std::vector<std::string>& paths)
+	{
+#ifdef _WIN32
+		WIN32_FIND_DATAA found;
+		HANDLE search = FindFirstFileA((folder + "\\*").c_str(), &found);
+		if (search == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		do
+		{
+			std::string name = found.cFileName;
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+
+			if (found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			{
+				listFiles(folder + "\\" + name, paths);
+			}
+			else
+			{
+				paths.push_back(folder + "\\" + name);
+			}
+		} while (FindNextFileA(search, &found));
+		FindClose(search);
+#else
+		DIR* directory = opendir(folder.c_str());
+		if (!directory)
+		{
+			return;
+		}
+
+		while (dirent* entry = readdir(directory))
+		{
+			std::string name = entry->d_name;
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+
+			std::string path = folder + "/" + name;
+			struct stat info;
+			if (stat(path.c_str(), &info) != 0)
+			{
+				continue;
+			}
+
+			if (S_ISDIR(info.st_mode))
+			{
+				listFiles(path, paths);
+			}
+			else if (S_ISREG(info.st_mode))
+			{
+				paths.push_back(path);
+			}
+		}
+		closedir(directory);
+#endif
+	}
+
+	bool isCompressedType(const std::string& key)
+	{
+		for (const char* extension : COMPRESSED_TYPES)
+		{
+			size_t length = strlen(extension);
+			if (key.size() >= length && key.compare(key.size() - length, length, extension) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	*   @brief   Reads a file and decides how to store it.
+	*   @details Compressing has to save at least an eighth of the file,
+	             otherwise the time spent decompressing it on load
+				 isn't paid back in reading less.
+	*   @return  void
+	*/
+	void prepare(packed_file& file)
+	{
+		MappedFile source;
+		if (!source.open(file.path))
+		{
+			return;
+		}
+
+		file.size = source.size();
+		file.loaded = true;
+		if (!isCompressedType(file.key) && file.size > 0)
+		{
+			compressLz4(source.data(), source.size(), file.contents);
+			if (file.contents.size() <= file.size - file.size / 8)
+			{
+				file.compression = PackCompression::LZ4;
+				return;
+			}
+		}
+
+		file.compression = PackCompression::STORED;
+		file.contents.assign(source.data(), source.data() + source.size());
+	}
+
+	uint64_t align(uint64_t offset)
+	{
+		return (offset + ResourcePack::ALIGNMENT - 1) / ResourcePack::ALIGNMENT * ResourcePack::ALIGNMENT;
+	}
+
+	bool writeZeros(FILE* file, uint64_t count)
+	{
+		static const char zeros[ResourcePack::ALIGNMENT] = {};
+		return fwrite(zeros, 1, static_cast<size_t>(count), file) == count;
+	}
+
+	/**
+	*   @brief   Writes the pack.
+	*   @details The index and names are written first, then each file
+	             at its aligned offset.
+	*   @return  True if everything was written.
+	*/
+	bool writePack(const std::string& path, const std::vector<packed_file>& files,
+		const std::vector<pack_entry>& index, const std::string& names)
+	{
+		FILE* pack = fopen(path.c_str(), "wb");
+		if (!pack)
+		{
+			return false;
+		}
+
+		pack_header header;
+		memcpy(header.magic, "ABPK", 4);
+		header.version = ResourcePack::VERSION;
+		header.entry_count = static_cast<uint32_t>(index.size());
+		header.alignment = ResourcePack::ALIGNMENT;
+		header.index_offset = sizeof(pack_header);
+		header.names_offset = header.index_offset + index.size() * sizeof(pack_entry);
+
+		bool written = fwrite(&header, sizeof(header), 1, pack) == 1 &&
+			fwrite(index.data(), sizeof(pack_entry), index.size(), pack) == index.size() &&
+			fwrite(names.data(), 1, names.size(), pack) == names.size();
+
+		uint64_t position = header.names_offset + names.size();
+		for (size_t i = 0; i < files.size() && written; i++)
+		{
+			const packed_file& file = files[i];
+			written = writeZeros(pack, file.offset - position) &&
+				fwrite(file.contents.data(), 1, file.contents.size(), pack) == file.contents.size();
+			position = file.offset + file.contents.size();
+		}
+
+		return fclose(pack) == 0 && written;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		printf("Usage: PackBuilder <input folder> <output.pak>\n");
+		return 1;
+	}
+
+	const std::string folder = argv[1];
+	const std::string output_key = normalisePath(argv[2]);
+
+	std::vector<std::string> paths;
+	listFiles(folder, paths);
+
+	std::vector<packed_file> files;
+	for (const std::string& path : paths)
+	{
+		packed_file file;
+		file.path = path;
+		file.key = normalisePath(path);
+		if (file.key != output_key)
+		{
+			file.hash = ResourcePack::hashPath(file.key.data(), file.key.size());
+			files.push_back(file);
+		}
+	}
+
+	std::sort(files.begin(), files.end(), [](const packed_file& lhs, const packed_file& rhs)
+	{
+		return lhs.hash != rhs.hash ? lhs.hash < rhs.hash : lhs.key < rhs.key;
+	});
+
+	// paths differing only in case would be the same file on Windows
+	files.erase(std::unique(files.begin(), files.end(), [](const packed_file& lhs, const packed_file& rhs)
+	{
+		return lhs.key == rhs.key;
+	}), files.end());
+
+	ThreadPool thread_pool;
+	thread_pool.run(static_cast<int>(files.size()), [&files](int i)
+	{
+		prepare(files[i]);
+	});
+
+	files.erase(std::remove_if(files.begin(), files.end(), [](const packed_file& file)
+	{
+		if (!file.loaded)
+		{
+			printf("Skipping %s, it couldn't be opened\n", file.path.c_str());
+		}
+		return !file.loaded;
+	}), files.end());
+
+	std::vector<pack_entry> index(files.size());
+	std::string names;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		index[i].hash = files[i].hash;
+		index[i].size = files[i].size;
+		index[i].stored_size = files[i].contents.size();
+		index[i].compression = static_cast<uint32_t>(files[i].compression);
+		index[i].name_offset = static_cast<uint32_t>(names.size());
+		index[i].name_length = static_cast<uint32_t>(files[i].key.size());
+		names += files[i].key;
+	}
+
+	uint64_t offset = sizeof(pack_header) + index.size() * sizeof(pack_entry) + names.size();
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		offset = align(offset);
+		files[i].offset = offset;
+		index[i].offset = offset;
+		offset += files[i].contents.size();
+	}
+
+	if (!writePack(argv[2], files, index, names))
+	{
+		printf("Couldn't write %s\n", argv[2]);
+		return 1;
+	}
+
+	printf("Packed %d files into %llu bytes\n", static_cast<int>(files.size()),
+		static_cast<unsigned long long>(offset));
+	return 0;
+}